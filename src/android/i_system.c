@@ -88,6 +88,11 @@ tic_t I_GetTime(void)
   return (since_start*TICRATE)/1000000;
 }
 
+UINT64 I_GetTimeMicros(void)
+{
+  return (UINT64)current_time_in_ps();
+}
+
 void I_Sleep(void){}
 
 void I_GetEvent(void){}
@@ -45,6 +45,7 @@
 #include "lua_script.h"
 #include "lua_hook.h"
 #include "md5.h"
+#include "i_threads.h"
 
 #ifdef CLIENT_LOADINGSCREEN
 // cl loading screen
@@ -163,33 +164,106 @@ static consvar_t cv_showjoinaddress = {"showjoinaddress", "On", 0, CV_OnOff, NUL
 static CV_PossibleValue_t playbackspeed_cons_t[] = {{1, "MIN"}, {10, "MAX"}, {0, NULL}};
 consvar_t cv_playbackspeed = {"playbackspeed", "1", 0, playbackspeed_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
-static inline void *G_DcpyTiccmd(void* dest, const ticcmd_t* src, const size_t n)
+// Which fields of a ticcmd a delta carries
+#define TICDELTA_FORWARDMOVE 0x01
+#define TICDELTA_SIDEMOVE    0x02
+#define TICDELTA_ANGLETURN   0x04
+#define TICDELTA_AIMING      0x08
+#define TICDELTA_BUTTONS     0x10
+
+// What the first tic in a PT_SERVERTICS is a change from
+static const ticcmd_t nocmds[MAXPLAYERS];
+
+/** Writes a tic's ticcmds as changes from another tic's
+  * A bit per slot says whether its ticcmd changed. Each one that did
+  * is a byte of TICDELTA_ flags followed by the fields that changed.
+  *
+  * \param dest Where to write
+  * \param cmds The tic's ticcmds
+  * \param base The ticcmds to write the changes from
+  * \param numslots How many ticcmds there are
+  * \return dest, past what was written
+  *
+  */
+static UINT8 *G_DdeltaTiccmd(UINT8 *dest, const ticcmd_t *cmds, const ticcmd_t *base, const size_t numslots)
 {
-	const size_t d = n / sizeof(ticcmd_t);
-	const size_t r = n % sizeof(ticcmd_t);
-	UINT8 *ret = dest;
-
-	if (r)
-		M_Memcpy(dest, src, n);
-	else if (d)
-		G_MoveTiccmd(dest, src, d);
-	return ret+n;
+	UINT8 *slotbits = dest;
+	UINT8 flags;
+	size_t i;
+
+	memset(slotbits, 0, (numslots+7)/8);
+	dest += (numslots+7)/8;
+
+	for (i = 0; i < numslots; i++)
+	{
+		flags = 0;
+		if (cmds[i].forwardmove != base[i].forwardmove)
+			flags |= TICDELTA_FORWARDMOVE;
+		if (cmds[i].sidemove != base[i].sidemove)
+			flags |= TICDELTA_SIDEMOVE;
+		if (cmds[i].angleturn != base[i].angleturn)
+			flags |= TICDELTA_ANGLETURN;
+		if (cmds[i].aiming != base[i].aiming)
+			flags |= TICDELTA_AIMING;
+		if (cmds[i].buttons != base[i].buttons)
+			flags |= TICDELTA_BUTTONS;
+
+		if (!flags) // Idle or unchanged
+			continue;
+
+		slotbits[i/8] |= 1<<(i%8);
+		WRITEUINT8(dest, flags);
+		if (flags & TICDELTA_FORWARDMOVE)
+			WRITESINT8(dest, cmds[i].forwardmove);
+		if (flags & TICDELTA_SIDEMOVE)
+			WRITESINT8(dest, cmds[i].sidemove);
+		if (flags & TICDELTA_ANGLETURN)
+			WRITEINT16(dest, cmds[i].angleturn);
+		if (flags & TICDELTA_AIMING)
+			WRITEINT16(dest, cmds[i].aiming);
+		if (flags & TICDELTA_BUTTONS)
+			WRITEUINT16(dest, cmds[i].buttons);
+	}
+	return dest;
 }
 
-static inline void *G_ScpyTiccmd(ticcmd_t* dest, void* src, const size_t n)
+/** Reads a tic's ticcmds written by G_DdeltaTiccmd
+  *
+  * \param dest Where to put the ticcmds
+  * \param base The ticcmds the changes are from
+  * \param src Where to read
+  * \param numslots How many ticcmds there are
+  * \return src, past what was read
+  *
+  */
+static UINT8 *G_SdeltaTiccmd(ticcmd_t *dest, const ticcmd_t *base, UINT8 *src, const size_t numslots)
 {
-	const size_t d = n / sizeof(ticcmd_t);
-	const size_t r = n % sizeof(ticcmd_t);
-	UINT8 *ret = src;
-
-	if (r)
-		M_Memcpy(dest, src, n);
-	else if (d)
-		G_MoveTiccmd(dest, src, d);
-	return ret+n;
-}
+	const UINT8 *slotbits = src;
+	UINT8 flags;
+	size_t i;
 
+	src += (numslots+7)/8;
 
+	for (i = 0; i < numslots; i++)
+	{
+		dest[i] = base[i];
+		if (!(slotbits[i/8] & (1<<(i%8))))
+			continue;
+
+		flags = READUINT8(src);
+		if (flags & TICDELTA_FORWARDMOVE)
+			dest[i].forwardmove = READSINT8(src);
+		if (flags & TICDELTA_SIDEMOVE)
+			dest[i].sidemove = READSINT8(src);
+		if (flags & TICDELTA_ANGLETURN)
+			dest[i].angleturn = READINT16(src);
+		if (flags & TICDELTA_AIMING)
+			dest[i].aiming = READINT16(src);
+		if (flags & TICDELTA_BUTTONS)
+			dest[i].buttons = READUINT16(src);
+	}
+	return src;
+}
 
 // Some software don't support largest packet
 // (original sersetup, not exactely, but the probability of sending a packet
@@ -1425,74 +1499,145 @@ static boolean SV_SendServerConfig(INT32 node)
 }
 
 #ifdef JOININGAME
-#define SAVEGAMESIZE (768*1024)
+// Every node joining on the same tic is sent the same savegame
+static sharedram_t *savesnapshot = NULL;
+static tic_t savesnapshottic;
+static size_t savesnapshotlength; // before compression
 
-static void SV_SendSaveGame(INT32 node)
+typedef struct
 {
-	size_t length, compressedlen;
-	UINT8 *savebuffer;
-	UINT8 *compressedsave;
-	UINT8 *buffertosend;
+	sharedram_t *block;
+	savepage_t *pages;
+	size_t length;
+} savecompress_t;
 
-	// first save it in a malloced buffer
-	savebuffer = (UINT8 *)malloc(SAVEGAMESIZE);
-	if (!savebuffer)
+/** Compresses a serialized savegame and makes it ready to send
+  *
+  * Each page is compressed on its own and freed as soon as it's done,
+  * so the whole thing is never held twice. What's sent is the total
+  * length, then for each page its length, its compressed length
+  * (0 if it didn't get any smaller) and its data.
+  *
+  * \param userdata The savecompress_t to finish, freed here
+  *
+  */
+static void SV_CompressSaveGame(void *userdata)
+{
+	savecompress_t *job = userdata;
+	savepage_t *page = job->pages, *next;
+	UINT8 *compressedsave, *p;
+	size_t size, used;
+
+	size = job->length/2 + sizeof(UINT32);
+	compressedsave = malloc(size);
+	if (!compressedsave)
+		I_Error("No more free memory for savegame\n");
+	p = compressedsave;
+	WRITEUINT32(p, job->length);
+	used = p - compressedsave;
+
+	for (; page; page = next)
 	{
-		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
-		return;
-	}
+		size_t compressedlen;
 
-	// Leave room for the uncompressed length.
-	save_p = savebuffer + sizeof(UINT32);
+		// Room for this page even if it doesn't compress
+		if (used + 2*sizeof(UINT32) + page->length > size)
+		{
+			size = max(size*2, used + 2*sizeof(UINT32) + page->length);
+			compressedsave = realloc(compressedsave, size);
+			if (!compressedsave)
+				I_Error("No more free memory for savegame\n");
+		}
 
-	P_SaveNetGame();
+		p = compressedsave + used;
+		WRITEUINT32(p, page->length);
+		// One byte fewer than the page, so it's only used if it's smaller
+		compressedlen = page->length > 1 ? lzf_compress(page->data, page->length,
+			p + sizeof(UINT32), page->length - 1) : 0;
+		WRITEUINT32(p, compressedlen);
+		if (compressedlen)
+			p += compressedlen;
+		else
+			WRITEMEM(p, page->data, page->length);
+		used = p - compressedsave;
 
-	length = save_p - savebuffer;
-	if (length > SAVEGAMESIZE)
-	{
-		free(savebuffer);
-		save_p = NULL;
-		I_Error("Savegame buffer overrun");
+		next = page->next;
+		free(page);
 	}
 
-	// Allocate space for compressed save: one byte fewer than for the
-	// uncompressed data to ensure that the compression is worthwhile.
-	compressedsave = malloc(length - 1);
-	if (!compressedsave)
+	SV_SharedRamReady(job->block, compressedsave, used);
+	SV_ReleaseSharedRam(job->block);
+	free(job);
+}
+
+/** Serializes the game for this tic's joiners and starts compressing it
+  *
+  * \return The snapshot, or NULL if out of memory
+  *
+  */
+static sharedram_t *SV_SnapshotSaveGame(void)
+{
+	savecompress_t *job;
+	size_t length;
+
+	job = malloc(sizeof (*job));
+	if (!job)
 	{
 		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
-		return;
+		return NULL;
 	}
 
-	// Attempt to compress it.
-	if((compressedlen = lzf_compress(savebuffer + sizeof(UINT32), length - sizeof(UINT32), compressedsave + sizeof(UINT32), length - sizeof(UINT32) - 1)))
-	{
-		// Compressing succeeded; send compressed data
+	// first save it in pages, as big as the game needs
+	P_BeginSave();
+	P_SaveNetGame();
 
-		free(savebuffer);
+	job->block = SV_NewSharedRam(); // held by the job until compressed
+	job->pages = P_EndSave(&length);
+	job->length = length;
 
-		// State that we're compressed.
-		buffertosend = compressedsave;
-		WRITEUINT32(compressedsave, length - sizeof(UINT32));
-		length = compressedlen + sizeof(UINT32);
-	}
-	else
-	{
-		// Compression failed to make it smaller; send original
+	SV_HoldSharedRam(job->block); // and by the snapshot cache
+	savesnapshot = job->block;
+	savesnapshottic = gametic;
+	savesnapshotlength = length;
+
+	// The image is finished with, so compressing it can
+	// overlap the game; the transfers wait until it's done.
+#ifdef HAVE_THREADS
+	if (!I_SpawnThread("savegame-compress", SV_CompressSaveGame, job))
+#endif
+		SV_CompressSaveGame(job);
+
+	return savesnapshot;
+}
+
+/** Lets go of the cached savegame snapshot, if there is one
+  */
+static void SV_DropSaveGameSnapshot(void)
+{
+	if (!savesnapshot)
+		return;
+	SV_ReleaseSharedRam(savesnapshot);
+	savesnapshot = NULL;
+}
 
-		free(compressedsave);
+static void SV_SendSaveGame(INT32 node)
+{
+	sharedram_t *snapshot = savesnapshot;
 
-		// State that we're not compressed
-		buffertosend = savebuffer;
-		WRITEUINT32(savebuffer, 0);
+	if (!snapshot || savesnapshottic != gametic)
+	{
+		SV_DropSaveGameSnapshot();
+		snapshot = SV_SnapshotSaveGame();
+		if (!snapshot)
+			return;
 	}
 
-	SV_SendRam(node, buffertosend, length, SF_RAM, 0);
-	save_p = NULL;
+	SV_SendRam(node, snapshot, 0, SF_SHAREDRAM, 0);
 
 	// Remember when we started sending the savegame so we can handle timeouts
+	// The compressed size may not be known yet; go by the full size
 	sendingsavegame[node] = true;
-	freezetimeout[node] = I_GetTime() + jointimeout + length / 1024; // 1 extra tic for each kilobyte
+	freezetimeout[node] = I_GetTime() + jointimeout + savesnapshotlength / 1024; // 1 extra tic for each kilobyte
 }
 
 #ifdef DUMPCONSISTENCY
@@ -1502,7 +1647,8 @@ static consvar_t cv_dumpconsistency = {"dumpconsistency", "Off", CV_NETVAR, CV_O
 static void SV_SavedGame(void)
 {
 	size_t length;
-	UINT8 *savebuffer;
+	savepage_t *pages, *page;
+	UINT8 *savebuffer, *p;
 	XBOXSTATIC char tmpsave[256];
 
 	if (!cv_dumpconsistency.value)
@@ -1510,30 +1656,27 @@ static void SV_SavedGame(void)
 
 	sprintf(tmpsave, "%s" PATHSEP TMPSAVENAME, srb2home);
 
-	// first save it in a malloced buffer
-	save_p = savebuffer = (UINT8 *)malloc(SAVEGAMESIZE);
-	if (!save_p)
-	{
-		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
-		return;
-	}
-
+	P_BeginSave();
 	P_SaveNetGame();
+	pages = P_EndSave(&length);
 
-	length = save_p - savebuffer;
-	if (length > SAVEGAMESIZE)
+	// put the pages back together
+	p = savebuffer = (UINT8 *)malloc(length);
+	if (!savebuffer)
 	{
-		free(savebuffer);
-		save_p = NULL;
-		I_Error("Savegame buffer overrun");
+		P_FreeSave(pages);
+		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
+		return;
 	}
+	for (page = pages; page; page = page->next)
+		WRITEMEM(p, page->data, page->length);
+	P_FreeSave(pages);
 
 	// then save it!
 	if (!FIL_WriteFile(tmpsave, savebuffer, length))
 		CONS_Printf(M_GetText("Didn't save %s for netgame"), tmpsave);
 
 	free(savebuffer);
-	save_p = NULL;
 }
 
 #undef  TMPSAVENAME
@@ -1543,7 +1686,7 @@ static void SV_SavedGame(void)
 
 static void CL_LoadReceivedSavegame(void)
 {
-	UINT8 *savebuffer = NULL;
+	UINT8 *savebuffer = NULL, *p, *end;
 	size_t length, decompressedlen;
 	XBOXSTATIC char tmpsave[256];
 
@@ -1558,17 +1701,33 @@ static void CL_LoadReceivedSavegame(void)
 		return;
 	}
 
-	save_p = savebuffer;
-
-	// Decompress saved game if necessary.
-	decompressedlen = READUINT32(save_p);
-	if(decompressedlen > 0)
+	// Put the pages back together, decompressing them as needed
+	p = savebuffer;
+	end = savebuffer + length;
+	decompressedlen = READUINT32(p);
+	save_p = Z_Malloc(decompressedlen, PU_STATIC, NULL);
+	length = 0;
+	while (length < decompressedlen)
 	{
-		UINT8 *decompressedbuffer = Z_Malloc(decompressedlen, PU_STATIC, NULL);
-		lzf_decompress(save_p, length - sizeof(UINT32), decompressedbuffer, decompressedlen);
-		Z_Free(savebuffer);
-		save_p = savebuffer = decompressedbuffer;
+		size_t pagelen, compressedlen;
+
+		if (end - p < 2*(ptrdiff_t)sizeof(UINT32))
+			I_Error("Savegame sent is truncated");
+		pagelen = READUINT32(p);
+		compressedlen = READUINT32(p);
+		if (pagelen > decompressedlen - length
+			|| (size_t)(end - p) < (compressedlen ? compressedlen : pagelen))
+			I_Error("Savegame sent is corrupt");
+
+		if (!compressedlen)
+			M_Memcpy(save_p + length, p, pagelen);
+		else if (lzf_decompress(p, compressedlen, save_p + length, pagelen) != pagelen)
+			I_Error("Savegame sent is corrupt");
+		p += compressedlen ? compressedlen : pagelen;
+		length += pagelen;
 	}
+	Z_Free(savebuffer);
+	savebuffer = save_p;
 
 	paused = false;
 	demoplayback = false;
@@ -3002,9 +3161,9 @@ static CV_PossibleValue_t maxsend_cons_t[] = {{0, "MIN"}, {51200, "MAX"}, {0, NU
 consvar_t cv_maxsend = {"maxsend", "4096", CV_SAVE, maxsend_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 consvar_t cv_noticedownload = {"noticedownload", "Off", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
-// Speed of file downloading (in packets per tic)
+// Speed of file downloading (in packets per tic per node, 0 for as fast as the window allows)
 static CV_PossibleValue_t downloadspeed_cons_t[] = {{0, "MIN"}, {32, "MAX"}, {0, NULL}};
-consvar_t cv_downloadspeed = {"downloadspeed", "16", CV_SAVE, downloadspeed_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+consvar_t cv_downloadspeed = {"downloadspeed", "0", CV_SAVE, downloadspeed_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
 static void Got_AddPlayer(UINT8 **p, INT32 playernum);
 
@@ -3089,6 +3248,10 @@ void SV_ResetServer(void)
 		SV_InitResynchVars(i);
 	}
 
+#ifdef JOININGAME
+	SV_DropSaveGameSnapshot();
+#endif
+
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
 #ifdef HAVE_BLUA
@@ -3780,14 +3943,19 @@ static void HandlePacketFromAwayNode(SINT8 node)
 		}
 
 		// Handled in d_netfil.c
-		case PT_FILEFRAGMENT:
+		case PT_FILECHUNK:
 			if (server)
 			{ // But wait I thought I'm the server?
 				Net_CloseConnection(node);
 				break;
 			}
 			SERVERONLY
-			Got_Filetxpak();
+			Got_Filechunkpak();
+			break;
+
+		case PT_FILEACK:
+			if (server)
+				Got_Fileackpak(node);
 			break;
 
 		case PT_REQUESTFILE:
@@ -3834,6 +4002,7 @@ static void HandlePacketFromAwayNode(SINT8 node)
   */
 static void HandlePacketFromPlayer(SINT8 node)
 {FILESTAMP
+	static ticcmd_t deltatics[BACKUPTICS][MAXPLAYERS]; // PT_SERVERTICS's cmds
 	XBOXSTATIC INT32 netconsole;
 	XBOXSTATIC tic_t realend, realstart;
 	XBOXSTATIC UINT8 *pak, *txtpak, numtxtpak;
@@ -4137,9 +4306,18 @@ FILESTAMP
 			realstart = ExpandTics(netbuffer->u.serverpak.starttic);
 			realend = realstart + netbuffer->u.serverpak.numtics;
 
-			if (!txtpak)
-				txtpak = (UINT8 *)&netbuffer->u.serverpak.cmds[netbuffer->u.serverpak.numslots
-					* netbuffer->u.serverpak.numtics];
+			// The cmds vary in size, so read them all to find the textcmds
+			{
+				tic_t i;
+				if (netbuffer->u.serverpak.numtics > BACKUPTICS
+					|| netbuffer->u.serverpak.numslots > MAXPLAYERS)
+					break;
+				pak = (UINT8 *)&netbuffer->u.serverpak.cmds;
+				for (i = 0; i < netbuffer->u.serverpak.numtics; i++)
+					pak = G_SdeltaTiccmd(deltatics[i], i ? deltatics[i-1] : nocmds, pak,
+						netbuffer->u.serverpak.numslots);
+				txtpak = pak;
+			}
 
 			if (realend > gametic + BACKUPTICS)
 				realend = gametic + BACKUPTICS;
@@ -4148,7 +4326,6 @@ FILESTAMP
 			if (realstart <= neededtic && realend > neededtic)
 			{
 				tic_t i, j;
-				pak = (UINT8 *)&netbuffer->u.serverpak.cmds;
 
 				for (i = realstart; i < realend; i++)
 				{
@@ -4156,8 +4333,8 @@ FILESTAMP
 					D_Clearticcmd(i);
 
 					// copy the tics
-					pak = G_ScpyTiccmd(netcmds[i%BACKUPTICS], pak,
-						netbuffer->u.serverpak.numslots*sizeof (ticcmd_t));
+					G_CopyTiccmd(netcmds[i%BACKUPTICS], deltatics[i - realstart],
+						netbuffer->u.serverpak.numslots);
 
 					// copy the textcmds
 					numtxtpak = *txtpak++;
@@ -4234,11 +4411,11 @@ FILESTAMP
 #endif
 		case PT_SERVERCFG:
 			break;
-		case PT_FILEFRAGMENT:
-			// Only accept PT_FILEFRAGMENT from the server.
+		case PT_FILECHUNK:
+			// Only accept PT_FILECHUNK from the server.
 			if (node != servernode)
 			{
-				CONS_Alert(CONS_WARNING, M_GetText("%s received from non-host %d\n"), "PT_FILEFRAGMENT", node);
+				CONS_Alert(CONS_WARNING, M_GetText("%s received from non-host %d\n"), "PT_FILECHUNK", node);
 
 				if (server)
 				{
@@ -4251,7 +4428,11 @@ FILESTAMP
 				break;
 			}
 			if (client)
-				Got_Filetxpak();
+				Got_Filechunkpak();
+			break;
+		case PT_FILEACK:
+			if (server)
+				Got_Fileackpak(node);
 			break;
 		default:
 			DEBFILE(va("UNKNOWN PACKET TYPE RECEIVED %d from host %d\n",
@@ -4351,6 +4532,9 @@ static INT16 Consistancy(void)
 	if (!G_PlatformGametype())
 		ret += P_GetRandSeed();
 
+	// every thinking mobj, kept up to date as they move and change state
+	ret += mobjconsistancy ^ (mobjconsistancy >> 16);
+
 #ifdef MOBJCONSISTANCY
 	if (!thinkercap.next)
 	{
@@ -4501,6 +4685,9 @@ static void SV_SendTics(void)
 	size_t packsize;
 	UINT8 *bufpos;
 	UINT8 *ntextcmd;
+	UINT8 *deltapos, *ticstart;
+	// room for one more tic than fits, before the packet is cut
+	static UINT8 deltabuf[MAXPACKETLENGTH + (MAXPLAYERS+7)/8 + MAXPLAYERS*(1+sizeof (ticcmd_t))];
 
 	// send to all client but not to me
 	// for each node create a packet with x tics and send it
@@ -4530,10 +4717,15 @@ static void SV_SendTics(void)
 				realfirsttic = firstticstosend;
 
 			// compute the length of the packet and cut it if too large
+			// the deltas are written out as they're measured
 			packsize = BASESERVERTICSSIZE;
+			deltapos = deltabuf;
 			for (i = realfirsttic; i < lasttictosend; i++)
 			{
-				packsize += sizeof (ticcmd_t) * doomcom->numslots;
+				ticstart = deltapos;
+				deltapos = G_DdeltaTiccmd(deltapos, netcmds[i%BACKUPTICS],
+					(i == realfirsttic) ? nocmds : netcmds[(i-1)%BACKUPTICS], doomcom->numslots);
+				packsize += deltapos - ticstart;
 				packsize += TotalTextCmdPerTic(i);
 
 				if (packsize > software_MAXPACKETLENGTH)
@@ -4558,6 +4750,8 @@ static void SV_SendTics(void)
 							DEBFILE("sending it anyway\n");
 						}
 					}
+					if (lasttictosend == i)
+						deltapos = ticstart;
 					break;
 				}
 			}
@@ -4569,10 +4763,8 @@ static void SV_SendTics(void)
 			netbuffer->u.serverpak.numslots = (UINT8)SHORT(doomcom->numslots);
 			bufpos = (UINT8 *)&netbuffer->u.serverpak.cmds;
 
-			for (i = realfirsttic; i < lasttictosend; i++)
-			{
-				bufpos = G_DcpyTiccmd(bufpos, netcmds[i%BACKUPTICS], doomcom->numslots * sizeof (ticcmd_t));
-			}
+			M_Memcpy(bufpos, deltabuf, deltapos - deltabuf);
+			bufpos += deltapos - deltabuf;
 
 			// add textcmds
 			for (i = realfirsttic; i < lasttictosend; i++)
@@ -4738,6 +4930,11 @@ void TryRunTics(tic_t realtics)
 		if (advancedemo)
 			D_StartTitle();
 		else
+		{
+			// A tic can take a while (level load, Lua), so let
+			// the net thread keep the connections alive meanwhile
+			Net_Unlock();
+
 			// run the count * tics
 			while (neededtic > gametic)
 			{
@@ -4748,6 +4945,9 @@ void TryRunTics(tic_t realtics)
 				gametic++;
 				consistancy[gametic%BACKUPTICS] = Consistancy();
 			}
+
+			Net_Lock();
+		}
 	}
 }
 
@@ -4824,6 +5024,9 @@ void NetUpdate(void)
 
 	if (realtics <= 0) // nothing new to update
 		return;
+
+	Net_Lock();
+
 	if (realtics > 5)
 	{
 		if (server)
@@ -4925,6 +5128,12 @@ FILESTAMP
 		CON_Ticker();
 	}
 	SV_FileSendTicker();
+
+	// everything for this tic has been sent, push it out
+	if (I_NetFlush)
+		I_NetFlush();
+
+	Net_Unlock();
 }
 
 /** Returns the number of players playing.
@@ -17,6 +17,7 @@
 #include "d_netcmd.h"
 #include "tables.h"
 #include "d_player.h"
+#include "i_net.h"
 
 // Network play related stuff.
 // There is a data struct that stores network
@@ -42,7 +43,7 @@ typedef enum
 	PT_CLIENT2MIS,    // Same as above with but saying resend from
 	PT_NODEKEEPALIVE, // Same but without ticcmd and consistancy
 	PT_NODEKEEPALIVEMIS,
-	PT_SERVERTICS,    // All cmds for the tic.
+	PT_SERVERTICS,    // All cmds for the tics, as changes from the tic before.
 	PT_SERVERREFUSE,  // Server refuses joiner (reason inside).
 	PT_SERVERSHUTDOWN,
 	PT_CLIENTQUIT,    // Client closes the connection.
@@ -58,13 +59,14 @@ typedef enum
 
 	// Add non-PT_CANFAIL packet types here to avoid breaking MS compatibility.
 
+	PT_FILECHUNK,     // A part of a file, on the windowed channel (see SV_FileSendTicker).
+	PT_FILEACK,       // Which PT_FILECHUNKs the client has.
+
 	PT_CANFAIL,       // This is kind of a priority. Anything bigger than CANFAIL
 	                  // allows HSendPacket(*, true, *, *) to return false.
 	                  // In addition, this packet can't occupy all the available slots.
 
-	PT_FILEFRAGMENT = PT_CANFAIL, // A part of a file.
-
-	PT_TEXTCMD,       // Extra text commands from the client.
+	PT_TEXTCMD = PT_CANFAIL, // Extra text commands from the client.
 	PT_TEXTCMD2,      // Splitscreen text commands.
 	PT_CLIENTJOIN,    // Client wants to join; used in start game.
 	PT_NODETIMEOUT,   // Packet sent to self if the connection times out.
@@ -121,7 +123,7 @@ typedef struct
 	UINT8 starttic;
 	UINT8 numtics;
 	UINT8 numslots; // "Slots filled": Highest player number in use plus one.
-	ticcmd_t cmds[45]; // Normally [BACKUPTIC][MAXPLAYERS] but too large
+	ticcmd_t cmds[45]; // Normally [BACKUPTIC][MAXPLAYERS] but too large; holds G_DdeltaTiccmd deltas
 } ATTRPACK servertics_pak;
 
 // Sent to client when all consistency data
@@ -294,10 +296,22 @@ typedef struct
 
 typedef struct {
 	UINT8 fileid;
-	UINT32 position;
+	UINT8 flags; // FILECHUNK_ flags
+	UINT16 chunksize; // Size of every chunk but the last
+	UINT32 chunk; // Starts at chunk*chunksize in the file
 	UINT16 size;
 	UINT8 data[0]; // Size is variable using hardware_MAXPACKETLENGTH
-} ATTRPACK filetx_pak;
+} ATTRPACK filechunk_pak;
+
+#define FILECHUNK_LAST 0x01 // Last chunk of the file, so its size is known
+
+#define FILEACKBITS 128 // Chunks a PT_FILEACK can tell about past the first missing one
+
+typedef struct {
+	UINT8 fileid;
+	UINT32 firstmissing; // Every chunk before this one has arrived, UINT32_MAX for all of them
+	UINT8 got[FILEACKBITS/8]; // Bit n is set if chunk firstmissing+1+n has arrived
+} ATTRPACK fileack_pak;
 
 #ifdef _MSC_VER
 #pragma warning(default : 4200)
@@ -399,7 +413,8 @@ typedef struct
 		resynch_pak resynchpak;             //
 		UINT8 resynchgot;                   //
 		UINT8 textcmd[MAXTEXTCMD+1];        //       66049 bytes (wut??? 64k??? More like 257 bytes...)
-		filetx_pak filetxpak;               //         139 bytes
+		filechunk_pak filechunkpak;
+		fileack_pak fileackpak;             //          21 bytes
 		clientconfig_pak clientcfg;         //         136 bytes
 		UINT8 md5sum[16];
 		serverinfo_pak serverinfo;          //        1024 bytes
@@ -430,12 +445,12 @@ extern UINT32 serverlistcount;
 extern INT32 mapchangepending;
 
 // Points inside doomcom
-extern doomdata_t *netbuffer;
+extern NETLOCAL doomdata_t *netbuffer;
 
 extern consvar_t cv_playbackspeed;
 
 #define BASEPACKETSIZE      offsetof(doomdata_t, u)
-#define FILETXHEADER        offsetof(filetx_pak, data)
+#define FILECHUNKHEADER     offsetof(filechunk_pak, data)
 #define BASESERVERTICSSIZE  offsetof(doomdata_t, u.serverpak.cmds[0])
 
 #define KICK_MSG_GO_AWAY     1
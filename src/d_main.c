@@ -977,6 +977,10 @@ void D_SRB2Main(void)
 	dedicated = M_CheckParm("-dedicated") != 0;
 #endif
 
+	// headless simulation benchmark, sets up like a dedicated server without the network
+	if (M_CheckParm("-simbench"))
+		dedicated = simbenchmark = true;
+
 	strcpy(title, "Sonic Robo Blast 2");
 	strcpy(srb2, "Sonic Robo Blast 2");
 	D_MakeTitleString(srb2);
@@ -1083,7 +1087,7 @@ void D_SRB2Main(void)
 
 	// get map from parms
 
-	if (M_CheckParm("-server") || dedicated)
+	if (M_CheckParm("-server") || (dedicated && !simbenchmark))
 		netgame = server = true;
 
 	if (M_CheckParm("-warp") && M_IsNextParm())
@@ -1270,6 +1274,24 @@ void D_SRB2Main(void)
 #endif
 	}
 
+	// replay a demo through the game logic only, then quit
+	if (simbenchmark)
+	{
+		char tmp[MAX_WADPATH], reportname[MAX_WADPATH];
+
+		if (!M_CheckParm("-simbench") || !M_IsNextParm())
+			I_Error("usage: -simbench <demo> [-simbenchout <report>]\n");
+		strlcpy(tmp, M_GetNextParm(), sizeof tmp);
+		FIL_DefaultExtension(tmp, ".lmp");
+
+		if (M_CheckParm("-simbenchout") && M_IsNextParm())
+			strlcpy(reportname, M_GetNextParm(), sizeof reportname);
+		else
+			snprintf(reportname, sizeof reportname, "%s"PATHSEP"simbench.json", srb2home);
+
+		G_SimBenchmark(tmp, reportname);
+	}
+
 	// init all NETWORK
 	CONS_Printf("D_CheckNetGame(): Checking network game status.\n");
 	if (D_CheckNetGame())
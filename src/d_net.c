@@ -28,6 +28,9 @@
 #include "z_zone.h"
 #include "i_tcp.h"
 #include "d_main.h" // srb2home
+#ifdef NETTHREAD
+#include "i_threads.h"
+#endif
 
 //
 // NETWORKING
@@ -46,9 +49,9 @@
 tic_t connectiontimeout = (10*TICRATE);
 
 /// \brief network packet
-doomcom_t *doomcom = NULL;
+NETLOCAL doomcom_t *doomcom = NULL;
 /// \brief network packet data, points inside doomcom
-doomdata_t *netbuffer = NULL;
+NETLOCAL doomdata_t *netbuffer = NULL;
 
 #ifdef DEBUGFILE
 FILE *debugfile = NULL; // put some net info in a file during the game
@@ -68,6 +71,7 @@ INT16 hardware_MAXPACKETLENGTH;
 boolean (*I_NetGet)(void) = NULL;
 void (*I_NetSend)(void) = NULL;
 boolean (*I_NetCanSend)(void) = NULL;
+void (*I_NetFlush)(void) = NULL;
 boolean (*I_NetCanGet)(void) = NULL;
 void (*I_NetCloseSocket)(void) = NULL;
 void (*I_NetFreeNodenum)(INT32 nodenum) = NULL;
@@ -157,11 +161,38 @@ typedef enum
 {
 	NF_CLOSE = 1, // Flag is set when connection is closing
 	NF_TIMEOUT = 2, // Flag is set when the node got a timeout
+	NF_CLOSEPENDING = 4, // Flag is set when the net thread wants the connection closed
 } node_flags_t;
 
 #ifndef NONET
 // Table of packets that were not acknowleged can be resent (the sender window)
 static ackpak_t ackpak[MAXACKPACKETS];
+
+// Packets read from the driver that the game hasn't taken yet
+typedef struct
+{
+	INT16 node; // -1 if the connection was closed since
+	INT16 length;
+	doomdata_t data;
+} recvpacket_t;
+
+#define RECVQUEUESIZE 128
+static recvpacket_t recvqueue[RECVQUEUESIZE];
+static INT32 recvqueue_head, recvqueue_tail;
+#endif
+
+#ifdef NETTHREAD
+// The game thread holds net_mutex all the time, except around work that
+// can take long enough for other nodes to time us out (see Net_Unlock).
+// The net thread takes it then to read packets and keep sending acks.
+// SDL mutexes are recursive, so the functions below lock it as well,
+// in case they get called from inside such a window.
+#define NETTHREADSLEEP 2 // ms
+
+static I_mutex net_mutex;
+static boolean net_threaded = false;
+static NETLOCAL boolean onnetthread = false;
+static doomcom_t netthreaddoomcom;
 #endif
 
 typedef struct
@@ -317,6 +348,20 @@ static UINT8 GetAcktosend(INT32 node)
 	return nodes[node].firstacktosend;
 }
 
+// Closing a connection aborts its file transfers, which frees memory through
+// the zone allocator, so the net thread leaves that to the game thread.
+static void RequestClose(INT32 node)
+{
+#ifdef NETTHREAD
+	if (onnetthread)
+	{
+		nodes[node].flags |= NF_CLOSEPENDING;
+		return;
+	}
+#endif
+	Net_CloseConnection(node);
+}
+
 static void RemoveAck(INT32 i)
 {
 	INT32 node = ackpak[i].destinationnode;
@@ -335,14 +380,13 @@ static void RemoveAck(INT32 i)
 #endif
 	ackpak[i].acknum = 0;
 	if (nodes[node].flags & NF_CLOSE)
-		Net_CloseConnection(node);
+		RequestClose(node);
 }
 
-// We have got a packet, proceed the ack request and ack return
-static boolean Processackpak(void)
+// We have got a packet, proceed the ack return
+static void ProcessAckreturn(void)
 {
 	INT32 i;
-	boolean goodpacket = true;
 	node_t *node = &nodes[doomcom->remotenode];
 
 	// Received an ack return, so remove the ack in the list
@@ -357,6 +401,16 @@ static boolean Processackpak(void)
 				RemoveAck(i);
 			}
 	}
+}
+
+// We have got a packet, proceed the ack request and ack return
+static boolean Processackpak(void)
+{
+	INT32 i;
+	boolean goodpacket = true;
+	node_t *node = &nodes[doomcom->remotenode];
+
+	ProcessAckreturn();
 
 	// Received a packet with ack, queue it to send the ack back
 	if (netbuffer->ack)
@@ -493,6 +547,8 @@ void Net_ConnectionTimeout(INT32 node)
 	// Don't timeout several times
 	if (nodes[node].flags & NF_TIMEOUT)
 		return;
+
+	Net_Lock();
 	nodes[node].flags |= NF_TIMEOUT;
 
 	// Send a very special packet to self (hack the reboundstore queue)
@@ -507,6 +563,7 @@ void Net_ConnectionTimeout(INT32 node)
 	// Do not redo it quickly (if we do not close connection it is
 	// for a good reason!)
 	nodes[node].lasttimepacketreceived = I_GetTime();
+	Net_Unlock();
 }
 
 // Resend the data if needed
@@ -515,6 +572,17 @@ void Net_AckTicker(void)
 #ifndef NONET
 	INT32 i;
 
+	Net_Lock();
+
+#ifdef NETTHREAD
+	for (i = 1; i < MAXNETNODES; i++)
+		if (nodes[i].flags & NF_CLOSEPENDING)
+		{
+			nodes[i].flags &= ~NF_CLOSEPENDING;
+			Net_CloseConnection(i);
+		}
+#endif
+
 	for (i = 0; i < MAXACKPACKETS; i++)
 	{
 		const INT32 nodei = ackpak[i].destinationnode;
@@ -568,6 +636,8 @@ void Net_AckTicker(void)
 			}
 		}
 	}
+
+	Net_Unlock();
 #endif
 }
 
@@ -676,6 +746,7 @@ static void InitAck(void)
 #ifndef NONET
 	for (i = 0; i < MAXACKPACKETS; i++)
 		ackpak[i].acknum = 0;
+	recvqueue_head = recvqueue_tail = 0;
 #endif
 
 	for (i = 0; i < MAXNETNODES; i++)
@@ -693,12 +764,14 @@ void Net_AbortPacketType(UINT8 packettype)
 	(void)packettype;
 #else
 	INT32 i;
+	Net_Lock();
 	for (i = 0; i < MAXACKPACKETS; i++)
 		if (ackpak[i].acknum && (ackpak[i].pak.data.packettype == packettype
 			|| packettype == UINT8_MAX))
 		{
 			ackpak[i].acknum = 0;
 		}
+	Net_Unlock();
 #endif
 }
 
@@ -706,12 +779,9 @@ void Net_AbortPacketType(UINT8 packettype)
 // end of acknowledge function
 // -----------------------------------------------------------------
 
-// remove a node, clear all ack from this node and reset askret
-void Net_CloseConnection(INT32 node)
+#ifndef NONET
+static void CloseConnection(INT32 node)
 {
-#ifdef NONET
-	(void)node;
-#else
 	INT32 i;
 	boolean forceclose = (node & FORCECLOSE) != 0;
 
@@ -754,6 +824,23 @@ void Net_CloseConnection(INT32 node)
 	InitNode(&nodes[node]);
 	SV_AbortSendFiles(node);
 	I_NetFreeNodenum(node);
+
+	// Forget what it sent that the game hasn't read yet
+	for (i = recvqueue_tail; i != recvqueue_head; i = (i+1) % RECVQUEUESIZE)
+		if (recvqueue[i].node == node)
+			recvqueue[i].node = -1;
+}
+#endif
+
+// remove a node, clear all ack from this node and reset askret
+void Net_CloseConnection(INT32 node)
+{
+#ifdef NONET
+	(void)node;
+#else
+	Net_Lock();
+	CloseConnection(node);
+	Net_Unlock();
 #endif
 }
 
@@ -837,7 +924,9 @@ static const char *packettypename[NUMPACKETTYPE] =
 	"RESYNCHEND",
 	"RESYNCHGET",
 
-	"FILEFRAGMENT",
+	"FILECHUNK",
+	"FILEACK",
+
 	"TEXTCMD",
 	"TEXTCMD2",
 	"CLIENTJOIN",
@@ -865,24 +954,10 @@ static void DebugPrintpacket(const char *header)
 				netbuffer->u.clientcfg.mode);
 			break;
 		case PT_SERVERTICS:
-		{
-			servertics_pak *serverpak = &netbuffer->u.serverpak;
-			UINT8 *cmd = (UINT8 *)(&serverpak->cmds[serverpak->numslots * serverpak->numtics]);
-			size_t ntxtcmd = &((UINT8 *)netbuffer)[doomcom->datalength] - cmd;
-
-			fprintf(debugfile, "    firsttic %u ply %d tics %d ntxtcmd %s\n    ",
-				(UINT32)ExpandTics(serverpak->starttic), serverpak->numslots, serverpak->numtics, sizeu1(ntxtcmd));
-			/// \todo Display more readable information about net commands
-			fprintfstringnewline((char *)cmd, ntxtcmd);
-			/*fprintfstring((char *)cmd, 3);
-			if (ntxtcmd > 4)
-			{
-				fprintf(debugfile, "[%s]", netxcmdnames[*((cmd) + 3) - 1]);
-				fprintfstring(((char *)cmd) + 4, ntxtcmd - 4);
-			}
-			fprintf(debugfile, "\n");*/
+			// The cmds vary in size, so the textcmds can't be found here
+			fprintf(debugfile, "    firsttic %u ply %d tics %d\n",
+				(UINT32)ExpandTics(netbuffer->u.serverpak.starttic), netbuffer->u.serverpak.numslots, netbuffer->u.serverpak.numtics);
 			break;
-		}
 		case PT_CLIENTCMD:
 		case PT_CLIENT2CMD:
 		case PT_CLIENTMIS:
@@ -920,10 +995,14 @@ static void DebugPrintpacket(const char *header)
 		case PT_SERVERREFUSE:
 			fprintf(debugfile, "    reason %s\n", netbuffer->u.serverrefuse.reason);
 			break;
-		case PT_FILEFRAGMENT:
-			fprintf(debugfile, "    fileid %d datasize %d position %u\n",
-				netbuffer->u.filetxpak.fileid, (UINT16)SHORT(netbuffer->u.filetxpak.size),
-				(UINT32)LONG(netbuffer->u.filetxpak.position));
+		case PT_FILECHUNK:
+			fprintf(debugfile, "    fileid %d chunk %u size %d\n",
+				netbuffer->u.filechunkpak.fileid, (UINT32)LONG(netbuffer->u.filechunkpak.chunk),
+				(UINT16)SHORT(netbuffer->u.filechunkpak.size));
+			break;
+		case PT_FILEACK:
+			fprintf(debugfile, "    fileid %d firstmissing %u\n",
+				netbuffer->u.fileackpak.fileid, (UINT32)LONG(netbuffer->u.fileackpak.firstmissing));
 			break;
 		case PT_REQUESTFILE:
 		default: // write as a raw packet
@@ -1016,10 +1095,7 @@ static boolean ShouldDropPacket(void)
 #endif
 #endif
 
-//
-// HSendPacket
-//
-boolean HSendPacket(INT32 node, boolean reliable, UINT8 acknum, size_t packetlength)
+static boolean SendPacket(INT32 node, boolean reliable, UINT8 acknum, size_t packetlength)
 {
 	doomcom->datalength = (INT16)(packetlength + BASEPACKETSIZE);
 	if (node == 0) // Packet is to go back to us
@@ -1120,14 +1196,73 @@ boolean HSendPacket(INT32 node, boolean reliable, UINT8 acknum, size_t packetlen
 }
 
 //
-// HGetPacket
-// Returns false if no packet is waiting
-// Check Datalength and checksum
+// HSendPacket
 //
-boolean HGetPacket(void)
+boolean HSendPacket(INT32 node, boolean reliable, UINT8 acknum, size_t packetlength)
+{
+	boolean sent;
+	Net_Lock();
+	sent = SendPacket(node, reliable, acknum, packetlength);
+	Net_Unlock();
+	return sent;
+}
+
+#ifndef NONET
+// Reads what the driver has into recvqueue. Packets with just an ack
+// return are dealt with right away, they don't need to wait for the game.
+static void ReadPackets(void)
 {
-	//boolean nodejustjoined;
+	recvpacket_t *q;
+
+	while ((recvqueue_head+1) % RECVQUEUESIZE != recvqueue_tail)
+	{
+		I_NetGet();
+
+		if (doomcom->remotenode == -1) // No packet received
+			return;
+
+		getbytes += packetheaderlength + doomcom->datalength; // For stat
 
+		if (doomcom->remotenode >= MAXNETNODES)
+		{
+			DEBFILE(va("Received packet from node %d!\n", doomcom->remotenode));
+			continue;
+		}
+
+		nodes[doomcom->remotenode].lasttimepacketreceived = I_GetTime();
+
+		if (netbuffer->checksum != NetbufferChecksum())
+		{
+			DEBFILE("Bad packet checksum\n");
+			RequestClose(doomcom->remotenode);
+			continue;
+		}
+
+		// Free whatever it acknowledged now, the ack request waits for the game
+		ProcessAckreturn();
+
+		// A packet with just ackreturn
+		if (netbuffer->packettype == PT_NOTHING)
+		{
+#ifdef DEBUGFILE
+			if (debugfile)
+				DebugPrintpacket("GET");
+#endif
+			GotAcks();
+			continue;
+		}
+
+		q = &recvqueue[recvqueue_head];
+		q->node = doomcom->remotenode;
+		q->length = doomcom->datalength;
+		M_Memcpy(&q->data, netbuffer, doomcom->datalength);
+		recvqueue_head = (recvqueue_head+1) % RECVQUEUESIZE;
+	}
+}
+#endif
+
+static boolean GetPacket(void)
+{
 	// Get a packet from self
 	if (rebound_tail != rebound_head)
 	{
@@ -1153,60 +1288,32 @@ boolean HGetPacket(void)
 
 	while(true)
 	{
-		//nodejustjoined = I_NetGet();
-		I_NetGet();
-
-		if (doomcom->remotenode == -1) // No packet received
-			return false;
+		recvpacket_t *q;
 
-		getbytes += packetheaderlength + doomcom->datalength; // For stat
-
-		if (doomcom->remotenode >= MAXNETNODES)
+		if (recvqueue_tail == recvqueue_head)
 		{
-			DEBFILE(va("Received packet from node %d!\n", doomcom->remotenode));
-			continue;
+			ReadPackets();
+			if (recvqueue_tail == recvqueue_head) // No packet received
+				return false;
 		}
 
-		nodes[doomcom->remotenode].lasttimepacketreceived = I_GetTime();
-
-		if (netbuffer->checksum != NetbufferChecksum())
-		{
-			DEBFILE("Bad packet checksum\n");
-			//Net_CloseConnection(nodejustjoined ? (doomcom->remotenode | FORCECLOSE) : doomcom->remotenode);
-			Net_CloseConnection(doomcom->remotenode);
+		q = &recvqueue[recvqueue_tail];
+		recvqueue_tail = (recvqueue_tail+1) % RECVQUEUESIZE;
+		if (q->node == -1) // Connection closed since
 			continue;
-		}
+
+		M_Memcpy(netbuffer, &q->data, q->length);
+		doomcom->datalength = q->length;
+		doomcom->remotenode = q->node;
 
 #ifdef DEBUGFILE
 		if (debugfile)
 			DebugPrintpacket("GET");
 #endif
 
-		/*// If a new node sends an unexpected packet, just ignore it
-		if (nodejustjoined && server
-			&& !(netbuffer->packettype == PT_ASKINFO
-				|| netbuffer->packettype == PT_SERVERINFO
-				|| netbuffer->packettype == PT_PLAYERINFO
-				|| netbuffer->packettype == PT_REQUESTFILE
-				|| netbuffer->packettype == PT_ASKINFOVIAMS
-				|| netbuffer->packettype == PT_CLIENTJOIN))
-		{
-			DEBFILE(va("New node sent an unexpected %s packet\n", packettypename[netbuffer->packettype]));
-			//CONS_Alert(CONS_NOTICE, "New node sent an unexpected %s packet\n", packettypename[netbuffer->packettype]);
-			Net_CloseConnection(doomcom->remotenode | FORCECLOSE);
-			continue;
-		}*/
-
-		// Proceed the ack and ackreturn field
+		// Proceed the ack field
 		if (!Processackpak())
 			continue; // discarded (duplicated)
-
-		// A packet with just ackreturn
-		if (netbuffer->packettype == PT_NOTHING)
-		{
-			GotAcks();
-			continue;
-		}
 		break;
 	}
 #endif // ndef NONET
@@ -1214,6 +1321,79 @@ boolean HGetPacket(void)
 	return true;
 }
 
+//
+// HGetPacket
+// Returns false if no packet is waiting
+// Check Datalength and checksum
+//
+boolean HGetPacket(void)
+{
+	boolean got;
+	Net_Lock();
+	got = GetPacket();
+	Net_Unlock();
+	return got;
+}
+
+#ifdef NETTHREAD
+// Works while the game thread lets go of net_mutex: takes packets off the
+// sockets as they come in, and keeps acknowledging them, so that nobody
+// times us out during a long tic.
+static void Net_Thread(void *userdata)
+{
+	INT32 i;
+
+	doomcom = userdata;
+	netbuffer = (doomdata_t *)(void *)&doomcom->data;
+	onnetthread = true;
+
+	for (;;)
+	{
+		I_LockMutex(&net_mutex);
+		if (netgame)
+		{
+			ReadPackets();
+
+			for (i = 1; i < MAXNETNODES; i++)
+				if (nodes[i].firstacktosend
+					&& nodes[i].lasttimeacktosend_sent + ACKTOSENDTIMEOUT < I_GetTime())
+					Net_SendAcks(i);
+
+			if (I_NetFlush)
+				I_NetFlush();
+		}
+		I_UnlockMutex(net_mutex);
+
+		I_SleepThread(NETTHREADSLEEP);
+	}
+}
+#endif
+
+/** Takes the network back from the net thread
+  *
+  * \sa Net_Unlock
+  *
+  */
+void Net_Lock(void)
+{
+#ifdef NETTHREAD
+	if (net_threaded)
+		I_LockMutex(&net_mutex);
+#endif
+}
+
+/** Lets the net thread read packets and send acks until Net_Lock
+  * Anything that uses the network in between takes the lock itself.
+  *
+  */
+void Net_Unlock(void)
+{
+#ifdef NETTHREAD
+	if (net_threaded)
+		I_UnlockMutex(net_mutex);
+#endif
+}
+
 static boolean Internal_Get(void)
 {
 	doomcom->remotenode = -1;
@@ -1249,7 +1429,9 @@ SINT8 I_NetMakeNode(const char *hostname)
 			t++;
 		*t = '\0';
 
+		Net_Lock();
 		newnode = I_NetMakeNodewPort(localhostname, port);
+		Net_Unlock();
 		free(localhostname);
 	}
 	return newnode;
@@ -1282,6 +1464,7 @@ boolean D_CheckNetGame(void)
 	I_NetGet = Internal_Get;
 	I_NetSend = Internal_Send;
 	I_NetCanSend = NULL;
+	I_NetFlush = NULL;
 	I_NetCloseSocket = NULL;
 	I_NetFreeNodenum = Internal_FreeNodenum;
 	I_NetMakeNodewPort = NULL;
@@ -1385,6 +1568,18 @@ boolean D_CheckNetGame(void)
 #endif
 #endif
 
+#ifdef NETTHREAD
+	if (!net_threaded && !M_CheckParm("-nonetthread"))
+	{
+		// Hold on to the network until the first Net_Unlock
+		I_LockMutex(&net_mutex);
+		netthreaddoomcom = *doomcom;
+		net_threaded = I_SpawnThread("net", Net_Thread, &netthreaddoomcom);
+		if (!net_threaded)
+			I_UnlockMutex(net_mutex);
+	}
+#endif
+
 	D_ClientServerInit();
 
 	return ret;
@@ -1420,6 +1615,8 @@ void D_CloseConnection(void)
 {
 	INT32 i;
 
+	Net_Lock();
+
 	if (netgame)
 	{
 		// wait the ackreturn with timout of 5 Sec
@@ -1437,6 +1634,7 @@ void D_CloseConnection(void)
 		I_NetGet = Internal_Get;
 		I_NetSend = Internal_Send;
 		I_NetCanSend = NULL;
+		I_NetFlush = NULL;
 		I_NetCloseSocket = NULL;
 		I_NetFreeNodenum = Internal_FreeNodenum;
 		I_NetMakeNodewPort = NULL;
@@ -1444,5 +1642,7 @@ void D_CloseConnection(void)
 		addedtogame = false;
 	}
 
+	Net_Unlock();
+
 	D_ResetTiccmds();
 }
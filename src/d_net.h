@@ -58,6 +58,8 @@ void Net_CloseConnection(INT32 node);
 void Net_ConnectionTimeout(INT32 node);
 void Net_AbortPacketType(UINT8 packettype);
 void Net_SendAcks(INT32 node);
+void Net_Lock(void);
+void Net_Unlock(void);
 void Net_WaitAllAckReceived(UINT32 timeout);
 
 #endif
@@ -813,6 +813,10 @@ void D_RegisterClientCommands(void)
 #if defined(HAVE_BLUA) && defined(LUA_ALLOW_BYTECODE)
 	COM_AddCommand("dumplua", Command_Dumplua_f);
 #endif
+#ifdef HAVE_BLUA
+	COM_AddCommand("luagc", Command_LuaGC_f);
+	CV_RegisterVar(&cv_luagcbudget);
+#endif
 }
 
 /** Checks if a name (as received from another player) is okay.
@@ -4087,8 +4091,10 @@ static void Command_Togglemodified_f(void)
 extern UINT8 *save_p;
 static void Command_Archivetest_f(void)
 {
-	UINT8 *buf;
+	UINT8 *buf, *p;
 	UINT32 i, wrote;
+	size_t length;
+	savepage_t *pages, *page;
 	thinker_t *th;
 	if (gamestate != GS_LEVEL)
 	{
@@ -4102,14 +4108,20 @@ static void Command_Archivetest_f(void)
 		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
 			((mobj_t *)th)->mobjnum = i++;
 
-	// allocate buffer
-	buf = save_p = ZZ_Alloc(1024);
-
 	// test archive
 	CONS_Printf("LUA_Archive...\n");
+	P_BeginSave();
 	LUA_Archive();
+	P_SaveReserve(1);
 	WRITEUINT8(save_p, 0x7F);
-	wrote = (UINT32)(save_p-buf);
+	pages = P_EndSave(&length);
+	wrote = (UINT32)length;
+
+	// put the pages back together
+	p = buf = ZZ_Alloc(length);
+	for (page = pages; page; page = page->next)
+		WRITEMEM(p, page->data, page->length);
+	P_FreeSave(pages);
 
 	// clear Lua state, so we can really see what happens!
 	CONS_Printf("Clearing state!\n");
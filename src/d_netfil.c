@@ -42,6 +42,12 @@
 #include <utime.h>
 #endif
 
+// Fragments are read straight from where they are in the file
+#if (defined (__unix__) && !defined (MSDOS)) || defined (__APPLE__) || defined (UNIXCOMMON)
+#define HAVE_PREAD
+#include <unistd.h>
+#endif
+
 #include "doomdef.h"
 #include "doomstat.h"
 #include "d_main.h"
@@ -59,6 +65,7 @@
 #include "m_menu.h"
 #include "md5.h"
 #include "filesrch.h"
+#include "i_threads.h"
 
 #include <errno.h>
 
@@ -72,6 +79,7 @@ typedef struct filetx_s
 	union {
 		char *filename; // Name of the file
 		char *ram; // Pointer to the data in RAM
+		sharedram_t *shared; // Block shared with other transfers
 	} id;
 	UINT32 size; // Size of the file
 	UINT8 fileid;
@@ -79,12 +87,38 @@ typedef struct filetx_s
 	struct filetx_s *next; // Next file in the list
 } filetx_t;
 
+// Chunks in flight on the PT_FILECHUNK channel, as many as a PT_FILEACK can tell about
+#define FILEWINDOW FILEACKBITS
+// Most chunks sent to a node in one tic, so a whole window doesn't go out at once
+#define FILEBURST 64
+
+// A chunk in flight
+typedef struct
+{
+	tic_t senttime;
+	UINT8 flags; // CHUNK_ flags
+} chunkslot_t;
+
+#define CHUNK_ACKED  0x01 // The client has it
+#define CHUNK_LOST   0x02 // Later chunks arrived, so resend it
+#define CHUNK_RESENT 0x04 // Sent more than once, so it says nothing about the ping
+
 // Current transfers (one for each node)
 typedef struct filetran_s
 {
 	filetx_t *txlist; // Linked list of all files for the node
-	UINT32 position; // The current position in the file
 	FILE *currentfile; // The file currently being sent/received
+
+	// PT_FILECHUNK channel, a sliding window with selective acks
+	UINT16 chunksize;
+	UINT32 numchunks;
+	UINT32 firstmissing; // Every chunk before this one was acknowledged
+	UINT32 nextchunk; // First chunk that was never sent
+	UINT32 recoverpoint; // Losses before this chunk don't shrink the window again
+	fixed_t window; // How many chunks can be in flight (congestion window)
+	fixed_t threshold; // Window size where slow start ends
+	fixed_t ping; // Smoothed round trip time, in tics
+	chunkslot_t slots[FILEWINDOW]; // Indexed by chunk % FILEWINDOW
 } filetran_t;
 static filetran_t transfer[MAXNETNODES];
 
@@ -96,6 +130,17 @@ INT32 fileneedednum; // Number of files needed to join the server
 fileneeded_t fileneeded[MAX_WADFILES]; // List of needed files
 char downloaddir[512] = "DOWNLOAD";
 
+// Which chunks of the file being downloaded with PT_FILECHUNK have arrived
+static struct
+{
+	INT32 fileid; // -1 if none
+	UINT8 *got; // Bit per chunk
+	UINT32 gotsize; // Size of got in bytes
+	UINT32 firstmissing;
+	UINT32 numchunks; // 0 until the last chunk arrives
+	UINT8 sinceack; // Chunks since the last PT_FILEACK
+} chunkrecv = {-1, NULL, 0, 0, 0, 0};
+
 #ifdef CLIENT_LOADINGSCREEN
 // for cl loading screen
 INT32 lastfilenum = -1;
@@ -245,6 +290,26 @@ boolean CL_CheckDownloadable(void)
 	return false;
 }
 
+/** Gets the folder a downloaded file goes in, and creates it
+  *
+  * \param md5sum The file's MD5
+  * \return downloaddir/md5, in a static buffer
+  *
+  */
+static const char *CL_DownloadDir(const UINT8 *md5sum)
+{
+	static char dir[MAX_WADPATH];
+	char md5text[33];
+	INT32 i;
+
+	for (i = 0; i < 16; i++)
+		sprintf(&md5text[2*i], "%02x", md5sum[i]);
+	snprintf(dir, sizeof dir, "%s/%s", downloaddir, md5text);
+	I_mkdir(downloaddir, 0755);
+	I_mkdir(dir, 0755);
+	return dir;
+}
+
 /** Sends requests for files in the ::fileneeded table with a status of
   * ::FS_NOTFOUND.
   *
@@ -279,8 +344,9 @@ boolean CL_SendRequestFile(void)
 			nameonly(fileneeded[i].filename);
 			WRITEUINT8(p, i); // fileid
 			WRITESTRINGN(p, fileneeded[i].filename, MAX_WADPATH);
-			// put it in download dir
-			strcatbf(fileneeded[i].filename, downloaddir, "/");
+			// put it in download dir, under its md5 so that files
+			// with the same name from different servers don't clash
+			strcatbf(fileneeded[i].filename, CL_DownloadDir(fileneeded[i].md5sum), "/");
 			fileneeded[i].status = FS_REQUESTED;
 		}
 	WRITEUINT8(p, 0xFF);
@@ -380,12 +446,10 @@ INT32 CL_CheckFiles(void)
 	{
 		CONS_Debug(DBG_NETPLAY, "searching for '%s' ", fileneeded[i].filename);
 
-		// Check in already loaded files
+		// Check in already loaded files, whatever they're called here
 		for (j = 1; wadfiles[j]; j++)
 		{
-			nameonly(strcpy(wadfilename, wadfiles[j]->filename));
-			if (!stricmp(wadfilename, fileneeded[i].filename) &&
-				!memcmp(wadfiles[j]->md5sum, fileneeded[i].md5sum, 16))
+			if (!memcmp(wadfiles[j]->md5sum, fileneeded[i].md5sum, 16))
 			{
 				CONS_Debug(DBG_NETPLAY, "already loaded\n");
 				fileneeded[i].status = FS_OPEN;
@@ -403,7 +467,14 @@ INT32 CL_CheckFiles(void)
 
 		filestoget++;
 
-		fileneeded[i].status = findfile(fileneeded[i].filename, fileneeded[i].md5sum, true);
+		// Anything we hashed before with the same contents will do, even renamed or moved
+		if (D_FindFileByMD5(fileneeded[i].md5sum, fileneeded[i].totalsize, wadfilename))
+		{
+			strcpy(fileneeded[i].filename, wadfilename);
+			fileneeded[i].status = FS_FOUND;
+		}
+		else
+			fileneeded[i].status = findfile(fileneeded[i].filename, fileneeded[i].md5sum, true);
 		CONS_Debug(DBG_NETPLAY, "found %d\n", fileneeded[i].status);
 		if (fileneeded[i].status != FS_FOUND)
 			ret = 0;
@@ -576,16 +647,107 @@ void SV_SendRam(INT32 node, void *data, size_t size, freemethod_t freemethod, UI
 	memset(p, 0, sizeof (filetx_t));
 
 	p->ram = freemethod; // Remember how to free the memory block for when we're done sending it
-	p->id.ram = data;
+	if (freemethod == SF_SHAREDRAM)
+	{
+		// The size isn't known until the block is ready
+		p->id.shared = data;
+		SV_HoldSharedRam(data);
+	}
+	else
+		p->id.ram = data;
 	p->size = (UINT32)size;
 	p->fileid = fileid;
 	p->next = NULL; // End of list
 
-	DEBFILE(va("Sending ram %p(size:%u) to %d (id=%u)\n",p->id.ram,p->size,node,fileid));
+	DEBFILE(va("Sending ram %p(size:%u) to %d (id=%u)\n",data,p->size,node,fileid));
 
 	filestosend++;
 }
 
+#ifdef HAVE_THREADS
+static I_mutex sharedram_mutex;
+#endif
+
+/** Makes a shared memory block that isn't ready to send yet
+  *
+  * \return The block, held once by the caller
+  * \sa SV_SharedRamReady
+  *
+  */
+sharedram_t *SV_NewSharedRam(void)
+{
+	sharedram_t *block = calloc(1, sizeof (sharedram_t));
+	if (!block)
+		I_Error("SV_NewSharedRam: No more memory\n");
+	block->refcount = 1;
+	return block;
+}
+
+/** Fills in a shared memory block and lets its transfers start
+  *
+  * \param block The block
+  * \param data Its contents, allocated with malloc
+  * \param size The size of the contents in bytes
+  *
+  */
+void SV_SharedRamReady(sharedram_t *block, UINT8 *data, size_t size)
+{
+#ifdef HAVE_THREADS
+	I_LockMutex(&sharedram_mutex);
+#endif
+	block->data = data;
+	block->size = (UINT32)size;
+	block->ready = true;
+#ifdef HAVE_THREADS
+	I_UnlockMutex(sharedram_mutex);
+#endif
+}
+
+static boolean SV_IsSharedRamReady(sharedram_t *block)
+{
+	boolean ready;
+#ifdef HAVE_THREADS
+	I_LockMutex(&sharedram_mutex);
+#endif
+	ready = block->ready;
+#ifdef HAVE_THREADS
+	I_UnlockMutex(sharedram_mutex);
+#endif
+	return ready;
+}
+
+void SV_HoldSharedRam(sharedram_t *block)
+{
+#ifdef HAVE_THREADS
+	I_LockMutex(&sharedram_mutex);
+#endif
+	block->refcount++;
+#ifdef HAVE_THREADS
+	I_UnlockMutex(sharedram_mutex);
+#endif
+}
+
+/** Drops a hold on a shared memory block, freeing it with the last one
+  *
+  * \param block The block
+  *
+  */
+void SV_ReleaseSharedRam(sharedram_t *block)
+{
+	INT32 refcount;
+#ifdef HAVE_THREADS
+	I_LockMutex(&sharedram_mutex);
+#endif
+	refcount = --block->refcount;
+#ifdef HAVE_THREADS
+	I_UnlockMutex(sharedram_mutex);
+#endif
+	if (refcount)
+		return;
+	free(block->data);
+	free(block);
+}
+
 /** Stops sending a file for a node, and removes the file request from the list,
   * either because the file has been fully sent or because the node was disconnected
   *
@@ -613,6 +775,9 @@ static void SV_EndFileSend(INT32 node)
 			free(p->id.ram);
 		case SF_NOFREERAM: // Nothing to free
 			break;
+		case SF_SHAREDRAM: // Shared with other transfers, let go of it
+			SV_ReleaseSharedRam(p->id.shared);
+			break;
 	}
 
 	// Remove the file request from the list
@@ -625,137 +790,303 @@ static void SV_EndFileSend(INT32 node)
 	filestosend--;
 }
 
-#define PACKETPERTIC net_bandwidth/(TICRATE*software_MAXPACKETLENGTH)
-
-/** Handles file transmission
+/** Opens the first file in a node's list, if it isn't open yet
   *
-  * \todo Use an acknowledging method more adapted to file transmission
-  *       The current download speed suffers from lack of ack packets,
-  *       especially when the one downloading has high latency
+  * \param node The destination
   *
   */
-void SV_FileSendTicker(void)
+static void SV_OpenFileSend(INT32 node)
 {
-	static INT32 currentnode = 0;
-	filetx_pak *p;
-	size_t size;
-	filetx_t *f;
-	INT32 packetsent, ram, i, j;
-	INT32 maxpacketsent;
+	filetran_t *t = &transfer[node];
+	filetx_t *f = t->txlist;
 
-	if (!filestosend) // No file to send
+	if (t->currentfile)
 		return;
 
-	if (cv_downloadspeed.value) // New (and experimental) behavior
+	if (!f->ram) // Sending a file
 	{
-		packetsent = cv_downloadspeed.value;
-		// Don't send more packets than we have free acks
-#ifndef NONET
-		maxpacketsent = Net_GetFreeAcks(false) - 5; // Let 5 extra acks just in case
-#else
-		maxpacketsent = 1;
-#endif
-		if (packetsent > maxpacketsent && maxpacketsent > 0) // Send at least one packet
-			packetsent = maxpacketsent;
+		long filesize;
+
+		t->currentfile = fopen(f->id.filename, "rb");
+
+		if (!t->currentfile)
+			I_Error("File %s does not exist",
+				f->id.filename);
+
+		fseek(t->currentfile, 0, SEEK_END);
+		filesize = ftell(t->currentfile);
+
+		// Nobody wants to transfer a file bigger
+		// than 4GB!
+		if (filesize >= LONG_MAX)
+			I_Error("filesize of %s is too large", f->id.filename);
+		if (filesize == -1)
+			I_Error("Error getting filesize of %s", f->id.filename);
+
+		f->size = (UINT32)filesize;
+		fseek(t->currentfile, 0, SEEK_SET);
 	}
-	else // Old behavior
+	else // Sending RAM
 	{
-		packetsent = PACKETPERTIC;
-		if (!packetsent)
-			packetsent = 1;
+		if (f->ram == SF_SHAREDRAM)
+			f->size = f->id.shared->size;
+		t->currentfile = (FILE *)1; // Set currentfile to a non-null value to indicate that it is open
 	}
 
-	netbuffer->packettype = PT_FILEFRAGMENT;
+	t->chunksize = (UINT16)(software_MAXPACKETLENGTH - (FILECHUNKHEADER + BASEPACKETSIZE));
+	t->numchunks = (f->size + t->chunksize - 1) / t->chunksize;
+	if (!t->numchunks)
+		t->numchunks = 1; // Still tell the client about empty files
+	t->firstmissing = t->nextchunk = t->recoverpoint = 0;
+	t->window = 4*FRACUNIT;
+	t->threshold = FILEWINDOW*FRACUNIT;
+	t->ping = (TICRATE/4)*FRACUNIT;
+}
 
-	// (((sendbytes-nowsentbyte)*TICRATE)/(I_GetTime()-starttime)<(UINT32)net_bandwidth)
-	while (packetsent-- && filestosend != 0)
+/** Copies part of the file being sent to a node
+  *
+  * \param node The destination
+  * \param position Where to start in the file
+  * \param buf Where to put it
+  * \param size How many bytes
+  *
+  */
+static void SV_ReadFileSend(INT32 node, UINT32 position, UINT8 *buf, size_t size)
+{
+	filetx_t *f = transfer[node].txlist;
+
+	if (f->ram == SF_SHAREDRAM)
+		M_Memcpy(buf, &f->id.shared->data[position], size);
+	else if (f->ram)
+		M_Memcpy(buf, &f->id.ram[position], size);
+#ifdef HAVE_PREAD
+	else if (pread(fileno(transfer[node].currentfile), buf, size, position) != (ssize_t)size)
+		I_Error("SV_FileSendTicker: can't read %s byte on %s at %d because %s", sizeu1(size), f->id.filename, position, strerror(errno));
+#else
+	else if (fseek(transfer[node].currentfile, position, SEEK_SET)
+		|| fread(buf, 1, size, transfer[node].currentfile) != size)
+		I_Error("SV_FileSendTicker: can't read %s byte on %s at %d because %s", sizeu1(size), f->id.filename, position, strerror(ferror(transfer[node].currentfile)));
+#endif
+}
+
+/** Sends one chunk of the file being sent to a node
+  *
+  * \param node The destination
+  * \param chunk The chunk number
+  * \return True if the packet was sent
+  *
+  */
+static boolean SV_SendChunk(INT32 node, UINT32 chunk)
+{
+	filetran_t *t = &transfer[node];
+	filechunk_pak *p = &netbuffer->u.filechunkpak;
+	UINT32 position = chunk * t->chunksize;
+	size_t size = t->chunksize;
+
+	if (t->txlist->size - position < size)
+		size = t->txlist->size - position;
+
+	netbuffer->packettype = PT_FILECHUNK;
+	SV_ReadFileSend(node, position, p->data, size);
+	p->fileid = t->txlist->fileid;
+	p->flags = (chunk == t->numchunks - 1) ? FILECHUNK_LAST : 0;
+	p->chunksize = SHORT(t->chunksize);
+	p->chunk = LONG(chunk);
+	p->size = SHORT((UINT16)size);
+
+	// Not reliable: the window takes care of losses
+	return HSendPacket(node, false, 0, FILECHUNKHEADER + size);
+}
+
+/** Sends a node what its window allows: lost chunks first, then new ones
+  *
+  * \param node The destination
+  *
+  */
+static void SV_SendChunks(INT32 node)
+{
+	filetran_t *t = &transfer[node];
+	chunkslot_t *slot;
+	tic_t now = I_GetTime();
+	tic_t timeout = (tic_t)(2*t->ping/FRACUNIT) + 2;
+	INT32 burst = cv_downloadspeed.value ? cv_downloadspeed.value : FILEBURST, inflight = 0;
+	boolean timedout = false;
+	UINT32 c;
+
+	SV_OpenFileSend(node);
+
+	for (c = t->firstmissing; c < t->nextchunk && burst; c++)
 	{
-		for (i = currentnode, j = 0; j < MAXNETNODES;
-			i = (i+1) % MAXNETNODES, j++)
-		{
-			if (transfer[i].txlist)
-				goto found;
-		}
-		// no transfer to do
-		I_Error("filestosend=%d but no file to send found\n", filestosend);
-	found:
-		currentnode = (i+1) % MAXNETNODES;
-		f = transfer[i].txlist;
-		ram = f->ram;
-
-		// Open the file if it isn't open yet, or
-		if (!transfer[i].currentfile)
+		slot = &t->slots[c % FILEWINDOW];
+		if (slot->flags & CHUNK_ACKED)
+			continue;
+		if (!(slot->flags & CHUNK_LOST))
 		{
-			if (!ram) // Sending a file
+			if (slot->senttime + timeout > now)
 			{
-				long filesize;
+				inflight++;
+				continue;
+			}
+			timedout = true;
+		}
+		if (!SV_SendChunk(node, c))
+			return;
+		slot->senttime = now;
+		slot->flags = CHUNK_RESENT;
+		inflight++;
+		burst--;
+	}
 
-				transfer[i].currentfile =
-					fopen(f->id.filename, "rb");
+	// Nothing came back for a whole timeout, start over slowly
+	if (timedout)
+	{
+		t->threshold = max(t->window/2, 2*FRACUNIT);
+		t->window = FRACUNIT;
+		t->recoverpoint = t->nextchunk;
+	}
 
-				if (!transfer[i].currentfile)
-					I_Error("File %s does not exist",
-						f->id.filename);
+	while (burst && t->nextchunk < t->numchunks
+		&& inflight < t->window/FRACUNIT
+		&& t->nextchunk - t->firstmissing < FILEWINDOW)
+	{
+		if (!SV_SendChunk(node, t->nextchunk))
+			return;
+		slot = &t->slots[t->nextchunk % FILEWINDOW];
+		slot->senttime = now;
+		slot->flags = 0;
+		t->nextchunk++;
+		inflight++;
+		burst--;
+	}
+}
 
-				fseek(transfer[i].currentfile, 0, SEEK_END);
-				filesize = ftell(transfer[i].currentfile);
+/** Handles file transmission
+  *
+  * Files go out as PT_FILECHUNK, on a window that grows while acks come
+  * back and shrinks on losses, with the client telling exactly which
+  * chunks it has (see Got_Fileackpak).
+  * This doesn't use the ack slots shared with the game packets.
+  *
+  */
+void SV_FileSendTicker(void)
+{
+	INT32 i;
 
-				// Nobody wants to transfer a file bigger
-				// than 4GB!
-				if (filesize >= LONG_MAX)
-					I_Error("filesize of %s is too large", f->id.filename);
-				if (filesize == -1)
-					I_Error("Error getting filesize of %s", f->id.filename);
+	if (!filestosend) // No file to send
+		return;
 
-				f->size = (UINT32)filesize;
-				fseek(transfer[i].currentfile, 0, SEEK_SET);
-			}
-			else // Sending RAM
-				transfer[i].currentfile = (FILE *)1; // Set currentfile to a non-null value to indicate that it is open
-			transfer[i].position = 0;
-		}
+	// Shared blocks may still be in the making
+	for (i = 0; i < MAXNETNODES; i++)
+		if (transfer[i].txlist
+			&& (transfer[i].txlist->ram != SF_SHAREDRAM || transfer[i].currentfile
+			|| SV_IsSharedRamReady(transfer[i].txlist->id.shared)))
+			SV_SendChunks(i);
+}
 
-		// Build a packet containing a file fragment
-		p = &netbuffer->u.filetxpak;
-		size = software_MAXPACKETLENGTH - (FILETXHEADER + BASEPACKETSIZE);
-		if (f->size-transfer[i].position < size)
-			size = f->size-transfer[i].position;
-		if (ram)
-			M_Memcpy(p->data, &f->id.ram[transfer[i].position], size);
-		else if (fread(p->data, 1, size, transfer[i].currentfile) != size)
-			I_Error("SV_FileSendTicker: can't read %s byte on %s at %d because %s", sizeu1(size), f->id.filename, transfer[i].position, strerror(ferror(transfer[i].currentfile)));
-		p->position = LONG(transfer[i].position);
-		// Put flag so receiver knows the total size
-		if (transfer[i].position + size == f->size)
-			p->position |= LONG(0x80000000);
-		p->fileid = f->fileid;
-		p->size = SHORT((UINT16)size);
-
-		// Send the packet
-		if (HSendPacket(i, true, 0, FILETXHEADER + size)) // Reliable SEND
-		{ // Success
-			transfer[i].position = (UINT32)(transfer[i].position + size);
-			if (transfer[i].position == f->size) // Finish?
-				SV_EndFileSend(i);
-		}
-		else
-		{ // Not sent for some odd reason, retry at next call
-			if (!ram)
-				fseek(transfer[i].currentfile,transfer[i].position, SEEK_SET);
-			// Exit the while (can't send this one so why should i send the next?)
+/** Marks a chunk as received by the client
+  *
+  * \param t The transfer
+  * \param chunk The chunk, which must be in the window
+  * \return 1 if the client didn't have it before, 0 otherwise
+  *
+  */
+static INT32 SV_AckChunk(filetran_t *t, UINT32 chunk)
+{
+	chunkslot_t *slot = &t->slots[chunk % FILEWINDOW];
+
+	if (slot->flags & CHUNK_ACKED)
+		return 0;
+
+	// Only chunks sent once tell how long the trip takes
+	if (!(slot->flags & CHUNK_RESENT))
+		t->ping = (t->ping*7 + (fixed_t)(I_GetTime() - slot->senttime)*FRACUNIT)/8;
+
+	slot->flags = CHUNK_ACKED;
+	return 1;
+}
+
+/** Reads a PT_FILEACK: frees what arrived, finds what got lost,
+  * and resizes the window accordingly
+  *
+  * \param node The node that sent it
+  *
+  */
+void Got_Fileackpak(INT32 node)
+{
+	filetran_t *t = &transfer[node];
+	fileack_pak *ack = &netbuffer->u.fileackpak;
+	UINT32 first, c, newest;
+	INT32 n, acked = 0;
+	boolean lost = false;
+
+	// Late acks for a file that's already done are no use
+	if (!t->txlist || !t->currentfile || ack->fileid != t->txlist->fileid)
+		return;
+
+	first = LONG(ack->firstmissing);
+	if (first == UINT32_MAX) // The client already has all of it
+	{
+		SV_EndFileSend(node);
+		return;
+	}
+	if (first > t->nextchunk)
+		first = t->nextchunk;
+
+	for (c = t->firstmissing; c < first; c++)
+		acked += SV_AckChunk(t, c);
+	newest = first;
+
+	for (n = 0; n < FILEACKBITS; n++)
+	{
+		c = first + 1 + n;
+		if (c >= t->nextchunk)
 			break;
+		if (c < t->firstmissing || !(ack->got[n/8] & (1<<(n%8))))
+			continue;
+		acked += SV_AckChunk(t, c);
+		newest = c;
+	}
+
+	while (t->firstmissing < t->nextchunk && (t->slots[t->firstmissing % FILEWINDOW].flags & CHUNK_ACKED))
+		t->firstmissing++;
+
+	if (t->firstmissing >= t->numchunks) // All there, on to the next file
+	{
+		SV_EndFileSend(node);
+		return;
+	}
+
+	// Chunks sent three or more before one that made it are taken as lost
+	for (c = t->firstmissing; c + 3 <= newest; c++)
+	{
+		chunkslot_t *slot = &t->slots[c % FILEWINDOW];
+		if (!(slot->flags & (CHUNK_ACKED|CHUNK_LOST|CHUNK_RESENT)))
+		{
+			slot->flags |= CHUNK_LOST;
+			if (c >= t->recoverpoint)
+				lost = true;
 		}
 	}
+
+	if (lost) // Halve the window, once per window's worth of chunks
+	{
+		t->threshold = max(t->window/2, 2*FRACUNIT);
+		t->window = t->threshold;
+		t->recoverpoint = t->nextchunk;
+	}
+	else if (t->window < t->threshold) // Slow start
+		t->window += acked*FRACUNIT;
+	else // Grow by about a chunk per round trip
+		t->window += acked*FRACUNIT/(t->window/FRACUNIT);
+
+	if (t->window > FILEWINDOW*FRACUNIT)
+		t->window = FILEWINDOW*FRACUNIT;
 }
 
-void Got_Filetxpak(void)
+// Refuses to overwrite the main game files
+static void CL_CheckDownloadName(fileneeded_t *file)
 {
-	INT32 filenum = netbuffer->u.filetxpak.fileid;
-	fileneeded_t *file = &fileneeded[filenum];
-	char *filename;
-	static INT32 filetime = 0;
-
-	filename = va("%s", file->filename);
+	char *filename = va("%s", file->filename);
 	nameonly(filename);
 
 	if (!(strcmp(filename, "srb2.srb")
@@ -767,85 +1098,182 @@ void Got_Filetxpak(void)
 		&& strcmp(filename, "music.dta")
 		))
 		I_Error("Tried to download \"%s\"", filename);
+}
 
-	filename = file->filename;
+static void CL_BadFileStatus(INT32 filenum, filestatus_t status)
+{
+	const char *s;
+	switch(status)
+	{
+	case FS_NOTFOUND:
+		s = "FS_NOTFOUND";
+		break;
+	case FS_FOUND:
+		s = "FS_FOUND";
+		break;
+	case FS_OPEN:
+		s = "FS_OPEN";
+		break;
+	case FS_MD5SUMBAD:
+		s = "FS_MD5SUMBAD";
+		break;
+	default:
+		s = "unknown";
+		break;
+	}
+	I_Error("Received a file not requested (file id: %d, file status: %s)\n", filenum, s);
+}
+
+static boolean CL_GotChunk(UINT32 chunk)
+{
+	return chunk < chunkrecv.gotsize*8 && (chunkrecv.got[chunk/8] & (1<<(chunk%8)));
+}
+
+/** Tells the server which chunks of a file have arrived
+  *
+  * \param fileid The file
+  * \param complete True if the whole file is there
+  *
+  */
+static void CL_SendFileAck(UINT8 fileid, boolean complete)
+{
+	fileack_pak *ack = &netbuffer->u.fileackpak;
+	INT32 n;
+
+	netbuffer->packettype = PT_FILEACK;
+	ack->fileid = fileid;
+	memset(ack->got, 0, sizeof (ack->got));
+	if (complete)
+		ack->firstmissing = LONG(UINT32_MAX);
+	else
+	{
+		ack->firstmissing = LONG(chunkrecv.firstmissing);
+		for (n = 0; n < FILEACKBITS; n++)
+			if (CL_GotChunk(chunkrecv.firstmissing + 1 + n))
+				ack->got[n/8] |= (UINT8)(1<<(n%8));
+	}
+	HSendPacket(servernode, false, 0, sizeof (fileack_pak));
+	chunkrecv.sinceack = 0;
+}
+
+/** Writes a PT_FILECHUNK where it goes in the file, whatever order they come in
+  *
+  * \sa SV_FileSendTicker
+  *
+  */
+void Got_Filechunkpak(void)
+{
+	filechunk_pak *pak = &netbuffer->u.filechunkpak;
+	INT32 filenum = pak->fileid;
+	fileneeded_t *file;
+	UINT32 chunk = LONG(pak->chunk);
+	UINT16 chunksize = SHORT(pak->chunksize);
+	UINT16 size = SHORT(pak->size);
+	boolean inorder;
 
 	if (filenum >= fileneedednum)
 	{
-		DEBFILE(va("fileframent not needed %d>%d\n", filenum, fileneedednum));
-		//I_Error("Received an unneeded file fragment (file id received: %d, file id needed: %d)\n", filenum, fileneedednum);
+		DEBFILE(va("filechunk not needed %d>%d\n", filenum, fileneedednum));
+		return;
+	}
+	file = &fileneeded[filenum];
+
+	// The server missed our last ack, tell it again
+	if (file->status == FS_FOUND || file->status == FS_OPEN)
+	{
+		CL_SendFileAck((UINT8)filenum, true);
+		return;
+	}
+
+	if (!chunksize || size > chunksize || chunk >= UINT32_MAX/chunksize
+		|| (file->totalsize != UINT32_MAX && chunk*chunksize >= file->totalsize + (file->totalsize == 0)))
+	{
+		DEBFILE(va("bad filechunk %u for file %d\n", chunk, filenum));
 		return;
 	}
 
+	CL_CheckDownloadName(file);
+
 	if (file->status == FS_REQUESTED)
 	{
 		if (file->file)
-			I_Error("Got_Filetxpak: already open file\n");
-		file->file = fopen(filename, "wb");
+			I_Error("Got_Filechunkpak: already open file\n");
+		file->file = fopen(file->filename, "wb");
 		if (!file->file)
-			I_Error("Can't create file %s: %s", filename, strerror(errno));
-		CONS_Printf("\r%s...\n",filename);
+			I_Error("Can't create file %s: %s", file->filename, strerror(errno));
+		// Make room for the whole file now, when its size is known
+		if (file->totalsize != UINT32_MAX && file->totalsize
+			&& (fseek(file->file, file->totalsize - 1, SEEK_SET) || fputc(0, file->file) == EOF))
+			I_Error("Can't write to %s: %s\n", file->filename, strerror(ferror(file->file)));
+		CONS_Printf("\r%s...\n", file->filename);
 		file->currentsize = 0;
 		file->status = FS_DOWNLOADING;
+
+		free(chunkrecv.got);
+		chunkrecv.fileid = filenum;
+		chunkrecv.got = NULL;
+		chunkrecv.gotsize = 0;
+		chunkrecv.firstmissing = chunkrecv.numchunks = 0;
+		chunkrecv.sinceack = 0;
 	}
 
-	if (file->status == FS_DOWNLOADING)
+	if (file->status != FS_DOWNLOADING || chunkrecv.fileid != filenum)
 	{
-		UINT32 pos = LONG(netbuffer->u.filetxpak.position);
-		UINT16 size = SHORT(netbuffer->u.filetxpak.size);
-		// Use a special trick to know when the file is complete (not always used)
-		// WARNING: file fragments can arrive out of order so don't stop yet!
-		if (pos & 0x80000000)
-		{
-			pos &= ~0x80000000;
-			file->totalsize = pos + size;
-		}
-		// We can receive packet in the wrong order, anyway all os support gaped file
-		fseek(file->file, pos, SEEK_SET);
-		if (fwrite(netbuffer->u.filetxpak.data,size,1,file->file) != 1)
-			I_Error("Can't write to %s: %s\n",filename, strerror(ferror(file->file)));
-		file->currentsize += size;
-
-		// Finished?
-		if (file->currentsize == file->totalsize)
-		{
-			fclose(file->file);
-			file->file = NULL;
-			file->status = FS_FOUND;
-			CONS_Printf(M_GetText("Downloading %s...(done)\n"),
-				filename);
-		}
+		CL_BadFileStatus(filenum, file->status);
+		return;
 	}
-	else
+
+	if (CL_GotChunk(chunk)) // Sent again before our ack made it
 	{
-		const char *s;
-		switch(file->status)
-		{
-		case FS_NOTFOUND:
-			s = "FS_NOTFOUND";
-			break;
-		case FS_FOUND:
-			s = "FS_FOUND";
-			break;
-		case FS_OPEN:
-			s = "FS_OPEN";
-			break;
-		case FS_MD5SUMBAD:
-			s = "FS_MD5SUMBAD";
-			break;
-		default:
-			s = "unknown";
-			break;
-		}
-		I_Error("Received a file not requested (file id: %d, file status: %s)\n", filenum, s);
+		CL_SendFileAck((UINT8)filenum, false);
+		return;
 	}
-	// Send ack back quickly
-	if (++filetime == 3)
+
+	if (chunk >= chunkrecv.gotsize*8)
 	{
-		Net_SendAcks(servernode);
-		filetime = 0;
+		UINT32 newsize = max(chunkrecv.gotsize*2, chunk/8 + 1);
+		chunkrecv.got = realloc(chunkrecv.got, newsize);
+		if (!chunkrecv.got)
+			I_Error("Got_Filechunkpak: No more memory\n");
+		memset(chunkrecv.got + chunkrecv.gotsize, 0, newsize - chunkrecv.gotsize);
+		chunkrecv.gotsize = newsize;
 	}
 
+	if (fseek(file->file, chunk*chunksize, SEEK_SET)
+		|| (size && fwrite(pak->data, size, 1, file->file) != 1))
+		I_Error("Can't write to %s: %s\n", file->filename, strerror(ferror(file->file)));
+	chunkrecv.got[chunk/8] |= (UINT8)(1<<(chunk%8));
+	file->currentsize += size;
+
+	if (pak->flags & FILECHUNK_LAST)
+	{
+		file->totalsize = chunk*chunksize + size;
+		chunkrecv.numchunks = chunk + 1;
+	}
+
+	inorder = (chunk == chunkrecv.firstmissing);
+	while (CL_GotChunk(chunkrecv.firstmissing))
+		chunkrecv.firstmissing++;
+
+	// Finished?
+	if (chunkrecv.numchunks && chunkrecv.firstmissing >= chunkrecv.numchunks)
+	{
+		fclose(file->file);
+		file->file = NULL;
+		file->status = FS_FOUND;
+		CONS_Printf(M_GetText("Downloading %s...(done)\n"),
+			file->filename);
+
+		CL_SendFileAck((UINT8)filenum, true);
+		free(chunkrecv.got);
+		chunkrecv.got = NULL;
+		chunkrecv.gotsize = 0;
+		chunkrecv.fileid = -1;
+	}
+	// Ack every other chunk, and right away when there's a gap
+	else if (!inorder || ++chunkrecv.sinceack >= 2)
+		CL_SendFileAck((UINT8)filenum, false);
+
 #ifdef CLIENT_LOADINGSCREEN
 	lastfilenum = filenum;
 #endif
@@ -889,9 +1317,10 @@ void CloseNetFile(void)
 			// File is not complete delete it
 			remove(fileneeded[i].filename);
 		}
-
-	// Remove PT_FILEFRAGMENT from acknowledge list
-	Net_AbortPacketType(PT_FILEFRAGMENT);
+	free(chunkrecv.got);
+	chunkrecv.got = NULL;
+	chunkrecv.gotsize = 0;
+	chunkrecv.fileid = -1;
 }
 
 // Functions cut and pasted from Doomatic :)
@@ -931,23 +1360,231 @@ size_t nameonlylength(const char *s)
 #define O_BINARY 0
 #endif
 
+#if !defined (NOMD5) && !defined (_arch_dreamcast) && !defined (_WIN32_WCE)
+// MD5 index: what every file we hashed hashed to, kept across runs in
+// srb2home so big files are only hashed again once they change.
+// Each line of the file is "md5 size mtime path"; it is only ever
+// appended to, and a later line for a path replaces the earlier ones.
+#define MD5INDEX
+
+#define MD5INDEXNAME "md5index.txt"
+
+typedef struct
+{
+	char *path;
+	UINT32 size;
+	time_t mtime;
+	UINT8 md5sum[16];
+} md5entry_t;
+
+static md5entry_t *md5index = NULL;
+static size_t md5indexlen = 0, md5indexmax = 0;
+static boolean md5indexloaded = false;
+
+static md5entry_t *D_FindMD5Entry(const char *path)
+{
+	size_t i;
+	for (i = 0; i < md5indexlen; i++)
+		if (!strcmp(md5index[i].path, path))
+			return &md5index[i];
+	return NULL;
+}
+
+static void D_WriteMD5Entry(FILE *f, const md5entry_t *e)
+{
+	INT32 i;
+	for (i = 0; i < 16; i++)
+		fprintf(f, "%02x", e->md5sum[i]);
+	fprintf(f, " %u %lu %s\n", e->size, (unsigned long)e->mtime, e->path);
+}
+
+/** Adds or updates an entry of the MD5 index
+  *
+  * \param path The file
+  * \param size Its size
+  * \param mtime Its modification time
+  * \param md5sum What it hashes to
+  * \return True if the path was already in the index
+  *
+  */
+static boolean D_SetMD5Entry(const char *path, UINT32 size, time_t mtime, const UINT8 *md5sum)
+{
+	md5entry_t *e = D_FindMD5Entry(path);
+	boolean replaced = (e != NULL);
+
+	if (!e)
+	{
+		if (md5indexlen == md5indexmax)
+		{
+			md5indexmax = md5indexmax ? md5indexmax*2 : 64;
+			md5index = realloc(md5index, md5indexmax * sizeof (*md5index));
+			if (!md5index)
+				I_Error("D_SetMD5Entry: No more memory\n");
+		}
+		e = &md5index[md5indexlen++];
+		e->path = strdup(path);
+		if (!e->path)
+			I_Error("D_SetMD5Entry: No more memory\n");
+	}
+	e->size = size;
+	e->mtime = mtime;
+	M_Memcpy(e->md5sum, md5sum, 16);
+	return replaced;
+}
+
+static void D_LoadMD5Index(void)
+{
+	char line[MAX_WADPATH + 64];
+	FILE *f;
+	size_t i, stale = 0;
+
+	if (md5indexloaded)
+		return;
+	md5indexloaded = true;
+
+	f = fopen(va(pandf, srb2home, MD5INDEXNAME), "r");
+	if (!f)
+		return;
+
+	while (fgets(line, sizeof line, f))
+	{
+		UINT8 md5sum[16];
+		unsigned int size, byte;
+		unsigned long mtime;
+		char *path;
+		int n = 0;
+
+		for (i = 0; i < 16; i++)
+		{
+			if (sscanf(&line[2*i], "%2x", &byte) != 1)
+				break;
+			md5sum[i] = (UINT8)byte;
+		}
+		if (i < 16 || sscanf(&line[32], " %u %lu %n", &size, &mtime, &n) != 2 || !n)
+			continue;
+		path = &line[32 + n];
+		path[strcspn(path, "\r\n")] = '\0';
+		if (*path && D_SetMD5Entry(path, size, (time_t)mtime, md5sum))
+			stale++;
+	}
+	fclose(f);
+
+	// Mostly old lines, write it out again without them
+	if (stale > md5indexlen && (f = fopen(va(pandf, srb2home, MD5INDEXNAME), "w")) != NULL)
+	{
+		for (i = 0; i < md5indexlen; i++)
+			D_WriteMD5Entry(f, &md5index[i]);
+		fclose(f);
+	}
+}
+#endif
+
+/** Gets the MD5 of a file, from the MD5 index when the file
+  * hasn't changed since it was last hashed
+  *
+  * \param filename The file
+  * \param md5sum Where to put it
+  * \return True if it could be read
+  *
+  */
+boolean D_FileMD5(const char *filename, UINT8 *md5sum)
+{
+#if defined (NOMD5) || defined (_arch_dreamcast)
+	(void)filename;
+	memset(md5sum, 0, 16);
+	return false;
+#else
+	FILE *fhandle;
+	tic_t t;
+#ifdef MD5INDEX
+	struct stat st;
+	md5entry_t *e;
+
+	if (stat(filename, &st) < 0)
+		return false;
+
+	D_LoadMD5Index();
+	e = D_FindMD5Entry(filename);
+	if (e && e->size == (UINT32)st.st_size && e->mtime == st.st_mtime)
+	{
+		M_Memcpy(md5sum, e->md5sum, 16);
+		return true;
+	}
+#endif
+
+	if ((fhandle = fopen(filename, "rb")) == NULL)
+		return false;
+
+	t = I_GetTime();
+	CONS_Debug(DBG_SETUP, "Making MD5 for %s\n", filename);
+	if (md5_stream(fhandle, md5sum) == 1)
+	{
+		fclose(fhandle);
+		return false;
+	}
+	CONS_Debug(DBG_SETUP, "MD5 calc for %s took %f seconds\n",
+		filename, (float)(I_GetTime() - t)/NEWTICRATE);
+	fclose(fhandle);
+
+#ifdef MD5INDEX
+	D_SetMD5Entry(filename, (UINT32)st.st_size, st.st_mtime, md5sum);
+	if ((fhandle = fopen(va(pandf, srb2home, MD5INDEXNAME), "a")) != NULL)
+	{
+		D_WriteMD5Entry(fhandle, D_FindMD5Entry(filename));
+		fclose(fhandle);
+	}
+#endif
+	return true;
+#endif
+}
+
+/** Looks in the MD5 index for a file with the given contents,
+  * whatever it is called and wherever it is
+  *
+  * \param md5sum The MD5 it must have
+  * \param size The size it must have
+  * \param filename Where to put its path, MAX_WADPATH long
+  * \return True if one was found, still as it was when hashed
+  *
+  */
+boolean D_FindFileByMD5(const UINT8 *md5sum, UINT32 size, char *filename)
+{
+#ifdef MD5INDEX
+	struct stat st;
+	size_t i;
+
+	D_LoadMD5Index();
+	for (i = 0; i < md5indexlen; i++)
+	{
+		md5entry_t *e = &md5index[i];
+		if (e->size != size || memcmp(e->md5sum, md5sum, 16))
+			continue;
+		if (stat(e->path, &st) < 0 || (UINT32)st.st_size != e->size || st.st_mtime != e->mtime)
+			continue; // Gone or changed since
+		strlcpy(filename, e->path, MAX_WADPATH);
+		return true;
+	}
+#else
+	(void)md5sum;
+	(void)size;
+	(void)filename;
+#endif
+	return false;
+}
+
 filestatus_t checkfilemd5(char *filename, const UINT8 *wantedmd5sum)
 {
 #if defined (NOMD5) || defined (_arch_dreamcast)
 	(void)wantedmd5sum;
 	(void)filename;
 #else
-	FILE *fhandle;
 	UINT8 md5sum[16];
 
 	if (!wantedmd5sum)
 		return FS_FOUND;
 
-	fhandle = fopen(filename, "rb");
-	if (fhandle)
+	if (D_FileMD5(filename, md5sum))
 	{
-		md5_stream(fhandle,md5sum);
-		fclose(fhandle);
 		if (!memcmp(wantedmd5sum, md5sum, 16))
 			return FS_FOUND;
 		return FS_MD5SUMBAD;
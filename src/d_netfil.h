@@ -20,9 +20,23 @@ typedef enum
 	SF_FILE,
 	SF_Z_RAM,
 	SF_RAM,
-	SF_NOFREERAM
+	SF_NOFREERAM,
+	SF_SHAREDRAM // a sharedram_t, released when sent
 } freemethod_t;
 
+/** A memory block sent to several nodes at once, counting its holders
+
+    It can be queued before it's built (on another thread, perhaps);
+    transfers of it wait until SV_SharedRamReady is called.
+*/
+typedef struct
+{
+	UINT8 *data; // malloced, freed with the block
+	UINT32 size;
+	boolean ready;
+	INT32 refcount;
+} sharedram_t;
+
 typedef enum
 {
 	FS_NOTFOUND,
@@ -62,8 +76,14 @@ void CL_LoadServerFiles(void);
 void SV_SendRam(INT32 node, void *data, size_t size, freemethod_t freemethod,
 	UINT8 fileid);
 
+sharedram_t *SV_NewSharedRam(void);
+void SV_SharedRamReady(sharedram_t *block, UINT8 *data, size_t size);
+void SV_HoldSharedRam(sharedram_t *block);
+void SV_ReleaseSharedRam(sharedram_t *block);
+
 void SV_FileSendTicker(void);
-void Got_Filetxpak(void);
+void Got_Filechunkpak(void);
+void Got_Fileackpak(INT32 node);
 boolean SV_SendingFile(INT32 node);
 
 boolean CL_CheckDownloadable(void);
@@ -79,6 +99,8 @@ boolean fileexist(char *filename, time_t ptime);
 filestatus_t findfile(char *filename, const UINT8 *wantedmd5sum,
 	boolean completepath);
 filestatus_t checkfilemd5(char *filename, const UINT8 *wantedmd5sum);
+boolean D_FileMD5(const char *filename, UINT8 *md5sum);
+boolean D_FindFileByMD5(const UINT8 *md5sum, UINT32 size, char *filename);
 
 void nameonly(char *s);
 size_t nameonlylength(const char *s);
@@ -28,6 +28,7 @@
 #include <io.h>
 #include <stdarg.h>
 #include <sys/time.h>
+#include <time.h> // uclock
 #include <fcntl.h>
 
 #ifdef DJGPP
@@ -326,6 +327,16 @@ tic_t I_GetTime (void)
 	return ticcount;
 }
 
+/*==========================================================================*/
+// I_GetTimeMicros ()
+// returns a profiling timestamp in microseconds
+/*==========================================================================*/
+UINT64 I_GetTimeMicros(void)
+{
+	uclock_t t = uclock();
+	return (UINT64)(t / UCLOCKS_PER_SEC) * 1000000 + (UINT64)(t % UCLOCKS_PER_SEC) * 1000000 / UCLOCKS_PER_SEC;
+}
+
 
 void I_Sleep(void)
 {
@@ -150,9 +150,9 @@ extern FILE *logstream;
 // we use comprevision and compbranch instead.
 #else
 #define VERSION    100 // Game version
-#define SUBVERSION 7  // more precise version number
-#define VERSIONSTRING "PlusC v1.07.0 (v2.1.25)"
-#define VERSIONSTRINGW L"PlusC v1.07.0 (v2.1.25)"
+#define SUBVERSION 8  // more precise version number
+#define VERSIONSTRING "PlusC v1.08.0 (v2.1.25)"
+#define VERSIONSTRINGW L"PlusC v1.08.0 (v2.1.25)"
 
 // Hey! If you change this, add 1 to the MODVERSION below!
 // Otherwise we can't force updates!
@@ -218,7 +218,7 @@ extern FILE *logstream;
 // it's only for detection of the version the player is using so the MS can alert them of an update.
 // Only set it higher, not lower, obviously.
 // Note that we use this to help keep internal testing in check; this is why v2.1.0 is not version "1".
-#define MODVERSION 9
+#define MODVERSION 10
 
 // To version config.cfg, MAJOREXECVERSION is set equal to MODVERSION automatically.
 // Increment MINOREXECVERSION whenever a config change is needed that does not correspond
@@ -286,7 +286,7 @@ size_t strlcpy(char *dst, const char *src, size_t siz);
 	#define FUNCNOINLINE __attribute__((noinline))
 
 	#if (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 4) // >= GCC 4.4
-		#ifdef __i386__ // i386 only
+		#if defined (__i386__) || defined (__x86_64__) // x86 only
 			#define FUNCTARGET(X)  __attribute__ ((__target__ (X)))
 		#endif
 	#endif
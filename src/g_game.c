@@ -246,6 +246,7 @@ static UINT8 *demoend;
 static UINT8 demoflags;
 static UINT16 demoversion;
 boolean singledemo; // quit after playing a demo from cmdline
+boolean simbenchmark; // headless P_Ticker benchmark, see G_SimBenchmark
 boolean demo_start; // don't start playing demo right away
 static boolean demosynced = true; // console warning message
 
@@ -5563,6 +5564,153 @@ void G_TimeDemo(const char *name)
 	G_DeferedPlayDemo(name);
 }
 
+//
+// G_SimBenchmark
+// Replays a demo through P_Ticker alone, with no video, sound or
+// event polling, timing every tic and every phase of P_Ticker.
+// Writes a JSON report to reportname and quits.
+//
+static int G_CompareBenchSamples(const void *a, const void *b)
+{
+	const UINT32 x = *(const UINT32 *)a, y = *(const UINT32 *)b;
+	return (x > y) - (x < y);
+}
+
+// Returns the given percentile of the samples, which are sorted in place.
+static UINT32 G_BenchPercentile(UINT32 *samples, size_t count, UINT32 percent)
+{
+	if (!count)
+		return 0;
+	qsort(samples, count, sizeof (*samples), G_CompareBenchSamples);
+	return samples[(count - 1) * percent / 100];
+}
+
+static void G_WriteBenchStats(FILE *f, const char *name, UINT32 *samples, size_t count, boolean last)
+{
+	UINT64 total = 0;
+	size_t i;
+
+	for (i = 0; i < count; i++)
+		total += samples[i];
+
+	fprintf(f, "\t\t\"%s\": {\"total_us\": %s, \"mean_us\": %.2f, ", name,
+		sizeu1((size_t)total), count ? (double)total/count : 0.0);
+	fprintf(f, "\"p50_us\": %u, ", G_BenchPercentile(samples, count, 50));
+	fprintf(f, "\"p99_us\": %u, ", G_BenchPercentile(samples, count, 99));
+	fprintf(f, "\"max_us\": %u}%s\n", count ? samples[count-1] : 0, last ? "" : ",");
+}
+
+void G_SimBenchmark(const char *name, const char *reportname)
+{
+	static const char *phasenames[NUMTICKPHASES] = {"playerthink", "thinkers", "lua_thinkframe", "specials", "ghosts"};
+	char demoname[MAX_WADPATH];
+	UINT32 *ticsamples = NULL, *allocsamples = NULL, *phasesamples[NUMTICKPHASES];
+	size_t numsamples = 0, maxsamples = 0, i;
+	UINT64 benchstart, benchtime, totalallocs = 0;
+	INT16 benchmap;
+	FILE *f;
+
+	strlcpy(demoname, name, sizeof demoname);
+
+	simbenchmark = true;
+	singletics = true;
+	memset(phasesamples, 0, sizeof (phasesamples));
+
+	G_DoPlayDemo(demoname);
+	if (!demoplayback)
+		I_Error("simbench: could not play demo %s\n", demoname);
+	benchmap = gamemap;
+
+	CONS_Printf(M_GetText("Benchmarking %s on %s...\n"), demoname, G_BuildMapName(benchmap));
+
+	tickphasetiming = true;
+	benchstart = I_GetTimeMicros();
+
+	while (demoplayback && gamestate == GS_LEVEL && gameaction == ga_nothing)
+	{
+		UINT64 ticstart;
+		UINT32 allocstart;
+
+		if (numsamples == maxsamples)
+		{
+			maxsamples = maxsamples ? maxsamples*2 : 8*TICRATE*60;
+			ticsamples = realloc(ticsamples, maxsamples * sizeof (*ticsamples));
+			allocsamples = realloc(allocsamples, maxsamples * sizeof (*allocsamples));
+			for (i = 0; i < NUMTICKPHASES; i++)
+				phasesamples[i] = realloc(phasesamples[i], maxsamples * sizeof (*phasesamples[i]));
+			if (!ticsamples || !allocsamples)
+				I_Error("simbench: out of memory");
+			for (i = 0; i < NUMTICKPHASES; i++)
+				if (!phasesamples[i])
+					I_Error("simbench: out of memory");
+		}
+
+		memset(tickphasetime, 0, sizeof (tickphasetime));
+		allocstart = Z_GetAllocCount();
+		ticstart = I_GetTimeMicros();
+
+		// same reborn handling as G_Ticker, so deaths in the demo replay correctly
+		P_MapStart();
+		for (i = 0; i < MAXPLAYERS; i++)
+			if (playeringame[i] && players[i].playerstate == PST_REBORN)
+				G_DoReborn((INT32)i);
+		P_MapEnd();
+
+		P_Ticker(true);
+		gametic++;
+
+		ticsamples[numsamples] = (UINT32)(I_GetTimeMicros() - ticstart);
+		allocsamples[numsamples] = Z_GetAllocCount() - allocstart;
+		totalallocs += allocsamples[numsamples];
+		for (i = 0; i < NUMTICKPHASES; i++)
+			phasesamples[i][numsamples] = tickphasetime[i];
+		numsamples++;
+	}
+
+	benchtime = I_GetTimeMicros() - benchstart;
+	tickphasetiming = false;
+
+	if (!benchtime)
+		benchtime = 1;
+
+	CONS_Printf(M_GetText("simbench: %s tics in %.3f seconds, %.1f tics/sec\n"),
+		sizeu1(numsamples), (double)benchtime/1000000, (double)numsamples*1000000/benchtime);
+
+	f = fopen(reportname, "wt");
+	if (!f)
+		I_Error("simbench: could not write report %s\n", reportname);
+
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"demo\": \"%s\",\n", demoname);
+	fprintf(f, "\t\"map\": \"%s\",\n", G_BuildMapName(benchmap));
+	fprintf(f, "\t\"version\": \"%s\",\n", VERSIONSTRING);
+	fprintf(f, "\t\"tics\": %s,\n", sizeu1(numsamples));
+	fprintf(f, "\t\"seconds\": %.6f,\n", (double)benchtime/1000000);
+	fprintf(f, "\t\"tics_per_sec\": %.2f,\n", (double)numsamples*1000000/benchtime);
+	fprintf(f, "\t\"allocs_per_tic\": {\"mean\": %.2f, ", numsamples ? (double)totalallocs/numsamples : 0.0);
+	fprintf(f, "\"p50\": %u, ", G_BenchPercentile(allocsamples, numsamples, 50));
+	fprintf(f, "\"p99\": %u, ", G_BenchPercentile(allocsamples, numsamples, 99));
+	fprintf(f, "\"max\": %u},\n", numsamples ? allocsamples[numsamples-1] : 0);
+	fprintf(f, "\t\"tic\": {\n");
+	G_WriteBenchStats(f, "total", ticsamples, numsamples, true);
+	fprintf(f, "\t},\n");
+	fprintf(f, "\t\"phases\": {\n");
+	for (i = 0; i < NUMTICKPHASES; i++)
+		G_WriteBenchStats(f, phasenames[i], phasesamples[i], numsamples, i == NUMTICKPHASES-1);
+	fprintf(f, "\t}\n");
+	fprintf(f, "}\n");
+	fclose(f);
+
+	CONS_Printf(M_GetText("simbench: report written to %s\n"), reportname);
+
+	free(ticsamples);
+	free(allocsamples);
+	for (i = 0; i < NUMTICKPHASES; i++)
+		free(phasesamples[i]);
+
+	I_Quit();
+}
+
 void G_DoPlayMetal(void)
 {
 	lumpnum_t l;
@@ -5741,6 +5889,9 @@ boolean G_CheckDemoStatus(void)
 			I_Quit();
 		G_StopDemo();
 
+		if (simbenchmark)
+			return true; // G_SimBenchmark writes its report once playback stops
+
 		if (modeattacking)
 			M_EndModeAttackRun();
 		else
@@ -37,6 +37,7 @@ extern boolean playeringame[MAXPLAYERS];
 
 // demoplaying back and demo recording
 extern boolean demoplayback, titledemo, demorecording, timingdemo;
+extern boolean simbenchmark;
 
 // Quit after playing a demo from cmdline.
 extern boolean singledemo;
@@ -155,6 +156,7 @@ void G_LoadMetal(UINT8 **buffer);
 
 void G_DoPlayDemo(char *defdemoname);
 void G_TimeDemo(const char *name);
+ATTRNORETURN void FUNCNORETURN G_SimBenchmark(const char *name, const char *reportname);
 void G_AddGhost(char *defdemoname);
 void G_DoPlayMetal(void);
 void G_DoneLevelLoad(void);
@@ -4900,66 +4900,55 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 // --------------------------------------------------------------------------
 static gr_vissprite_t gr_vsprsortedhead;
 
+typedef struct
+{
+	gr_vissprite_t *spr;
+	UINT32 num; // position in the vissprite list, so equal sprites keep their order
+} gr_vsprsort_t;
+
+static gr_vsprsort_t gr_vsprsortbuf[MAXVISSPRITES];
+
+// qsort callback: farthest first, then smallest dispoffset,
+// then the order the sprites were projected in
+static int HWR_VisSpriteCompare(const void *p1, const void *p2)
+{
+	const gr_vsprsort_t *s1 = p1;
+	const gr_vsprsort_t *s2 = p2;
+
+	if (s1->spr->tz != s2->spr->tz)
+		return (s1->spr->tz > s2->spr->tz) ? -1 : 1;
+	// order visprites of same scale by dispoffset, smallest first
+	if (s1->spr->dispoffset != s2->spr->dispoffset)
+		return (s1->spr->dispoffset < s2->spr->dispoffset) ? -1 : 1;
+	return (s1->num < s2->num) ? -1 : (s1->num > s2->num);
+}
+
 static void HWR_SortVisSprites(void)
 {
 	UINT32 i;
-	gr_vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
+	gr_vissprite_t *ds;
 	gr_vissprite_t *best = NULL;
-	gr_vissprite_t unsorted;
-	float bestdist = 0.0f;
-	INT32 bestdispoffset = 0;
 
 	if (!gr_visspritecount)
 		return;
 
-	dsfirst = HWR_GetVisSprite(0);
-
-	for (i = 0, dsnext = dsfirst, ds = NULL; i < gr_visspritecount; i++)
+	for (i = 0; i < gr_visspritecount; i++)
 	{
-		dsprev = ds;
-		ds = dsnext;
-		if (i < gr_visspritecount - 1) dsnext = HWR_GetVisSprite(i + 1);
-
-		ds->next = dsnext;
-		ds->prev = dsprev;
+		gr_vsprsortbuf[i].spr = HWR_GetVisSprite(i);
+		gr_vsprsortbuf[i].num = i;
 	}
 
-	// Fix first and last. ds still points to the last one after the loop
-	dsfirst->prev = &unsorted;
-	unsorted.next = dsfirst;
-	if (ds)
-		ds->next = &unsorted;
-	unsorted.prev = ds;
+	qsort(gr_vsprsortbuf, gr_visspritecount, sizeof (gr_vsprsort_t), HWR_VisSpriteCompare);
 
-	// pull the vissprites out by scale
+	// link the vissprites up in sorted order
 	gr_vsprsortedhead.next = gr_vsprsortedhead.prev = &gr_vsprsortedhead;
 	for (i = 0; i < gr_visspritecount; i++)
 	{
-		best = NULL;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
-		{
-			if (!best || ds->tz > bestdist)
-			{
-				bestdist = ds->tz;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-			// order visprites of same scale by dispoffset, smallest first
-			else if (fabsf(ds->tz - bestdist) < 1.0E-36f && ds->dispoffset < bestdispoffset)
-			{
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-		}
-		if (best)
-		{
-			best->next->prev = best->prev;
-			best->prev->next = best->next;
-			best->next = &gr_vsprsortedhead;
-			best->prev = gr_vsprsortedhead.prev;
-		}
-		gr_vsprsortedhead.prev->next = best;
-		gr_vsprsortedhead.prev = best;
+		ds = gr_vsprsortbuf[i].spr;
+		ds->next = &gr_vsprsortedhead;
+		ds->prev = gr_vsprsortedhead.prev;
+		gr_vsprsortedhead.prev->next = ds;
+		gr_vsprsortedhead.prev = ds;
 	}
 
 	// Sryder:	Oh boy, while it's nice having ALL the sprites sorted properly, it fails when we bring MD2's into the
@@ -81,7 +81,19 @@ typedef struct
 #pragma pack()
 #endif
 
-extern doomcom_t *doomcom;
+// The network thread in d_net.c sends and receives with a doomcom of its own
+#if defined (HAVE_THREADS) && !defined (NONET)
+#define NETTHREAD
+#ifdef _MSC_VER
+#define NETLOCAL __declspec(thread)
+#else
+#define NETLOCAL __thread
+#endif
+#else
+#define NETLOCAL
+#endif
+
+extern NETLOCAL doomcom_t *doomcom;
 
 /**	\brief return packet in doomcom struct
 */
@@ -99,6 +111,14 @@ extern void (*I_NetSend)(void);
 */
 extern boolean (*I_NetCanSend)(void);
 
+/**	\brief	send any packets the driver has been holding back
+
+	\return	void
+
+
+*/
+extern void (*I_NetFlush)(void);
+
 /**	\brief	close a connection
 
 	\param	nodenum	node to be closed
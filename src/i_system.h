@@ -46,6 +46,11 @@ UINT32 I_GetFreeMem(UINT32 *total);
 */
 tic_t I_GetTime(void);
 
+/**	\brief  Returns a high resolution timestamp in microseconds, for profiling.
+	Only differences between two calls are meaningful.
+*/
+UINT64 I_GetTimeMicros(void);
+
 /**	\brief	The I_Sleep function
 
 	\return	void
@@ -266,6 +271,8 @@ typedef struct {
 	int PPCMM64    : 1; ///< PowerPC Movemem 64bit ok?
 	int ALPHAbyte  : 1; ///< ?
 	int PAE        : 1; ///< Physical Address Extension
+	int AVX2       : 1; ///< AVX2 features
+	int NEON       : 1; ///< ARM NEON features
 	int CPUs       : 8;
 } CPUInfoFlags;
 
@@ -12,6 +12,10 @@
 ///        This is not really OS-dependent because all OSes have the same socket API.
 ///        Just use ifdef for OS-dependent parts.
 
+#if defined (__linux__) && !defined (_GNU_SOURCE)
+#define _GNU_SOURCE // recvmmsg, sendmmsg
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -248,6 +252,47 @@ static boolean init_tcp_driver = false;
 
 static char port_name[8] = DEFAULTPORT;
 
+#ifndef NONET
+// Nodes hashed by address and port, so SOCK_Get doesn't have to compare
+// against every clientaddress. Nodes with port 0 match any port, so they
+// are kept in a list of their own. Rebuilt when clientaddress changes.
+#define ADDRHASHSIZE 64
+static INT32 addrhash[ADDRHASHSIZE]; // first node in each bucket, 0 if none
+static INT32 addrhashnext[MAXNETNODES+1];
+static INT32 anyportnodes[MAXNETNODES+1];
+static size_t numanyportnodes = 0;
+static boolean addrhashdirty = true;
+
+// Linux can read and write many datagrams per system call
+#if defined (__linux__) && defined (MSG_WAITFORONE)
+#define BATCHEDUDP
+#endif
+
+#ifdef BATCHEDUDP
+#define UDPBATCH 64 // datagrams per recvmmsg/sendmmsg
+
+typedef struct
+{
+	SOCKET_TYPE socket;
+	mysockaddr_t address;
+	socklen_t addrlen;
+	INT16 node; // node sent to, for error messages
+	boolean checkerror; // ignore failed sends to broadcast or unsure sockets
+	char data[MAXPACKETLENGTH];
+} udpdatagram_t;
+
+static udpdatagram_t recvbatch[UDPBATCH];
+static struct mmsghdr recvhdrs[UDPBATCH];
+static struct iovec recviov[UDPBATCH];
+static size_t recvhead = 0, recvcount = 0, recvsocket = 0;
+
+static udpdatagram_t sendbatch[UDPBATCH];
+static struct mmsghdr sendhdrs[UDPBATCH];
+static struct iovec sendiov[UDPBATCH];
+static size_t sendcount = 0;
+#endif
+#endif
+
 #ifndef NONET
 
 #ifdef WATTCP
@@ -501,7 +546,7 @@ static boolean SOCK_cmpaddr(mysockaddr_t *a, mysockaddr_t *b, UINT8 mask)
 			&& (b->ip4.sin_port == 0 || (a->ip4.sin_port == b->ip4.sin_port));
 #ifdef HAVE_IPV6
 	else if (b->any.sa_family == AF_INET6)
-		return memcmp(&a->ip6.sin6_addr, &b->ip6.sin6_addr, sizeof(b->ip6.sin6_addr))
+		return !memcmp(&a->ip6.sin6_addr, &b->ip6.sin6_addr, sizeof(b->ip6.sin6_addr))
 			&& (b->ip6.sin6_port == 0 || (a->ip6.sin6_port == b->ip6.sin6_port));
 #endif
 	else
@@ -595,11 +640,278 @@ void Command_Numnodes(void)
 #endif
 
 #ifndef NONET
+static UINT32 SOCK_HashAddr(mysockaddr_t *sk)
+{
+	const UINT8 *p;
+	size_t len;
+	UINT16 port;
+	UINT32 hash = 2166136261u; // FNV-1a
+
+	if (sk->any.sa_family == AF_INET)
+	{
+		p = (const UINT8 *)&sk->ip4.sin_addr;
+		len = sizeof (sk->ip4.sin_addr);
+		port = sk->ip4.sin_port;
+	}
+#ifdef HAVE_IPV6
+	else if (sk->any.sa_family == AF_INET6)
+	{
+		p = (const UINT8 *)&sk->ip6.sin6_addr;
+		len = sizeof (sk->ip6.sin6_addr);
+		port = sk->ip6.sin6_port;
+	}
+#endif
+	else
+		return 0;
+
+	while (len--)
+		hash = (hash ^ *p++) * 16777619u;
+	hash = (hash ^ (port & 0xFF)) * 16777619u;
+	hash = (hash ^ (port >> 8)) * 16777619u;
+	return hash % ADDRHASHSIZE;
+}
+
+static boolean SOCK_AnyPort(mysockaddr_t *sk)
+{
+#ifdef HAVE_IPV6
+	if (sk->any.sa_family == AF_INET6)
+		return sk->ip6.sin6_port == 0;
+#endif
+	return sk->ip4.sin_port == 0;
+}
+
+static void SOCK_RehashNodes(void)
+{
+	UINT32 h;
+	INT32 j;
+
+	memset(addrhash, 0, sizeof (addrhash));
+	numanyportnodes = 0;
+
+	// walk backwards so every bucket ends up sorted by node number
+	for (j = MAXNETNODES; j > 0; j--)
+	{
+		if (clientaddress[j].any.sa_family != AF_INET
+#ifdef HAVE_IPV6
+		 && clientaddress[j].any.sa_family != AF_INET6
+#endif
+		)
+			continue;
+
+		if (SOCK_AnyPort(&clientaddress[j]))
+			anyportnodes[numanyportnodes++] = j;
+		else
+		{
+			h = SOCK_HashAddr(&clientaddress[j]);
+			addrhashnext[j] = addrhash[h];
+			addrhash[h] = j;
+		}
+	}
+
+	addrhashdirty = false;
+}
+
+// Returns the lowest node whose address matches, or 0 for none
+static INT32 SOCK_FindNode(mysockaddr_t *from)
+{
+	INT32 j, node = 0;
+	size_t i;
+
+	if (addrhashdirty)
+		SOCK_RehashNodes();
+
+	for (j = addrhash[SOCK_HashAddr(from)]; j; j = addrhashnext[j])
+		if (SOCK_cmpaddr(from, &clientaddress[j], 0))
+		{
+			node = j;
+			break;
+		}
+
+	// anyportnodes is sorted highest first
+	for (i = numanyportnodes; i--;)
+	{
+		j = anyportnodes[i];
+		if (node && j > node)
+			break;
+		if (SOCK_cmpaddr(from, &clientaddress[j], 0))
+			return j;
+	}
+
+	return node;
+}
+
+typedef enum
+{
+	PACKET_DROPPED,
+	PACKET_KNOWNNODE,
+	PACKET_NEWNODE
+} packetsource_t;
+
+// Assigns the packet in doomcom->data to its node, making a new node if needed
+static packetsource_t SOCK_GotPacket(SOCKET_TYPE socket, mysockaddr_t *fromaddress, socklen_t fromlen, ssize_t c)
+{
+	size_t i;
+	INT32 j;
+
+	// find remote node number
+	j = SOCK_FindNode(fromaddress);
+	if (j)
+	{
+		doomcom->remotenode = (INT16)j; // good packet from a game player
+		doomcom->datalength = (INT16)c;
+		nodesocket[j] = socket;
+		return PACKET_KNOWNNODE;
+	}
+	// not found
+
+	// find a free slot
+	j = getfreenode();
+	if (j > 0)
+	{
+		M_Memcpy(&clientaddress[j], fromaddress, fromlen);
+		addrhashdirty = true;
+		nodesocket[j] = socket;
+		DEBFILE(va("New node detected: node:%d address:%s\n", j,
+				SOCK_GetNodeAddress(j)));
+		doomcom->remotenode = (INT16)j; // good packet from a game player
+		doomcom->datalength = (INT16)c;
+
+		// check if it's a banned dude so we can send a refusal later
+		for (i = 0; i < numbans; i++)
+		{
+			if (SOCK_cmpaddr(fromaddress, &banned[i], bannedmask[i]))
+			{
+				SOCK_bannednode[j] = true;
+				DEBFILE("This dude has been banned\n");
+				break;
+			}
+		}
+		if (i == numbans)
+			SOCK_bannednode[j] = false;
+		return PACKET_NEWNODE;
+	}
+
+	DEBFILE("New node detected: No more free slots\n");
+	return PACKET_DROPPED;
+}
+
+#ifdef BATCHEDUDP
+// Sends every queued datagram, one sendmmsg per run of the same socket
+static void SOCK_FlushBatch(void)
+{
+	size_t i = 0, end;
+	int sent, e;
+
+	while (i < sendcount)
+	{
+		for (end = i + 1; end < sendcount && sendbatch[end].socket == sendbatch[i].socket; end++)
+			;
+
+		while (i < end)
+		{
+			sent = sendmmsg(sendbatch[i].socket, &sendhdrs[i], (unsigned int)(end - i), 0);
+			if (sent > 0)
+			{
+				i += sent;
+				continue;
+			}
+
+			// the datagram at i failed, skip it and go on with the rest
+			e = errno; // save error code so it can't be modified later
+			if (sendbatch[i].checkerror && e != ECONNREFUSED && e != EWOULDBLOCK)
+				I_Error("SOCK_Send, error sending to node %d (%s) #%u: %s", sendbatch[i].node,
+					SOCK_GetNodeAddress(sendbatch[i].node), e, strerror(e));
+			i++;
+		}
+	}
+
+	sendcount = 0;
+}
+
+// Reads all waiting datagrams, up to UDPBATCH, into recvbatch
+static void SOCK_RecvBatch(void)
+{
+	size_t i, n;
+	int got;
+
+	recvhead = recvcount = 0;
+
+	for (n = 0; n < mysocketses && recvcount < UDPBATCH; n++)
+	{
+		// start on a different socket each time so a busy one can't starve the rest
+		SOCKET_TYPE socket = mysockets[(recvsocket + n) % mysocketses];
+
+		for (i = recvcount; i < UDPBATCH; i++)
+		{
+			recviov[i].iov_base = recvbatch[i].data;
+			recviov[i].iov_len = MAXPACKETLENGTH;
+			memset(&recvhdrs[i], 0, sizeof (recvhdrs[i]));
+			recvhdrs[i].msg_hdr.msg_name = &recvbatch[i].address;
+			recvhdrs[i].msg_hdr.msg_namelen = (socklen_t)sizeof (mysockaddr_t);
+			recvhdrs[i].msg_hdr.msg_iov = &recviov[i];
+			recvhdrs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		got = recvmmsg(socket, &recvhdrs[recvcount], (unsigned int)(UDPBATCH - recvcount), MSG_DONTWAIT, NULL);
+		if (got <= 0)
+			continue;
+
+		for (i = recvcount; i < recvcount + got; i++)
+		{
+			recvbatch[i].socket = socket;
+			recvbatch[i].addrlen = recvhdrs[i].msg_hdr.msg_namelen;
+		}
+		recvcount += got;
+	}
+
+	if (mysocketses)
+		recvsocket = (recvsocket + 1) % mysocketses;
+}
+
 // Returns true if a packet was received from a new node, false in all other cases
 static boolean SOCK_Get(void)
 {
-	size_t i, n;
-	int j;
+	boolean refilled = false;
+	size_t i;
+
+	// get our replies out before looking for new packets
+	SOCK_FlushBatch();
+
+	for (;;)
+	{
+		if (recvhead == recvcount)
+		{
+			// read at most one batch per call
+			if (refilled)
+				break;
+			SOCK_RecvBatch();
+			refilled = true;
+			if (!recvcount)
+				break;
+		}
+
+		i = recvhead++;
+		M_Memcpy(doomcom->data, recvbatch[i].data, recvhdrs[i].msg_len);
+		switch (SOCK_GotPacket(recvbatch[i].socket, &recvbatch[i].address,
+			recvbatch[i].addrlen, (ssize_t)recvhdrs[i].msg_len))
+		{
+			case PACKET_NEWNODE:
+				return true;
+			case PACKET_KNOWNNODE:
+				return false;
+			default:
+				break;
+		}
+	}
+
+	doomcom->remotenode = -1; // no packet
+	return false;
+}
+#else
+// Returns true if a packet was received from a new node, false in all other cases
+static boolean SOCK_Get(void)
+{
+	size_t n;
 	ssize_t c;
 	mysockaddr_t fromaddress;
 	socklen_t fromlen;
@@ -611,46 +923,15 @@ static boolean SOCK_Get(void)
 			(void *)&fromaddress, &fromlen);
 		if (c != ERRSOCKET)
 		{
-			// find remote node number
-			for (j = 1; j <= MAXNETNODES; j++) //include LAN
+			switch (SOCK_GotPacket(mysockets[n], &fromaddress, fromlen, c))
 			{
-				if (SOCK_cmpaddr(&fromaddress, &clientaddress[j], 0))
-				{
-					doomcom->remotenode = (INT16)j; // good packet from a game player
-					doomcom->datalength = (INT16)c;
-					nodesocket[j] = mysockets[n];
+				case PACKET_NEWNODE:
+					return true;
+				case PACKET_KNOWNNODE:
 					return false;
-				}
-			}
-			// not found
-
-			// find a free slot
-			j = getfreenode();
-			if (j > 0)
-			{
-				M_Memcpy(&clientaddress[j], &fromaddress, fromlen);
-				nodesocket[j] = mysockets[n];
-				DEBFILE(va("New node detected: node:%d address:%s\n", j,
-						SOCK_GetNodeAddress(j)));
-				doomcom->remotenode = (INT16)j; // good packet from a game player
-				doomcom->datalength = (INT16)c;
-
-				// check if it's a banned dude so we can send a refusal later
-				for (i = 0; i < numbans; i++)
-				{
-					if (SOCK_cmpaddr(&fromaddress, &banned[i], bannedmask[i]))
-					{
-						SOCK_bannednode[j] = true;
-						DEBFILE("This dude has been banned\n");
-						break;
-					}
-				}
-				if (i == numbans)
-					SOCK_bannednode[j] = false;
-				return true;
+				default:
+					break;
 			}
-			else
-				DEBFILE("New node detected: No more free slots\n");
 		}
 	}
 
@@ -658,6 +939,7 @@ static boolean SOCK_Get(void)
 	return false;
 }
 #endif
+#endif
 
 // check if we can send (do not go over the buffer)
 #ifndef NONET
@@ -730,7 +1012,37 @@ static inline ssize_t SOCK_SendToAddr(SOCKET_TYPE socket, mysockaddr_t *sockaddr
 		default:       d = da; break;
 	}
 
+#ifdef BATCHEDUDP
+	{
+		udpdatagram_t *dg;
+
+		// queue it up, SOCK_FlushBatch sends the lot in one go
+		if (sendcount == UDPBATCH)
+			SOCK_FlushBatch();
+
+		dg = &sendbatch[sendcount];
+		dg->socket = socket;
+		M_Memcpy(&dg->address, sockaddr, d);
+		dg->addrlen = d;
+		dg->node = doomcom->remotenode;
+		dg->checkerror = (doomcom->remotenode != BROADCASTADDR
+			&& nodesocket[doomcom->remotenode] != (SOCKET_TYPE)ERRSOCKET);
+		M_Memcpy(dg->data, doomcom->data, doomcom->datalength);
+
+		sendiov[sendcount].iov_base = dg->data;
+		sendiov[sendcount].iov_len = doomcom->datalength;
+		memset(&sendhdrs[sendcount], 0, sizeof (sendhdrs[sendcount]));
+		sendhdrs[sendcount].msg_hdr.msg_name = &dg->address;
+		sendhdrs[sendcount].msg_hdr.msg_namelen = d;
+		sendhdrs[sendcount].msg_hdr.msg_iov = &sendiov[sendcount];
+		sendhdrs[sendcount].msg_hdr.msg_iovlen = 1;
+		sendcount++;
+
+		return doomcom->datalength; // errors are reported when flushed
+	}
+#else
 	return sendto(socket, (char *)&doomcom->data, doomcom->datalength, 0, &sockaddr->any, d);
+#endif
 }
 
 static void SOCK_Send(void)
@@ -791,6 +1103,7 @@ static void SOCK_FreeNodenum(INT32 numnode)
 
 	// put invalid address
 	memset(&clientaddress[numnode], 0, sizeof (clientaddress[numnode]));
+	addrhashdirty = true;
 }
 #endif
 
@@ -1071,6 +1384,7 @@ static boolean UDP_Socket(void)
 		clientaddress[s].ip4.sin_addr.s_addr = htonl(INADDR_LOOPBACK); //GetLocalAddress(); // my own ip
 		s++;
 	}
+	addrhashdirty = true;
 
 	s = 0;
 
@@ -1260,6 +1574,11 @@ boolean I_InitTcpDriver(void)
 static void SOCK_CloseSocket(void)
 {
 	size_t i;
+#ifdef BATCHEDUDP
+	// don't lose the goodbyes
+	SOCK_FlushBatch();
+	recvhead = recvcount = 0;
+#endif
 	for (i=0; i < MAXNETNODES+1; i++)
 	{
 		if (mysockets[i] != (SOCKET_TYPE)ERRSOCKET
@@ -1343,6 +1662,7 @@ static SINT8 SOCK_NetMakeNodewPort(const char *address, const char *port)
 		if (sendto(mysockets[0], NULL, 0, 0, runp->ai_addr, runp->ai_addrlen) == 0)
 		{
 			memcpy(&clientaddress[newnode], runp->ai_addr, runp->ai_addrlen);
+			addrhashdirty = true;
 			break;
 		}
 		runp = runp->ai_next;
@@ -1358,6 +1678,7 @@ static boolean SOCK_OpenSocket(void)
 	size_t i;
 
 	memset(clientaddress, 0, sizeof (clientaddress));
+	addrhashdirty = true;
 
 	nodeconnected[0] = true; // always connected to self
 	for (i = 1; i < MAXNETNODES; i++)
@@ -1368,6 +1689,9 @@ static boolean SOCK_OpenSocket(void)
 	I_NetCloseSocket = SOCK_CloseSocket;
 	I_NetFreeNodenum = SOCK_FreeNodenum;
 	I_NetMakeNodewPort = SOCK_NetMakeNodewPort;
+#ifdef BATCHEDUDP
+	I_NetFlush = SOCK_FlushBatch;
+#endif
 
 #ifdef SELECTTEST
 	// seem like not work with libsocket : (
@@ -0,0 +1,73 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1999-2018 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  i_threads.h
+/// \brief Multithreading abstraction
+
+#ifndef __I_THREADS__
+#define __I_THREADS__
+
+#ifdef HAVE_THREADS
+
+#include "doomtype.h"
+
+typedef void (*I_thread_fn)(void *userdata);
+
+typedef void * I_mutex;
+typedef void * I_cond;
+
+/**	\brief	Get the number of logical processors
+
+	\return	how many threads can run at once, at least 1
+*/
+INT32 I_GetCPUCount(void);
+
+/**	\brief	Start a thread running func(userdata)
+
+	The thread can't be joined; have it signal a condition when it's done.
+
+	\param	name	name of the thread, for debuggers
+	\param	func	function to run
+	\param	userdata	passed to func
+
+	\return	false if the thread couldn't be started
+*/
+boolean I_SpawnThread(const char *name, I_thread_fn func, void *userdata);
+
+/**	\brief	Lock a mutex
+
+	Mutexes and conditions are made on first use, so a
+	NULL I_mutex or I_cond is ready to go.
+
+	\param	anchor	where the mutex lives
+*/
+void I_LockMutex(I_mutex *anchor);
+
+/**	\brief	Unlock a mutex locked with I_LockMutex
+*/
+void I_UnlockMutex(I_mutex mutex);
+
+/**	\brief	Wait on a condition; mutex must be locked, and is locked again on return
+*/
+void I_HoldCond(I_cond *anchor, I_mutex mutex);
+
+/**	\brief	Wake one thread waiting on a condition
+*/
+void I_WakeOneCond(I_cond *anchor);
+
+/**	\brief	Wake every thread waiting on a condition
+*/
+void I_WakeAllCond(I_cond *anchor);
+
+/**	\brief	Put the calling thread to sleep for at least ms milliseconds
+*/
+void I_SleepThread(UINT32 ms);
+
+#endif // HAVE_THREADS
+
+#endif // __I_THREADS__
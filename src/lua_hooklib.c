@@ -63,7 +63,7 @@ struct hook_s
 {
 	struct hook_s *next;
 	enum hook type;
-	UINT16 id;
+	int ref; // the function's luaL_ref in the registry
 	union {
 		mobjtype_t mt;
 		char *skinname;
@@ -73,7 +73,8 @@ struct hook_s
 };
 typedef struct hook_s* hook_p;
 
-#define FMT_HOOKID "hook_%d"
+// Pushes the function of a hook
+#define PushHook(L, hookp) lua_rawgeti(L, LUA_REGISTRYINDEX, (hookp)->ref)
 
 // For each mobj type, a linked list to its thinker and collision hooks.
 // That way, we don't have to iterate through all the hooks.
@@ -85,20 +86,29 @@ static hook_p mobjcollidehooks[NUMMOBJTYPES];
 // For each mobj type, a linked list for other mobj hooks
 static hook_p mobjhooks[NUMMOBJTYPES];
 
-// A linked list for player hooks
-static hook_p playerhooks;
+// For other hooks, a linked list per hook type,
+// so calling them doesn't walk past every other hook.
+static hook_p roothooks[hook_MAX];
 
-// A linked list for linedef executor hooks
-static hook_p linedefexecutorhooks;
+// Linedef executor hooks, chained by a hash of their name
+#define LINEDEFHOOKHASHSIZE 64
+static hook_p linedefexecutorhooks[LINEDEFHOOKHASHSIZE];
 
-// For other hooks, a unique linked list
-hook_p roothook;
+// Hashes a linedef executor hook name for linedefexecutorhooks
+static UINT32 LinedefHookHash(const char *name)
+{
+	UINT32 hash = 5381;
+
+	while (*name)
+		hash = (hash * 33) ^ (UINT8)*name++;
+
+	return hash & (LINEDEFHOOKHASHSIZE-1);
+}
 
 // Takes hook, function, and additional arguments (mobj type to act on, etc.)
 static int lib_addHook(lua_State *L)
 {
-	static struct hook_s hook = {NULL, 0, 0, {0}, false};
-	static UINT32 nextid;
+	static struct hook_s hook = {NULL, 0, LUA_NOREF, {0}, false};
 	hook_p hookp, *lastp;
 
 	hook.type = luaL_checkoption(L, 1, NULL, hookNames);
@@ -161,9 +171,6 @@ static int lib_addHook(lua_State *L)
 
 	hooksAvailable[hook.type/8] |= 1<<(hook.type%8);
 
-	// set hook.id to the highest id + 1
-	hook.id = nextid++;
-
 	// Special cases for some hook types (see the comments above mobjthinkerhooks declaration)
 	switch(hook.type)
 	{
@@ -185,21 +192,18 @@ static int lib_addHook(lua_State *L)
 	case hook_MobjRemoved:
 		lastp = &mobjhooks[hook.s.mt];
 		break;
-	case hook_JumpSpecial:
-	case hook_AbilitySpecial:
-	case hook_SpinSpecial:
-	case hook_JumpSpinSpecial:
-	case hook_PlayerSpawn:
-		lastp = &playerhooks;
-		break;
 	case hook_LinedefExecute:
-		lastp = &linedefexecutorhooks;
+		lastp = &linedefexecutorhooks[LinedefHookHash(hook.s.funcname)];
 		break;
 	default:
-		lastp = &roothook;
+		lastp = &roothooks[hook.type];
 		break;
 	}
 
+	// set the hook function in the registry,
+	// calls fetch it back by the reference instead of by name.
+	hook.ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
 	// iterate the hook metadata structs
 	// set lastp to the last hook struct's "next" pointer.
 	for (hookp = *lastp; hookp; hookp = hookp->next)
@@ -209,74 +213,97 @@ static int lib_addHook(lua_State *L)
 	memcpy(hookp, &hook, sizeof(struct hook_s));
 	// tack it onto the end of the linked list.
 	*lastp = hookp;
-
-	// set the hook function in the registry.
-	lua_pushfstring(L, FMT_HOOKID, hook.id);
-	lua_pushvalue(L, 1);
-	lua_settable(L, LUA_REGISTRYINDEX);
 	return 0;
 }
 
 int LUA_HookLib(lua_State *L)
 {
 	memset(hooksAvailable,0,sizeof(UINT8[(hook_MAX/8)+1]));
-	roothook = NULL;
+	memset(roothooks, 0, sizeof(roothooks));
 	lua_register(L, "addHook", lib_addHook);
 	return 0;
 }
 
-boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
+// Returns the first hook of the given type from hookp on, or NULL
+static hook_p FindHook(hook_p hookp, enum hook which)
 {
-	hook_p hookp;
-	boolean hooked = false;
-	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
-		return false;
+	while (hookp && hookp->type != which)
+		hookp = hookp->next;
+	return hookp;
+}
 
-	I_Assert(mo->type < NUMMOBJTYPES);
+// Calls a hook with copies of the nargs values on top of the stack,
+// leaving its result on top. On an error, warns (once, unless debugging
+// Lua), leaves nothing and returns false.
+static boolean CallHook(hook_p hookp, int nargs)
+{
+	int i;
+
+	PushHook(gL, hookp);
+	for (i = 0; i < nargs; i++)
+		lua_pushvalue(gL, -1-nargs);
+	if (lua_pcall(gL, nargs, 1, 0)) {
+		if (!hookp->error || cv_debug & DBG_LUA)
+			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
+		lua_pop(gL, 1);
+		hookp->error = true;
+		return false;
+	}
+	return true;
+}
 
-	lua_settop(gL, 0);
+// Calls every hook of the given type from hookp on, with the nargs values
+// on top of the stack. Normally returns true if any hook returned true.
+// With force, the last hook not to return nil decides instead:
+// 0 = default (all nil), 1 = force yes, 2 = force no.
+static UINT8 CallHooks(hook_p hookp, enum hook which, int nargs, boolean force)
+{
+	UINT8 result = 0;
 
-	// Look for all generic mobj hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == which)
+	for (hookp = FindHook(hookp, which); hookp; hookp = FindHook(hookp->next, which))
+	{
+		if (!CallHook(hookp, nargs))
+			continue;
+		if (!force)
 		{
-			if (lua_gettop(gL) == 0)
-				LUA_PushUserdata(gL, mo, META_MOBJ);
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			if (lua_pcall(gL, 1, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
 			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
+				result = 1;
 		}
+		else if (!lua_isnil(gL, -1))
+			result = lua_toboolean(gL, -1) ? 1 : 2;
+		lua_pop(gL, 1);
+	}
+	return result;
+}
 
-	for (hookp = mobjhooks[mo->type]; hookp; hookp = hookp->next)
-		if (hookp->type == which)
-		{
-			if (lua_gettop(gL) == 0)
-				LUA_PushUserdata(gL, mo, META_MOBJ);
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			if (lua_pcall(gL, 1, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
+// CallHooks on a mobj type's generic (MT_NULL) hooks, then the ones for
+// the type itself, which get the last word.
+static UINT8 CallMobjHooks(hook_p generic, hook_p typed, enum hook which, int nargs, boolean force)
+{
+	UINT8 result = CallHooks(generic, which, nargs, force);
+	UINT8 typedresult = CallHooks(typed, which, nargs, force);
+
+	return typedresult ? typedresult : result;
+}
+
+boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
+{
+	hook_p generic, typed;
+	boolean hooked;
+	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
+		return false;
+
+	I_Assert(mo->type < NUMMOBJTYPES);
 
+	// Only push the mobj if there's anything to call
+	generic = FindHook(mobjhooks[MT_NULL], which);
+	typed = FindHook(mobjhooks[mo->type], which);
+	if (!generic && !typed)
+		return false;
+
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, mo, META_MOBJ);
+	hooked = CallMobjHooks(generic, typed, which, 1, false);
 	lua_settop(gL, 0);
 	return hooked;
 }
@@ -284,32 +311,16 @@ boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 boolean LUAh_PlayerHook(player_t *plr, enum hook which)
 {
 	hook_p hookp;
-	boolean hooked = false;
+	boolean hooked;
 	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
 		return false;
 
-	lua_settop(gL, 0);
-
-	for (hookp = playerhooks; hookp; hookp = hookp->next)
-		if (hookp->type == which)
-		{
-			if (lua_gettop(gL) == 0)
-				LUA_PushUserdata(gL, plr, META_PLAYER);
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			if (lua_pcall(gL, 1, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
+	if (!(hookp = roothooks[which]))
+		return false;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, plr, META_PLAYER);
+	hooked = CallHooks(hookp, which, 1, false);
 	lua_settop(gL, 0);
 	return hooked;
 }
@@ -324,14 +335,12 @@ void LUAh_MapChange(INT16 mapnumber)
 	lua_settop(gL, 0);
 	lua_pushinteger(gL, mapnumber);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MapChange)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			LUA_Call(gL, 1);
-		}
+	for (hookp = roothooks[hook_MapChange]; hookp; hookp = hookp->next)
+	{
+		PushHook(gL, hookp);
+		lua_pushvalue(gL, -2);
+		LUA_Call(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 }
@@ -346,14 +355,12 @@ void LUAh_MapLoad(void)
 	lua_settop(gL, 0);
 	lua_pushinteger(gL, gamemap);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MapLoad)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			LUA_Call(gL, 1);
-		}
+	for (hookp = roothooks[hook_MapLoad]; hookp; hookp = hookp->next)
+	{
+		PushHook(gL, hookp);
+		lua_pushvalue(gL, -2);
+		LUA_Call(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 }
@@ -368,14 +375,12 @@ void LUAh_PlayerJoin(int playernum)
 	lua_settop(gL, 0);
 	lua_pushinteger(gL, playernum);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_PlayerJoin)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			LUA_Call(gL, 1);
-		}
+	for (hookp = roothooks[hook_PlayerJoin]; hookp; hookp = hookp->next)
+	{
+		PushHook(gL, hookp);
+		lua_pushvalue(gL, -2);
+		LUA_Call(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 }
@@ -383,95 +388,31 @@ void LUAh_PlayerJoin(int playernum)
 // Hook for frame (after mobj and player thinkers)
 void LUAh_ThinkFrame(void)
 {
-	hook_p hookp;
 	if (!gL || !(hooksAvailable[hook_ThinkFrame/8] & (1<<(hook_ThinkFrame%8))))
 		return;
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_ThinkFrame)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			if (lua_pcall(gL, 0, 0, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-			}
-		}
+	CallHooks(roothooks[hook_ThinkFrame], hook_ThinkFrame, 0, false);
 }
 
 // Hook for mobj collisions
 UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 {
-	hook_p hookp;
-	UINT8 shouldCollide = 0; // 0 = default, 1 = force yes, 2 = force no.
+	hook_p generic, typed;
+	UINT8 shouldCollide; // 0 = default, 1 = force yes, 2 = force no.
 	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
 		return 0;
 
 	I_Assert(thing1->type < NUMMOBJTYPES);
 
-	lua_settop(gL, 0);
-
-	// Look for all generic mobj collision hooks
-	for (hookp = mobjcollidehooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == which)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, thing1, META_MOBJ);
-				LUA_PushUserdata(gL, thing2, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (!lua_isnil(gL, -1))
-			{ // if nil, leave shouldCollide = 0.
-				if (lua_toboolean(gL, -1))
-					shouldCollide = 1; // Force yes
-				else
-					shouldCollide = 2; // Force no
-			}
-			lua_pop(gL, 1);
-		}
-
-	for (hookp = mobjcollidehooks[thing1->type]; hookp; hookp = hookp->next)
-		if (hookp->type == which)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, thing1, META_MOBJ);
-				LUA_PushUserdata(gL, thing2, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (!lua_isnil(gL, -1))
-			{ // if nil, leave shouldCollide = 0.
-				if (lua_toboolean(gL, -1))
-					shouldCollide = 1; // Force yes
-				else
-					shouldCollide = 2; // Force no
-			}
-			lua_pop(gL, 1);
-		}
+	generic = FindHook(mobjcollidehooks[MT_NULL], which);
+	typed = FindHook(mobjcollidehooks[thing1->type], which);
+	if (!generic && !typed)
+		return 0;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, thing1, META_MOBJ);
+	LUA_PushUserdata(gL, thing2, META_MOBJ);
+	shouldCollide = CallMobjHooks(generic, typed, which, 2, true);
 	lua_settop(gL, 0);
 	return shouldCollide;
 }
@@ -479,54 +420,22 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 // Hook for mobj thinkers
 boolean LUAh_MobjThinker(mobj_t *mo)
 {
-	hook_p hookp;
-	boolean hooked = false;
+	hook_p generic, typed;
+	boolean hooked;
 	if (!gL || !(hooksAvailable[hook_MobjThinker/8] & (1<<(hook_MobjThinker%8))))
 		return false;
 
 	I_Assert(mo->type < NUMMOBJTYPES);
 
-	lua_settop(gL, 0);
-
-	// Look for all generic mobj thinker hooks
-	for (hookp = mobjthinkerhooks[MT_NULL]; hookp; hookp = hookp->next)
-	{
-		if (lua_gettop(gL) == 0)
-			LUA_PushUserdata(gL, mo, META_MOBJ);
-		lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-		lua_gettable(gL, LUA_REGISTRYINDEX);
-		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 0)) {
-			if (!hookp->error || cv_debug & DBG_LUA)
-				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-			lua_pop(gL, 1);
-			hookp->error = true;
-			continue;
-		}
-		if (lua_toboolean(gL, -1))
-			hooked = true;
-		lua_pop(gL, 1);
-	}
-
-	for (hookp = mobjthinkerhooks[mo->type]; hookp; hookp = hookp->next)
-	{
-		if (lua_gettop(gL) == 0)
-			LUA_PushUserdata(gL, mo, META_MOBJ);
-		lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-		lua_gettable(gL, LUA_REGISTRYINDEX);
-		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 0)) {
-			if (!hookp->error || cv_debug & DBG_LUA)
-				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-			lua_pop(gL, 1);
-			hookp->error = true;
-			continue;
-		}
-		if (lua_toboolean(gL, -1))
-			hooked = true;
-		lua_pop(gL, 1);
-	}
+	// These lists only hold MobjThinker hooks
+	generic = mobjthinkerhooks[MT_NULL];
+	typed = mobjthinkerhooks[mo->type];
+	if (!generic && !typed)
+		return false;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, mo, META_MOBJ);
+	hooked = CallMobjHooks(generic, typed, hook_MobjThinker, 1, false);
 	lua_settop(gL, 0);
 	return hooked;
 }
@@ -534,64 +443,22 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 // Hook for P_TouchSpecialThing by mobj type
 boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 {
-	hook_p hookp;
-	boolean hooked = false;
+	hook_p generic, typed;
+	boolean hooked;
 	if (!gL || !(hooksAvailable[hook_TouchSpecial/8] & (1<<(hook_TouchSpecial%8))))
 		return 0;
 
 	I_Assert(special->type < NUMMOBJTYPES);
 
-	lua_settop(gL, 0);
-
-	// Look for all generic touch special hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_TouchSpecial)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, special, META_MOBJ);
-				LUA_PushUserdata(gL, toucher, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
-
-	for (hookp = mobjhooks[special->type]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_TouchSpecial)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, special, META_MOBJ);
-				LUA_PushUserdata(gL, toucher, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
+	generic = FindHook(mobjhooks[MT_NULL], hook_TouchSpecial);
+	typed = FindHook(mobjhooks[special->type], hook_TouchSpecial);
+	if (!generic && !typed)
+		return 0;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, special, META_MOBJ);
+	LUA_PushUserdata(gL, toucher, META_MOBJ);
+	hooked = CallMobjHooks(generic, typed, hook_TouchSpecial, 2, false);
 	lua_settop(gL, 0);
 	return hooked;
 }
@@ -599,82 +466,24 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 // Hook for P_DamageMobj by mobj type (Should mobj take damage?)
 UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 damage)
 {
-	hook_p hookp;
-	UINT8 shouldDamage = 0; // 0 = default, 1 = force yes, 2 = force no.
+	hook_p generic, typed;
+	UINT8 shouldDamage; // 0 = default, 1 = force yes, 2 = force no.
 	if (!gL || !(hooksAvailable[hook_ShouldDamage/8] & (1<<(hook_ShouldDamage%8))))
 		return 0;
 
 	I_Assert(target->type < NUMMOBJTYPES);
 
-	lua_settop(gL, 0);
-
-	// Look for all generic should damage hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_ShouldDamage)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-				lua_pushinteger(gL, damage);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (!lua_isnil(gL, -1))
-			{
-				if (lua_toboolean(gL, -1))
-					shouldDamage = 1; // Force yes
-				else
-					shouldDamage = 2; // Force no
-			}
-			lua_pop(gL, 1);
-		}
-
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_ShouldDamage)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-				lua_pushinteger(gL, damage);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (!lua_isnil(gL, -1))
-			{
-				if (lua_toboolean(gL, -1))
-					shouldDamage = 1; // Force yes
-				else
-					shouldDamage = 2; // Force no
-			}
-			lua_pop(gL, 1);
-		}
+	generic = FindHook(mobjhooks[MT_NULL], hook_ShouldDamage);
+	typed = FindHook(mobjhooks[target->type], hook_ShouldDamage);
+	if (!generic && !typed)
+		return 0;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, target, META_MOBJ);
+	LUA_PushUserdata(gL, inflictor, META_MOBJ);
+	LUA_PushUserdata(gL, source, META_MOBJ);
+	lua_pushinteger(gL, damage);
+	shouldDamage = CallMobjHooks(generic, typed, hook_ShouldDamage, 4, true);
 	lua_settop(gL, 0);
 	return shouldDamage;
 }
@@ -682,72 +491,24 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 // Hook for P_DamageMobj by mobj type (Mobj actually takes damage!)
 boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 damage)
 {
-	hook_p hookp;
-	boolean hooked = false;
+	hook_p generic, typed;
+	boolean hooked;
 	if (!gL || !(hooksAvailable[hook_MobjDamage/8] & (1<<(hook_MobjDamage%8))))
 		return 0;
 
 	I_Assert(target->type < NUMMOBJTYPES);
 
-	lua_settop(gL, 0);
-
-	// Look for all generic mobj damage hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MobjDamage)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-				lua_pushinteger(gL, damage);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
-
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MobjDamage)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-				lua_pushinteger(gL, damage);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
+	generic = FindHook(mobjhooks[MT_NULL], hook_MobjDamage);
+	typed = FindHook(mobjhooks[target->type], hook_MobjDamage);
+	if (!generic && !typed)
+		return 0;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, target, META_MOBJ);
+	LUA_PushUserdata(gL, inflictor, META_MOBJ);
+	LUA_PushUserdata(gL, source, META_MOBJ);
+	lua_pushinteger(gL, damage);
+	hooked = CallMobjHooks(generic, typed, hook_MobjDamage, 4, false);
 	lua_settop(gL, 0);
 	return hooked;
 }
@@ -755,68 +516,23 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 // Hook for P_KillMobj by mobj type
 boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 {
-	hook_p hookp;
-	boolean hooked = false;
+	hook_p generic, typed;
+	boolean hooked;
 	if (!gL || !(hooksAvailable[hook_MobjDeath/8] & (1<<(hook_MobjDeath%8))))
 		return 0;
 
 	I_Assert(target->type < NUMMOBJTYPES);
 
-	lua_settop(gL, 0);
-
-	// Look for all generic mobj death hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MobjDeath)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			if (lua_pcall(gL, 3, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
-
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MobjDeath)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			if (lua_pcall(gL, 3, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
+	generic = FindHook(mobjhooks[MT_NULL], hook_MobjDeath);
+	typed = FindHook(mobjhooks[target->type], hook_MobjDeath);
+	if (!generic && !typed)
+		return 0;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, target, META_MOBJ);
+	LUA_PushUserdata(gL, inflictor, META_MOBJ);
+	LUA_PushUserdata(gL, source, META_MOBJ);
+	hooked = CallMobjHooks(generic, typed, hook_MobjDeath, 3, false);
 	lua_settop(gL, 0);
 	return hooked;
 }
@@ -825,36 +541,17 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 boolean LUAh_BotTiccmd(player_t *bot, ticcmd_t *cmd)
 {
 	hook_p hookp;
-	boolean hooked = false;
+	boolean hooked;
 	if (!gL || !(hooksAvailable[hook_BotTiccmd/8] & (1<<(hook_BotTiccmd%8))))
 		return false;
 
-	lua_settop(gL, 0);
-
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_BotTiccmd)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, bot, META_PLAYER);
-				LUA_PushUserdata(gL, cmd, META_TICCMD);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
+	if (!(hookp = roothooks[hook_BotTiccmd]))
+		return false;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, bot, META_PLAYER);
+	LUA_PushUserdata(gL, cmd, META_TICCMD);
+	hooked = CallHooks(hookp, hook_BotTiccmd, 2, false);
 	lua_settop(gL, 0);
 	return hooked;
 }
@@ -869,17 +566,15 @@ boolean LUAh_BotAI(mobj_t *sonic, mobj_t *tails, ticcmd_t *cmd)
 
 	lua_settop(gL, 0);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_BotAI
-		&& (hookp->s.skinname == NULL || !strcmp(hookp->s.skinname, ((skin_t*)tails->skin)->name)))
+	for (hookp = roothooks[hook_BotAI]; hookp; hookp = hookp->next)
+		if (hookp->s.skinname == NULL || !strcmp(hookp->s.skinname, ((skin_t*)tails->skin)->name))
 		{
 			if (lua_gettop(gL) == 0)
 			{
 				LUA_PushUserdata(gL, sonic, META_MOBJ);
 				LUA_PushUserdata(gL, tails, META_MOBJ);
 			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
+			PushHook(gL, hookp);
 			lua_pushvalue(gL, -3);
 			lua_pushvalue(gL, -3);
 			if (lua_pcall(gL, 2, 8, 0)) {
@@ -930,7 +625,7 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 
 	lua_settop(gL, 0);
 
-	for (hookp = linedefexecutorhooks; hookp; hookp = hookp->next)
+	for (hookp = linedefexecutorhooks[LinedefHookHash(line->text)]; hookp; hookp = hookp->next)
 		if (!strcmp(hookp->s.funcname, line->text))
 		{
 			if (lua_gettop(gL) == 0)
@@ -939,8 +634,7 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 				LUA_PushUserdata(gL, mo, META_MOBJ);
 				LUA_PushUserdata(gL, sector, META_SECTOR);
 			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
+			PushHook(gL, hookp);
 			lua_pushvalue(gL, -4);
 			lua_pushvalue(gL, -4);
 			lua_pushvalue(gL, -4);
@@ -956,51 +650,30 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 boolean LUAh_PlayerMsg(int source, int target, int flags, char *msg)
 {
 	hook_p hookp;
-	boolean hooked = false;
+	boolean hooked;
 	if (!gL || !(hooksAvailable[hook_PlayerMsg/8] & (1<<(hook_PlayerMsg%8))))
 		return false;
 
-	lua_settop(gL, 0);
-
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_PlayerMsg)
-		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, &players[source], META_PLAYER); // Source player
-				if (flags & 2 /*HU_CSAY*/) { // csay TODO: make HU_CSAY accessible outside hu_stuff.c
-					lua_pushinteger(gL, 3); // type
-					lua_pushnil(gL); // target
-				} else if (target == -1) { // sayteam
-					lua_pushinteger(gL, 1); // type
-					lua_pushnil(gL); // target
-				} else if (target == 0) { // say
-					lua_pushinteger(gL, 0); // type
-					lua_pushnil(gL); // target
-				} else { // sayto
-					lua_pushinteger(gL, 2); // type
-					LUA_PushUserdata(gL, &players[target-1], META_PLAYER); // target
-				}
-				lua_pushstring(gL, msg); // msg
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
-			lua_pop(gL, 1);
-		}
+	if (!(hookp = roothooks[hook_PlayerMsg]))
+		return false;
 
+	lua_settop(gL, 0);
+	LUA_PushUserdata(gL, &players[source], META_PLAYER); // Source player
+	if (flags & 2 /*HU_CSAY*/) { // csay TODO: make HU_CSAY accessible outside hu_stuff.c
+		lua_pushinteger(gL, 3); // type
+		lua_pushnil(gL); // target
+	} else if (target == -1) { // sayteam
+		lua_pushinteger(gL, 1); // type
+		lua_pushnil(gL); // target
+	} else if (target == 0) { // say
+		lua_pushinteger(gL, 0); // type
+		lua_pushnil(gL); // target
+	} else { // sayto
+		lua_pushinteger(gL, 2); // type
+		LUA_PushUserdata(gL, &players[target-1], META_PLAYER); // target
+	}
+	lua_pushstring(gL, msg); // msg
+	hooked = CallHooks(hookp, hook_PlayerMsg, 4, false);
 	lua_settop(gL, 0);
 	return hooked;
 }
@@ -1016,9 +689,8 @@ boolean LUAh_HurtMsg(player_t *player, mobj_t *inflictor, mobj_t *source)
 
 	lua_settop(gL, 0);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_HurtMsg
-		&& (hookp->s.mt == MT_NULL || (inflictor && hookp->s.mt == inflictor->type)))
+	for (hookp = roothooks[hook_HurtMsg]; hookp; hookp = hookp->next)
+		if (hookp->s.mt == MT_NULL || (inflictor && hookp->s.mt == inflictor->type))
 		{
 			if (lua_gettop(gL) == 0)
 			{
@@ -1026,18 +698,8 @@ boolean LUAh_HurtMsg(player_t *player, mobj_t *inflictor, mobj_t *source)
 				LUA_PushUserdata(gL, inflictor, META_MOBJ);
 				LUA_PushUserdata(gL, source, META_MOBJ);
 			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			if (lua_pcall(gL, 3, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
+			if (!CallHook(hookp, 3))
 				continue;
-			}
 			if (lua_toboolean(gL, -1))
 				hooked = true;
 			lua_pop(gL, 1);
@@ -1063,14 +725,12 @@ void LUAh_NetArchiveHook(lua_CFunction archFunc)
 	lua_pushcclosure(gL, archFunc, 1);
 	// stack: tables, archFunc
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_NetVars)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2); // archFunc
-			LUA_Call(gL, 1);
-		}
+	for (hookp = roothooks[hook_NetVars]; hookp; hookp = hookp->next)
+	{
+		PushHook(gL, hookp);
+		lua_pushvalue(gL, -2); // archFunc
+		LUA_Call(gL, 1);
+	}
 
 	lua_pop(gL, 1); // pop archFunc
 	// stack: tables
@@ -1084,20 +744,18 @@ void LUAh_PlayerQuit(player_t *plr, int reason)
 
 	lua_settop(gL, 0);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_PlayerQuit)
+	for (hookp = roothooks[hook_PlayerQuit]; hookp; hookp = hookp->next)
+	{
+		if (lua_gettop(gL) == 0)
 		{
-		    if (lua_gettop(gL) == 0)
-		    {
-		        LUA_PushUserdata(gL, plr, META_PLAYER); // Player that quit
-		        lua_pushinteger(gL, reason); // Reason for quitting
-		    }
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			LUA_Call(gL, 2);
+			LUA_PushUserdata(gL, plr, META_PLAYER); // Player that quit
+			lua_pushinteger(gL, reason); // Reason for quitting
 		}
+		PushHook(gL, hookp);
+		lua_pushvalue(gL, -3);
+		lua_pushvalue(gL, -3);
+		LUA_Call(gL, 2);
+	}
 
 	lua_settop(gL, 0);
 }
@@ -69,6 +69,7 @@ static const char *const hudinfo_opt[] = {
 	"x",
 	"y",
 	NULL};
+static int hudinfo_fields_ref = LUA_NOREF;
 
 enum patch {
 	patch_valid = 0,
@@ -84,6 +85,7 @@ static const char *const patch_opt[] = {
 	"leftoffset",
 	"topoffset",
 	NULL};
+static int patch_fields_ref = LUA_NOREF;
 
 enum hudhook {
 	hudhook_game = 0,
@@ -168,6 +170,7 @@ static const char *const camera_opt[] = {
 	"momy",
 	"momz",
 	NULL};
+static int camera_fields_ref = LUA_NOREF;
 
 static int lib_getHudInfo(lua_State *L)
 {
@@ -190,7 +193,7 @@ static int lib_hudinfolen(lua_State *L)
 static int hudinfo_get(lua_State *L)
 {
 	hudinfo_t *info = *((hudinfo_t **)luaL_checkudata(L, 1, META_HUDINFO));
-	enum hudinfo field = luaL_checkoption(L, 2, hudinfo_opt[0], hudinfo_opt);
+	enum hudinfo field = Lua_checkfield(L, 2, hudinfo_opt[0], hudinfo_fields_ref);
 	I_Assert(info != NULL); // huditems are always valid
 
 	switch(field)
@@ -208,7 +211,7 @@ static int hudinfo_get(lua_State *L)
 static int hudinfo_set(lua_State *L)
 {
 	hudinfo_t *info = *((hudinfo_t **)luaL_checkudata(L, 1, META_HUDINFO));
-	enum hudinfo field = luaL_checkoption(L, 2, hudinfo_opt[0], hudinfo_opt);
+	enum hudinfo field = Lua_checkfield(L, 2, hudinfo_opt[0], hudinfo_fields_ref);
 	I_Assert(info != NULL);
 
 	switch(field)
@@ -238,7 +241,7 @@ static int colormap_get(lua_State *L)
 static int patch_get(lua_State *L)
 {
 	patch_t *patch = *((patch_t **)luaL_checkudata(L, 1, META_PATCH));
-	enum patch field = luaL_checkoption(L, 2, NULL, patch_opt);
+	enum patch field = Lua_checkfield(L, 2, NULL, patch_fields_ref);
 
 	// patches are CURRENTLY always valid, expected to be cached with PU_STATIC
 	// this may change in the future, so patch.valid still exists
@@ -273,7 +276,7 @@ static int patch_set(lua_State *L)
 static int camera_get(lua_State *L)
 {
 	camera_t *cam = *((camera_t **)luaL_checkudata(L, 1, META_CAMERA));
-	enum cameraf field = luaL_checkoption(L, 2, NULL, camera_opt);
+	enum cameraf field = Lua_checkfield(L, 2, NULL, camera_fields_ref);
 
 	// cameras should always be valid unless I'm a nutter
 	I_Assert(cam != NULL);
@@ -671,6 +674,10 @@ int LUA_HudLib(lua_State *L)
 {
 	memset(hud_enabled, 0xff, (hud_MAX/8)+1);
 
+	hudinfo_fields_ref = Lua_CreateFieldTable(L, hudinfo_opt);
+	patch_fields_ref = Lua_CreateFieldTable(L, patch_opt);
+	camera_fields_ref = Lua_CreateFieldTable(L, camera_opt);
+
 	lua_newtable(L); // HUD registry table
 		lua_newtable(L);
 		luaL_register(L, NULL, lib_draw);
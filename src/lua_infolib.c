@@ -40,6 +40,7 @@ const char *const sfxinfo_ropt[] = {
 	"flags",
 	"skinsound",
 	NULL};
+static int sfxinfo_rfields_ref = LUA_NOREF;
 
 enum sfxinfo_write {
 	sfxinfow_singular = 0,
@@ -51,6 +52,7 @@ const char *const sfxinfo_wopt[] = {
 	"priority",
 	"flags",
 	NULL};
+static int sfxinfo_wfields_ref = LUA_NOREF;
 
 
 //====================
@@ -135,6 +137,21 @@ static void A_Lua(mobj_t *actor)
 	boolean found = false;
 	I_Assert(actor != NULL);
 
+	// get the name for this action, if it has one.
+	// it was captured when the action was bound to the state,
+	// and stays on the stack so it can't be collected mid-call.
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_STATEACTIONNAME);
+	I_Assert(lua_istable(gL, -1));
+	lua_pushlightuserdata(gL, astate);
+	lua_rawget(gL, -2);
+	lua_remove(gL, -2); // pop LREG_STATEACTIONNAME
+	if (lua_isstring(gL, -1))
+	{
+		found = true;
+		superactions[superstack] = lua_tostring(gL, -1); // "A_ACTION"
+		++superstack;
+	}
+
 	// get the action for this state
 	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_STATEACTION);
 	I_Assert(lua_istable(gL, -1));
@@ -143,23 +160,6 @@ static void A_Lua(mobj_t *actor)
 	I_Assert(lua_isfunction(gL, -1));
 	lua_remove(gL, -2); // pop LREG_STATEACTION
 
-	// get the name for this action, if possible.
-	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_ACTIONS);
-	lua_pushnil(gL);
-	while (lua_next(gL, -2))
-	{
-		if (lua_rawequal(gL, -1, -4))
-		{
-			found = true;
-			superactions[superstack] = lua_tostring(gL, -2); // "A_ACTION"
-			++superstack;
-			lua_pop(gL, 2); // pop the name and function
-			break;
-		}
-		lua_pop(gL, 1);
-	}
-	lua_pop(gL, 1); // pop LREG_ACTION
-
 	LUA_PushUserdata(gL, actor, META_MOBJ);
 	lua_pushinteger(gL, var1);
 	lua_pushinteger(gL, var2);
@@ -170,6 +170,50 @@ static void A_Lua(mobj_t *actor)
 		--superstack;
 		superactions[superstack] = NULL;
 	}
+	lua_pop(gL, 1); // pop the name
+}
+
+// Binds the function at stack index idx to a state as an A_Lua action.
+// If name is NULL, the function is looked up in LREG_ACTIONS once here,
+// so A_Lua never has to search for its name when it runs.
+static void SetStateLuaAction(lua_State *L, state_t *st, int idx, const char *name)
+{
+	if (idx < 0)
+		idx = lua_gettop(L) + idx + 1;
+
+	lua_getfield(L, LUA_REGISTRYINDEX, LREG_STATEACTION);
+	I_Assert(lua_istable(L, -1));
+	lua_pushlightuserdata(L, st); // We'll store this function by the state's pointer in the registry.
+	lua_pushvalue(L, idx); // Bring it to the top of the stack
+	lua_rawset(L, -3); // Set it in the registry
+	lua_pop(L, 1); // pop LREG_STATEACTION
+
+	lua_getfield(L, LUA_REGISTRYINDEX, LREG_STATEACTIONNAME);
+	I_Assert(lua_istable(L, -1));
+	lua_pushlightuserdata(L, st);
+	if (name)
+		lua_pushstring(L, name);
+	else
+	{
+		lua_pushnil(L); // stays nil if this isn't a named action.
+		lua_getfield(L, LUA_REGISTRYINDEX, LREG_ACTIONS);
+		lua_pushnil(L);
+		while (lua_next(L, -2))
+		{
+			if (lua_rawequal(L, -1, idx))
+			{
+				lua_pop(L, 1); // pop the function
+				lua_replace(L, -3); // the name replaces the nil
+				break;
+			}
+			lua_pop(L, 1);
+		}
+		lua_pop(L, 1); // pop LREG_ACTIONS
+	}
+	lua_rawset(L, -3);
+	lua_pop(L, 1); // pop LREG_STATEACTIONNAME
+
+	st->action.acp1 = (actionf_p1)A_Lua; // Set the action for the userdata.
 }
 
 // Arbitrary states[] table index -> state_t *
@@ -236,13 +280,7 @@ static int lib_setState(lua_State *L)
 				LUA_SetActionByName(state, lua_tostring(L, 3));
 				break;
 			case LUA_TFUNCTION: // It's a function (a Lua function or a C function? either way!)
-				lua_getfield(L, LUA_REGISTRYINDEX, LREG_STATEACTION);
-				I_Assert(lua_istable(L, -1));
-				lua_pushlightuserdata(L, state); // We'll store this function by the state's pointer in the registry.
-				lua_pushvalue(L, 3); // Bring it to the top of the stack
-				lua_rawset(L, -3); // Set it in the registry
-				lua_pop(L, 1); // pop LREG_STATEACTION
-				state->action.acp1 = (actionf_p1)A_Lua; // Set the action for the userdata.
+				SetStateLuaAction(L, state, 3, NULL);
 				break;
 			default: // ?!
 				return luaL_typerror(L, 3, "function");
@@ -292,15 +330,8 @@ boolean LUA_SetLuaAction(void *stv, const char *action)
 		return false; // action not set.
 	}
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_STATEACTION);
-	I_Assert(lua_istable(gL, -1));
-	lua_pushlightuserdata(gL, stv); // We'll store this function by the state's pointer in the registry.
-	lua_pushvalue(gL, -3); // Bring it to the top of the stack
-	lua_rawset(gL, -3); // Set it in the registry
-	lua_pop(gL, 1); // pop LREG_STATEACTION
-
+	SetStateLuaAction(gL, st, -1, action); // the name is already known here.
 	lua_pop(gL, 2); // pop the function and LREG_ACTIONS
-	st->action.acp1 = (actionf_p1)A_Lua; // Set the action for the userdata.
 	return true; // action successfully set.
 }
 
@@ -431,13 +462,7 @@ static int state_set(lua_State *L)
 			LUA_SetActionByName(st, lua_tostring(L, 3));
 			break;
 		case LUA_TFUNCTION: // It's a function (a Lua function or a C function? either way!)
-			lua_getfield(L, LUA_REGISTRYINDEX, LREG_STATEACTION);
-			I_Assert(lua_istable(L, -1));
-			lua_pushlightuserdata(L, st); // We'll store this function by the state's pointer in the registry.
-			lua_pushvalue(L, 3); // Bring it to the top of the stack
-			lua_rawset(L, -3); // Set it in the registry
-			lua_pop(L, 1); // pop LREG_STATEACTION
-			st->action.acp1 = (actionf_p1)A_Lua; // Set the action for the userdata.
+			SetStateLuaAction(L, st, 3, NULL);
 			break;
 		default: // ?!
 			return luaL_typerror(L, 3, "function");
@@ -585,64 +610,147 @@ static int lib_mobjinfolen(lua_State *L)
 	return 1;
 }
 
+// Fields of mobjinfo_t, by name for Lua
+enum mobjinfo_e {
+	mobjinfo_doomednum = 0,
+	mobjinfo_spawnstate,
+	mobjinfo_spawnhealth,
+	mobjinfo_seestate,
+	mobjinfo_seesound,
+	mobjinfo_reactiontime,
+	mobjinfo_attacksound,
+	mobjinfo_painstate,
+	mobjinfo_painchance,
+	mobjinfo_painsound,
+	mobjinfo_meleestate,
+	mobjinfo_missilestate,
+	mobjinfo_deathstate,
+	mobjinfo_xdeathstate,
+	mobjinfo_deathsound,
+	mobjinfo_speed,
+	mobjinfo_radius,
+	mobjinfo_height,
+	mobjinfo_dispoffset,
+	mobjinfo_mass,
+	mobjinfo_damage,
+	mobjinfo_activesound,
+	mobjinfo_flags,
+	mobjinfo_raisestate
+};
+
+static const char *const mobjinfo_opt[] = {
+	"doomednum",
+	"spawnstate",
+	"spawnhealth",
+	"seestate",
+	"seesound",
+	"reactiontime",
+	"attacksound",
+	"painstate",
+	"painchance",
+	"painsound",
+	"meleestate",
+	"missilestate",
+	"deathstate",
+	"xdeathstate",
+	"deathsound",
+	"speed",
+	"radius",
+	"height",
+	"dispoffset",
+	"mass",
+	"damage",
+	"activesound",
+	"flags",
+	"raisestate",
+	NULL};
+static int mobjinfo_fields_ref = LUA_NOREF;
+
 // mobjinfo_t *, field -> number
 static int mobjinfo_get(lua_State *L)
 {
 	mobjinfo_t *info = *((mobjinfo_t **)luaL_checkudata(L, 1, META_MOBJINFO));
 	const char *field = luaL_checkstring(L, 2);
+	enum mobjinfo_e fieldid = Lua_optfield(L, 2, NULL, mobjinfo_fields_ref);
 
 	I_Assert(info != NULL);
 	I_Assert(info >= mobjinfo);
 
-	if (fastcmp(field,"doomednum"))
+	switch (fieldid)
+	{
+	case mobjinfo_doomednum:
 		lua_pushinteger(L, info->doomednum);
-	else if (fastcmp(field,"spawnstate"))
+		break;
+	case mobjinfo_spawnstate:
 		lua_pushinteger(L, info->spawnstate);
-	else if (fastcmp(field,"spawnhealth"))
+		break;
+	case mobjinfo_spawnhealth:
 		lua_pushinteger(L, info->spawnhealth);
-	else if (fastcmp(field,"seestate"))
+		break;
+	case mobjinfo_seestate:
 		lua_pushinteger(L, info->seestate);
-	else if (fastcmp(field,"seesound"))
+		break;
+	case mobjinfo_seesound:
 		lua_pushinteger(L, info->seesound);
-	else if (fastcmp(field,"reactiontime"))
+		break;
+	case mobjinfo_reactiontime:
 		lua_pushinteger(L, info->reactiontime);
-	else if (fastcmp(field,"attacksound"))
+		break;
+	case mobjinfo_attacksound:
 		lua_pushinteger(L, info->attacksound);
-	else if (fastcmp(field,"painstate"))
+		break;
+	case mobjinfo_painstate:
 		lua_pushinteger(L, info->painstate);
-	else if (fastcmp(field,"painchance"))
+		break;
+	case mobjinfo_painchance:
 		lua_pushinteger(L, info->painchance);
-	else if (fastcmp(field,"painsound"))
+		break;
+	case mobjinfo_painsound:
 		lua_pushinteger(L, info->painsound);
-	else if (fastcmp(field,"meleestate"))
+		break;
+	case mobjinfo_meleestate:
 		lua_pushinteger(L, info->meleestate);
-	else if (fastcmp(field,"missilestate"))
+		break;
+	case mobjinfo_missilestate:
 		lua_pushinteger(L, info->missilestate);
-	else if (fastcmp(field,"deathstate"))
+		break;
+	case mobjinfo_deathstate:
 		lua_pushinteger(L, info->deathstate);
-	else if (fastcmp(field,"xdeathstate"))
+		break;
+	case mobjinfo_xdeathstate:
 		lua_pushinteger(L, info->xdeathstate);
-	else if (fastcmp(field,"deathsound"))
+		break;
+	case mobjinfo_deathsound:
 		lua_pushinteger(L, info->deathsound);
-	else if (fastcmp(field,"speed"))
+		break;
+	case mobjinfo_speed:
 		lua_pushinteger(L, info->speed); // sometimes it's fixed_t, sometimes it's not...
-	else if (fastcmp(field,"radius"))
+		break;
+	case mobjinfo_radius:
 		lua_pushfixed(L, info->radius);
-	else if (fastcmp(field,"height"))
+		break;
+	case mobjinfo_height:
 		lua_pushfixed(L, info->height);
-	else if (fastcmp(field,"dispoffset"))
+		break;
+	case mobjinfo_dispoffset:
 		lua_pushinteger(L, info->dispoffset);
-	else if (fastcmp(field,"mass"))
+		break;
+	case mobjinfo_mass:
 		lua_pushinteger(L, info->mass);
-	else if (fastcmp(field,"damage"))
+		break;
+	case mobjinfo_damage:
 		lua_pushinteger(L, info->damage);
-	else if (fastcmp(field,"activesound"))
+		break;
+	case mobjinfo_activesound:
 		lua_pushinteger(L, info->activesound);
-	else if (fastcmp(field,"flags"))
+		break;
+	case mobjinfo_flags:
 		lua_pushinteger(L, info->flags);
-	else if (fastcmp(field,"raisestate"))
+		break;
+	case mobjinfo_raisestate:
 		lua_pushinteger(L, info->raisestate);
-	else {
+		break;
+	default:
 		lua_getfield(L, LUA_REGISTRYINDEX, LREG_EXTVARS);
 		I_Assert(lua_istable(L, -1));
 		lua_pushlightuserdata(L, info);
@@ -654,6 +762,7 @@ static int mobjinfo_get(lua_State *L)
 		lua_getfield(L, -1, field);
 		if (lua_isnil(L, -1)) // no value for this field
 			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "mobjinfo_t", field);
+		break;
 	}
 	return 1;
 }
@@ -663,6 +772,7 @@ static int mobjinfo_set(lua_State *L)
 {
 	mobjinfo_t *info = *((mobjinfo_t **)luaL_checkudata(L, 1, META_MOBJINFO));
 	const char *field = luaL_checkstring(L, 2);
+	enum mobjinfo_e fieldid = Lua_optfield(L, 2, NULL, mobjinfo_fields_ref);
 
 	if (hud_running)
 		return luaL_error(L, "Do not alter mobjinfo in HUD rendering code!");
@@ -670,55 +780,81 @@ static int mobjinfo_set(lua_State *L)
 	I_Assert(info != NULL);
 	I_Assert(info >= mobjinfo);
 
-	if (fastcmp(field,"doomednum"))
+	switch (fieldid)
+	{
+	case mobjinfo_doomednum:
 		info->doomednum = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spawnstate"))
+		break;
+	case mobjinfo_spawnstate:
 		info->spawnstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spawnhealth"))
+		break;
+	case mobjinfo_spawnhealth:
 		info->spawnhealth = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"seestate"))
+		break;
+	case mobjinfo_seestate:
 		info->seestate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"seesound"))
+		break;
+	case mobjinfo_seesound:
 		info->seesound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"reactiontime"))
+		break;
+	case mobjinfo_reactiontime:
 		info->reactiontime = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"attacksound"))
+		break;
+	case mobjinfo_attacksound:
 		info->attacksound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"painstate"))
+		break;
+	case mobjinfo_painstate:
 		info->painstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"painchance"))
+		break;
+	case mobjinfo_painchance:
 		info->painchance = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"painsound"))
+		break;
+	case mobjinfo_painsound:
 		info->painsound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"meleestate"))
+		break;
+	case mobjinfo_meleestate:
 		info->meleestate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"missilestate"))
+		break;
+	case mobjinfo_missilestate:
 		info->missilestate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"deathstate"))
+		break;
+	case mobjinfo_deathstate:
 		info->deathstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"xdeathstate"))
+		break;
+	case mobjinfo_xdeathstate:
 		info->xdeathstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"deathsound"))
+		break;
+	case mobjinfo_deathsound:
 		info->deathsound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"speed"))
+		break;
+	case mobjinfo_speed:
 		info->speed = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"radius"))
+		break;
+	case mobjinfo_radius:
 		info->radius = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"height"))
+		break;
+	case mobjinfo_height:
 		info->height = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"dispoffset"))
+		break;
+	case mobjinfo_dispoffset:
 		info->dispoffset = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"mass"))
+		break;
+	case mobjinfo_mass:
 		info->mass = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"damage"))
+		break;
+	case mobjinfo_damage:
 		info->damage = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"activesound"))
+		break;
+	case mobjinfo_activesound:
 		info->activesound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flags"))
+		break;
+	case mobjinfo_flags:
 		info->flags = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"raisestate"))
+		break;
+	case mobjinfo_raisestate:
 		info->raisestate = luaL_checkinteger(L, 3);
-	else {
+		break;
+	default:
 		lua_getfield(L, LUA_REGISTRYINDEX, LREG_EXTVARS);
 		I_Assert(lua_istable(L, -1));
 		lua_pushlightuserdata(L, info);
@@ -735,6 +871,7 @@ static int mobjinfo_set(lua_State *L)
 		lua_pushvalue(L, 3); // value to store
 		lua_setfield(L, -2, field);
 		lua_pop(L, 2);
+		break;
 	}
 	//else
 		//return luaL_error(L, LUA_QL("mobjinfo_t") " has no field named " LUA_QS, field);
@@ -796,7 +933,7 @@ static int lib_setSfxInfo(lua_State *L)
 		if (lua_isnumber(L, 2))
 			i = lua_tointeger(L, 2) - 1; // lua is one based, this enum is zero based.
 		else
-			i = luaL_checkoption(L, 2, NULL, sfxinfo_wopt);
+			i = Lua_checkfield(L, 2, NULL, sfxinfo_wfields_ref);
 
 		switch(i)
 		{
@@ -828,7 +965,7 @@ static int lib_sfxlen(lua_State *L)
 static int sfxinfo_get(lua_State *L)
 {
 	sfxinfo_t *sfx = *((sfxinfo_t **)luaL_checkudata(L, 1, META_SFXINFO));
-	enum sfxinfo_read field = luaL_checkoption(L, 2, NULL, sfxinfo_ropt);
+	enum sfxinfo_read field = Lua_checkfield(L, 2, NULL, sfxinfo_rfields_ref);
 
 	I_Assert(sfx != NULL);
 
@@ -859,7 +996,7 @@ static int sfxinfo_get(lua_State *L)
 static int sfxinfo_set(lua_State *L)
 {
 	sfxinfo_t *sfx = *((sfxinfo_t **)luaL_checkudata(L, 1, META_SFXINFO));
-	enum sfxinfo_write field = luaL_checkoption(L, 2, NULL, sfxinfo_wopt);
+	enum sfxinfo_write field = Lua_checkfield(L, 2, NULL, sfxinfo_wfields_ref);
 
 	if (hud_running)
 		return luaL_error(L, "Do not alter S_sfx in HUD rendering code!");
@@ -906,10 +1043,19 @@ static int sfxinfo_num(lua_State *L)
 //
 int LUA_InfoLib(lua_State *L)
 {
+	mobjinfo_fields_ref = Lua_CreateFieldTable(L, mobjinfo_opt);
+
+	sfxinfo_rfields_ref = Lua_CreateFieldTable(L, sfxinfo_ropt);
+	sfxinfo_wfields_ref = Lua_CreateFieldTable(L, sfxinfo_wopt);
+
 	// index of A_Lua actions to run for each state
 	lua_newtable(L);
 	lua_setfield(L, LUA_REGISTRYINDEX, LREG_STATEACTION);
 
+	// index of the action names bound to each state, for superactions
+	lua_newtable(L);
+	lua_setfield(L, LUA_REGISTRYINDEX, LREG_STATEACTIONNAME);
+
 	// index of globally available Lua actions by function name
 	lua_newtable(L);
 	lua_setfield(L, LUA_REGISTRYINDEX, LREG_ACTIONS);
@@ -17,6 +17,7 @@ extern lua_State *gL;
 #define LREG_VALID "VALID_USERDATA"
 #define LREG_EXTVARS "LUA_VARS"
 #define LREG_STATEACTION "STATE_ACTION"
+#define LREG_STATEACTIONNAME "STATE_ACTION_NAME"
 #define LREG_ACTIONS "MOBJ_ACTION"
 
 #define META_STATE "STATE_T*"
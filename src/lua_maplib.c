@@ -82,6 +82,7 @@ static const char *const sector_opt[] = {
 	"c_slope",
 #endif
 	NULL};
+static int sector_fields_ref = LUA_NOREF;
 
 enum subsector_e {
 	subsector_valid = 0,
@@ -96,6 +97,7 @@ static const char *const subsector_opt[] = {
 	"numlines",
 	"firstline",
 	NULL};
+static int subsector_fields_ref = LUA_NOREF;
 
 enum line_e {
 	line_valid = 0,
@@ -138,6 +140,7 @@ static const char *const line_opt[] = {
 	"text",
 	"callcount",
 	NULL};
+static int line_fields_ref = LUA_NOREF;
 
 enum side_e {
 	side_valid = 0,
@@ -164,6 +167,7 @@ static const char *const side_opt[] = {
 	"repeatcnt",
 	"text",
 	NULL};
+static int side_fields_ref = LUA_NOREF;
 
 enum vertex_e {
 	vertex_valid = 0,
@@ -178,6 +182,7 @@ static const char *const vertex_opt[] = {
 	"y",
 	"z",
 	NULL};
+static int vertex_fields_ref = LUA_NOREF;
 
 enum ffloor_e {
 	ffloor_valid = 0,
@@ -230,6 +235,7 @@ static const char *const ffloor_opt[] = {
 	"prev",
 	"alpha",
 	NULL};
+static int ffloor_fields_ref = LUA_NOREF;
 
 #ifdef ESLOPE
 enum slope_e {
@@ -257,6 +263,7 @@ static const char *const slope_opt[] = {
 	"refpos",
 	"flags",
 	NULL};
+static int slope_fields_ref = LUA_NOREF;
 
 // shared by both vector2_t and vector3_t
 enum vector_e {
@@ -270,6 +277,7 @@ static const char *const vector_opt[] = {
 	"y",
 	"z",
 	NULL};
+static int vector_fields_ref = LUA_NOREF;
 #endif
 
 static const char *const array_opt[] ={"iterate",NULL};
@@ -413,7 +421,7 @@ static int sectorlines_num(lua_State *L)
 static int sector_get(lua_State *L)
 {
 	sector_t *sector = *((sector_t **)luaL_checkudata(L, 1, META_SECTOR));
-	enum sector_e field = luaL_checkoption(L, 2, sector_opt[0], sector_opt);
+	enum sector_e field = Lua_checkfield(L, 2, sector_opt[0], sector_fields_ref);
 	INT16 i;
 
 	if (!sector)
@@ -519,7 +527,7 @@ static int sector_get(lua_State *L)
 static int sector_set(lua_State *L)
 {
 	sector_t *sector = *((sector_t **)luaL_checkudata(L, 1, META_SECTOR));
-	enum sector_e field = luaL_checkoption(L, 2, sector_opt[0], sector_opt);
+	enum sector_e field = Lua_checkfield(L, 2, sector_opt[0], sector_fields_ref);
 
 	if (!sector)
 		return luaL_error(L, "accessed sector_t doesn't exist anymore.");
@@ -615,7 +623,7 @@ static int sector_num(lua_State *L)
 static int subsector_get(lua_State *L)
 {
 	subsector_t *subsector = *((subsector_t **)luaL_checkudata(L, 1, META_SUBSECTOR));
-	enum subsector_e field = luaL_checkoption(L, 2, subsector_opt[0], subsector_opt);
+	enum subsector_e field = Lua_checkfield(L, 2, subsector_opt[0], subsector_fields_ref);
 
 	if (!subsector)
 	{
@@ -654,7 +662,7 @@ static int subsector_num(lua_State *L)
 static int line_get(lua_State *L)
 {
 	line_t *line = *((line_t **)luaL_checkudata(L, 1, META_LINE));
-	enum line_e field = luaL_checkoption(L, 2, line_opt[0], line_opt);
+	enum line_e field = Lua_checkfield(L, 2, line_opt[0], line_fields_ref);
 
 	if (!line)
 	{
@@ -779,7 +787,7 @@ static int sidenum_get(lua_State *L)
 static int side_get(lua_State *L)
 {
 	side_t *side = *((side_t **)luaL_checkudata(L, 1, META_SIDE));
-	enum side_e field = luaL_checkoption(L, 2, side_opt[0], side_opt);
+	enum side_e field = Lua_checkfield(L, 2, side_opt[0], side_fields_ref);
 
 	if (!side)
 	{
@@ -829,7 +837,7 @@ static int side_get(lua_State *L)
 static int side_set(lua_State *L)
 {
 	side_t *side = *((side_t **)luaL_checkudata(L, 1, META_SIDE));
-	enum side_e field = luaL_checkoption(L, 2, side_opt[0], side_opt);
+	enum side_e field = Lua_checkfield(L, 2, side_opt[0], side_fields_ref);
 
 	if (!side)
 	{
@@ -880,7 +888,7 @@ static int side_num(lua_State *L)
 static int vertex_get(lua_State *L)
 {
 	vertex_t *vertex = *((vertex_t **)luaL_checkudata(L, 1, META_VERTEX));
-	enum vertex_e field = luaL_checkoption(L, 2, vertex_opt[0], vertex_opt);
+	enum vertex_e field = Lua_checkfield(L, 2, vertex_opt[0], vertex_fields_ref);
 
 	if (!vertex)
 	{
@@ -1149,7 +1157,7 @@ static int lib_numvertexes(lua_State *L)
 static int ffloor_get(lua_State *L)
 {
 	ffloor_t *ffloor = *((ffloor_t **)luaL_checkudata(L, 1, META_FFLOOR));
-	enum ffloor_e field = luaL_checkoption(L, 2, ffloor_opt[0], ffloor_opt);
+	enum ffloor_e field = Lua_checkfield(L, 2, ffloor_opt[0], ffloor_fields_ref);
 	INT16 i;
 
 	if (!ffloor)
@@ -1245,7 +1253,7 @@ static int ffloor_get(lua_State *L)
 static int ffloor_set(lua_State *L)
 {
 	ffloor_t *ffloor = *((ffloor_t **)luaL_checkudata(L, 1, META_FFLOOR));
-	enum ffloor_e field = luaL_checkoption(L, 2, ffloor_opt[0], ffloor_opt);
+	enum ffloor_e field = Lua_checkfield(L, 2, ffloor_opt[0], ffloor_fields_ref);
 
 	if (!ffloor)
 		return luaL_error(L, "accessed ffloor_t doesn't exist anymore.");
@@ -1324,7 +1332,7 @@ static int ffloor_set(lua_State *L)
 static int slope_get(lua_State *L)
 {
 	pslope_t *slope = *((pslope_t **)luaL_checkudata(L, 1, META_SLOPE));
-	enum slope_e field = luaL_checkoption(L, 2, slope_opt[0], slope_opt);
+	enum slope_e field = Lua_checkfield(L, 2, slope_opt[0], slope_fields_ref);
 
 	if (!slope)
 	{
@@ -1374,7 +1382,7 @@ static int slope_get(lua_State *L)
 static int slope_set(lua_State *L)
 {
 	pslope_t *slope = *((pslope_t **)luaL_checkudata(L, 1, META_SLOPE));
-	enum slope_e field = luaL_checkoption(L, 2, slope_opt[0], slope_opt);
+	enum slope_e field = Lua_checkfield(L, 2, slope_opt[0], slope_fields_ref);
 
 	if (!slope)
 		return luaL_error(L, "accessed pslope_t doesn't exist anymore.");
@@ -1460,7 +1468,7 @@ static int slope_set(lua_State *L)
 static int vector2_get(lua_State *L)
 {
 	vector2_t *vec = *((vector2_t **)luaL_checkudata(L, 1, META_VECTOR2));
-	enum vector_e field = luaL_checkoption(L, 2, vector_opt[0], vector_opt);
+	enum vector_e field = Lua_checkfield(L, 2, vector_opt[0], vector_fields_ref);
 
 	if (!vec)
 		return luaL_error(L, "accessed vector2_t doesn't exist anymore.");
@@ -1478,7 +1486,7 @@ static int vector2_get(lua_State *L)
 static int vector3_get(lua_State *L)
 {
 	vector3_t *vec = *((vector3_t **)luaL_checkudata(L, 1, META_VECTOR3));
-	enum vector_e field = luaL_checkoption(L, 2, vector_opt[0], vector_opt);
+	enum vector_e field = Lua_checkfield(L, 2, vector_opt[0], vector_fields_ref);
 
 	if (!vec)
 		return luaL_error(L, "accessed vector3_t doesn't exist anymore.");
@@ -1612,6 +1620,17 @@ static int mapheaderinfo_get(lua_State *L)
 
 int LUA_MapLib(lua_State *L)
 {
+	sector_fields_ref = Lua_CreateFieldTable(L, sector_opt);
+	subsector_fields_ref = Lua_CreateFieldTable(L, subsector_opt);
+	line_fields_ref = Lua_CreateFieldTable(L, line_opt);
+	side_fields_ref = Lua_CreateFieldTable(L, side_opt);
+	vertex_fields_ref = Lua_CreateFieldTable(L, vertex_opt);
+	ffloor_fields_ref = Lua_CreateFieldTable(L, ffloor_opt);
+#ifdef ESLOPE
+	slope_fields_ref = Lua_CreateFieldTable(L, slope_opt);
+	vector_fields_ref = Lua_CreateFieldTable(L, vector_opt);
+#endif
+
 	luaL_newmetatable(L, META_SECTORLINES);
 		lua_pushcfunction(L, sectorlines_get);
 		lua_setfield(L, -2, "__index");
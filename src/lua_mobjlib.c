@@ -149,13 +149,14 @@ static const char *const mobj_opt[] = {
 	"standingslope",
 #endif
 	NULL};
+static int mobj_fields_ref = LUA_NOREF;
 
 #define UNIMPLEMENTED luaL_error(L, LUA_QL("mobj_t") " field " LUA_QS " is not implemented for Lua and cannot be accessed.", mobj_opt[field])
 
 static int mobj_get(lua_State *L)
 {
 	mobj_t *mo = *((mobj_t **)luaL_checkudata(L, 1, META_MOBJ));
-	enum mobj_e field = Lua_optoption(L, 2, NULL, mobj_opt);
+	enum mobj_e field = Lua_optfield(L, 2, NULL, mobj_fields_ref);
 	lua_settop(L, 2);
 
 	if (!mo) {
@@ -379,7 +380,7 @@ static int mobj_get(lua_State *L)
 static int mobj_set(lua_State *L)
 {
 	mobj_t *mo = *((mobj_t **)luaL_checkudata(L, 1, META_MOBJ));
-	enum mobj_e field = Lua_optoption(L, 2, mobj_opt[0], mobj_opt);
+	enum mobj_e field = Lua_optfield(L, 2, mobj_opt[0], mobj_fields_ref);
 	lua_settop(L, 3);
 
 	if (!mo)
@@ -544,7 +545,7 @@ static int mobj_set(lua_State *L)
 		mobjtype_t newtype = luaL_checkinteger(L, 3);
 		if (newtype >= NUMMOBJTYPES)
 			return luaL_error(L, "mobj.type %d out of range (0 - %d).", newtype, NUMMOBJTYPES-1);
-		mo->type = newtype;
+		P_SetMobjType(mo, newtype);
 		mo->info = &mobjinfo[newtype];
 		P_SetScale(mo, mo->scale);
 		break;
@@ -805,6 +806,8 @@ static int lib_nummapthings(lua_State *L)
 
 int LUA_MobjLib(lua_State *L)
 {
+	mobj_fields_ref = Lua_CreateFieldTable(L, mobj_opt);
+
 	luaL_newmetatable(L, META_MOBJ);
 		lua_pushcfunction(L, mobj_get);
 		lua_setfield(L, -2, "__index");
@@ -22,6 +22,8 @@
 #include "byteptr.h"
 #include "p_saveg.h"
 #include "p_local.h"
+#include "i_system.h" // I_GetTimeMicros
+#include "m_misc.h" // M_Memcpy
 #ifdef ESLOPE
 #include "p_slopes.h" // for P_SlopeById
 #endif
@@ -56,16 +58,162 @@ static lua_CFunction liblist[] = {
 	NULL
 };
 
+// Time the garbage collector may take at the end of each tic, in microseconds
+consvar_t cv_luagcbudget = {"luagcbudget", "1000", CV_SAVE, CV_Unsigned, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+// Small objects (strings, tables, closures, userdata boxes) are most of
+// what Lua allocates. They come out of an arena of pages split into chunks
+// of one size class each, instead of getting a zone block of their own.
+// Lua always passes the old size of a block, so the chunks need no header.
+#define LUAARENAGRANULARITY 16 // size classes are this many bytes apart
+#define LUAARENAMAXSIZE 512 // bigger blocks go to the zone
+#define NUMLUAARENACLASSES (LUAARENAMAXSIZE/LUAARENAGRANULARITY)
+#define LUAARENAPAGESIZE (16<<10)
+#define LUAARENACLASS(size) ((size) ? ((size)-1)/LUAARENAGRANULARITY : 0)
+#define LUAARENASMALL(size) ((size) <= LUAARENAMAXSIZE)
+
+typedef struct luaarenapage_s
+{
+	struct luaarenapage_s *next; // every page, so they can be freed together
+} luaarenapage_t;
+
+#define LUAARENAPAGEHDR ((sizeof (luaarenapage_t) + 15) & ~(size_t)15)
+
+typedef struct
+{
+	size_t chunksize;
+	UINT8 *freechunk; // free chunks, each starting with a pointer to the next
+	UINT8 *unused, *end; // rest of the newest page, never handed out
+	size_t pages; // pages allocated
+	size_t used, peak; // chunks in use now and at most
+} luaarenaclass_t;
+
+static luaarenaclass_t luaarena[NUMLUAARENACLASSES];
+static luaarenapage_t *luaarenapages = NULL;
+static size_t luaarenaused = 0; // chunks in use in every class
+
+// GC pacing, see LUA_Step
+static UINT64 luagcallocated = 0; // bytes Lua has asked for so far
+static UINT64 luagcpaced = 0; // luagcallocated as of the last LUA_Step
+static size_t luagcdebt = 0; // KB of collection work still owed
+static UINT32 luagcrate = 0; // KB allocated during the last tic
+static UINT32 luagcsteps = 0, luagctime = 0; // steps and microseconds spent by the last LUA_Step
+static UINT32 luagccycles = 0; // collection cycles finished
+static UINT32 luagcoverbudget = 0; // tics that ran out of time with work still owed
+
+static void *LUA_ArenaAlloc(size_t size)
+{
+	luaarenaclass_t *ac = &luaarena[LUAARENACLASS(size)];
+	UINT8 *chunk;
+
+	if (!ac->chunksize)
+		ac->chunksize = (LUAARENACLASS(size)+1)*LUAARENAGRANULARITY;
+
+	if (ac->freechunk)
+	{
+		chunk = ac->freechunk;
+		ac->freechunk = *(UINT8 **)chunk;
+	}
+	else
+	{
+		if ((size_t)(ac->end - ac->unused) < ac->chunksize) // the newest page is used up, start another
+		{
+			luaarenapage_t *page = malloc(LUAARENAPAGESIZE);
+			if (!page)
+				return NULL; // Lua raises a memory error
+			page->next = luaarenapages;
+			luaarenapages = page;
+			ac->unused = (UINT8 *)page + LUAARENAPAGEHDR;
+			ac->end = (UINT8 *)page + LUAARENAPAGESIZE;
+			ac->pages++;
+		}
+		chunk = ac->unused;
+		ac->unused += ac->chunksize;
+	}
+
+	luaarenaused++;
+	if (++ac->used > ac->peak)
+		ac->peak = ac->used;
+	return chunk;
+}
+
+static void LUA_ArenaFree(void *ptr, size_t size)
+{
+	luaarenaclass_t *ac = &luaarena[LUAARENACLASS(size)];
+
+	*(UINT8 **)ptr = ac->freechunk;
+	ac->freechunk = ptr;
+	ac->used--;
+	luaarenaused--;
+}
+
+// Gives the arena's pages back once no Lua state is using them.
+static void LUA_ArenaRelease(void)
+{
+	luaarenapage_t *page, *next;
+	size_t i;
+
+	if (luaarenaused)
+		return;
+
+	for (page = luaarenapages; page; page = next)
+	{
+		next = page->next;
+		free(page);
+	}
+	luaarenapages = NULL;
+
+	for (i = 0; i < NUMLUAARENACLASSES; i++)
+	{
+		luaarena[i].freechunk = luaarena[i].unused = luaarena[i].end = NULL;
+		luaarena[i].pages = 0;
+	}
+}
+
 // Lua asks for memory using this.
 static void *LUA_Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
 {
+	void *newptr;
 	(void)ud;
+
+	if (nsize > osize)
+		luagcallocated += nsize - osize;
+
 	if (nsize == 0) {
-		if (osize != 0)
-			Z_Free(ptr);
+		if (osize != 0) {
+			if (LUAARENASMALL(osize))
+				LUA_ArenaFree(ptr, osize);
+			else
+				Z_Free(ptr);
+		}
 		return NULL;
-	} else
+	}
+
+	if (!LUAARENASMALL(osize) && !LUAARENASMALL(nsize)) // big before and after
 		return Z_Realloc(ptr, nsize, PU_LUA, NULL);
+
+	if (osize && LUAARENASMALL(osize) && LUAARENASMALL(nsize)
+		&& LUAARENACLASS(osize) == LUAARENACLASS(nsize))
+		return ptr; // still fits in its chunk
+
+	if (LUAARENASMALL(nsize))
+	{
+		newptr = LUA_ArenaAlloc(nsize);
+		if (!newptr)
+			return NULL;
+	}
+	else
+		newptr = Z_Malloc(nsize, PU_LUA, NULL);
+
+	if (osize) // moved between size classes, or between the arena and the zone
+	{
+		M_Memcpy(newptr, ptr, min(osize, nsize));
+		if (LUAARENASMALL(osize))
+			LUA_ArenaFree(ptr, osize);
+		else
+			Z_Free(ptr);
+	}
+	return newptr;
 }
 
 // Panic function Lua calls when there's an unprotected error.
@@ -121,6 +269,7 @@ static void LUA_ClearState(void)
 	if (gL)
 		lua_close(gL);
 	gL = NULL;
+	LUA_ArenaRelease();
 
 	CONS_Printf(M_GetText("Pardon me while I initialize the Lua scripting interface...\n"));
 
@@ -328,6 +477,7 @@ fixed_t LUA_EvalMath(const char *word)
 
 	// clean up and return.
 	lua_close(L);
+	LUA_ArenaRelease();
 	return res;
 }
 
@@ -521,6 +671,7 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 {
 	if (myindex < 0)
 		myindex = lua_gettop(gL)+1+myindex;
+	P_SaveReserve(8);
 	switch (lua_type(gL, myindex))
 	{
 	case LUA_TNONE:
@@ -549,6 +700,7 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		UINT16 len = (UINT16)lua_objlen(gL, myindex); // get length of string, including embedded zeros
 		const char *s = lua_tostring(gL, myindex);
 		UINT16 i = 0;
+		P_SaveReserve(3 + len);
 		WRITEUINT8(save_p, ARCH_STRING);
 		// if you're wondering why we're writing a string to save_p this way,
 		// it turns out that Lua can have embedded zeros ('\0') in the strings,
@@ -735,6 +887,7 @@ static void ArchiveExtVars(void *pointer, const char *ptype)
 	int TABLESINDEX;
 	UINT16 i;
 
+	P_SaveReserve(8);
 	if (!gL) {
 		if (fastcmp(ptype,"player")) // players must always be included, even if no vars
 			WRITEUINT16(save_p, 0);
@@ -777,6 +930,7 @@ static void ArchiveExtVars(void *pointer, const char *ptype)
 	while (lua_next(gL, -2))
 	{
 		I_Assert(lua_type(gL, -2) == LUA_TSTRING);
+		P_SaveReserve(lua_objlen(gL, -2) + 1);
 		WRITESTRING(save_p, lua_tostring(gL, -2));
 		if (ArchiveValue(TABLESINDEX, -1) == 2)
 			CONS_Alert(CONS_ERROR, "Type of value for %s entry '%s' (%s) could not be archived!\n", ptype, lua_tostring(gL, -2), luaL_typename(gL, -1));
@@ -835,6 +989,7 @@ static void ArchiveTables(void)
 			lua_pop(gL, 1);
 		}
 		lua_pop(gL, 1);
+		P_SaveReserve(1);
 		WRITEUINT8(save_p, ARCH_TEND);
 	}
 }
@@ -998,12 +1153,79 @@ static void UnArchiveTables(void)
 	}
 }
 
+// Collection work done per lua_gc call while pacing, in KB
+#define LUAGCSTEPKB 8
+
+// Runs the garbage collector at the end of the tic, so it keeps up
+// with the scripts without having to step in while they're running.
+// Each tic owes as much collection work as it allocated, plus whatever
+// the last tics couldn't fit in their time budget.
 void LUA_Step(void)
 {
+	UINT64 start, now;
+
 	if (!gL)
 		return;
 	lua_settop(gL, 0);
-	lua_gc(gL, LUA_GCSTEP, 1);
+
+	luagcrate = (UINT32)((luagcallocated - luagcpaced)>>10);
+	luagcpaced = luagcallocated;
+	luagcdebt += luagcrate;
+	if (!luagcdebt)
+		luagcdebt = 1; // always make a little progress
+
+	luagcsteps = 0;
+	start = now = I_GetTimeMicros();
+	do
+	{
+		size_t step = min(luagcdebt, LUAGCSTEPKB);
+
+		luagcsteps++;
+		if (lua_gc(gL, LUA_GCSTEP, (int)step)) // finished a cycle, nothing else to collect yet
+		{
+			luagccycles++;
+			luagcdebt = 0;
+			break;
+		}
+		luagcdebt -= step;
+		now = I_GetTimeMicros();
+	} while (luagcdebt && now - start < (UINT32)cv_luagcbudget.value);
+
+	if (luagcdebt)
+		luagcoverbudget++;
+	luagctime = (UINT32)(I_GetTimeMicros() - start);
+}
+
+// Prints memory and garbage collector stats for the Lua state.
+void Command_LuaGC_f(void)
+{
+	size_t i;
+	luaarenaclass_t *ac;
+
+	if (!gL)
+	{
+		CONS_Printf(M_GetText("Lua isn't loaded.\n"));
+		return;
+	}
+
+	CONS_Printf("\x82%s", M_GetText("Lua Memory Info\n"));
+	CONS_Printf(M_GetText("Total in use      : %7d KB\n"), lua_gc(gL, LUA_GCCOUNT, 0));
+	CONS_Printf(M_GetText("Big blocks (zone) : %7s KB\n"), sizeu1(Z_TagUsage(PU_LUA)>>10));
+	for (i = 0, ac = luaarena; i < NUMLUAARENACLASSES; i++, ac++)
+	{
+		if (!ac->pages && !ac->peak)
+			continue;
+		CONS_Printf(M_GetText("%4s bytes: %6s used, %6s peak, %7s KB\n"),
+			sizeu1((i+1)*LUAARENAGRANULARITY), sizeu2(ac->used), sizeu3(ac->peak),
+			sizeu4((ac->pages*LUAARENAPAGESIZE)>>10));
+	}
+
+	CONS_Printf("\x82%s", M_GetText("Lua Garbage Collector Info\n"));
+	CONS_Printf(M_GetText("Allocated last tic: %7u KB\n"), luagcrate);
+	CONS_Printf(M_GetText("Work still owed   : %7s KB\n"), sizeu1(luagcdebt));
+	CONS_Printf(M_GetText("Last step         : %7u us, %u steps (budget %d us)\n"), luagctime, luagcsteps, cv_luagcbudget.value);
+	CONS_Printf(M_GetText("Cycles finished   : %7u\n"), luagccycles);
+	CONS_Printf(M_GetText("Tics over budget  : %7u\n"), luagcoverbudget);
 }
 
 void LUA_Archive(void)
@@ -1042,7 +1264,7 @@ void LUA_UnArchive(void)
 {
 	UINT32 mobjnum;
 	INT32 i;
-	thinker_t *th;
+	mobj_t *mobj;
 
 	if (gL)
 		lua_newtable(gL); // tables to be read
@@ -1056,10 +1278,9 @@ void LUA_UnArchive(void)
 
 	do {
 		mobjnum = READUINT32(save_p); // read a mobjnum
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
-			if (th->function.acp1 == (actionf_p1)P_MobjThinker
-			&& ((mobj_t *)th)->mobjnum == mobjnum) // find matching mobj
-				UnArchiveExtVars(th); // apply variables
+		if (mobjnum != UINT32_MAX
+		&& (mobj = P_FindNewPosition(mobjnum)) != NULL) // find matching mobj
+			UnArchiveExtVars(mobj); // apply variables
 	} while(mobjnum != UINT32_MAX); // repeat until end of mobjs marker.
 
 	LUAh_NetArchiveHook(NetUnArchive); // call the NetArchive hook in unarchive mode
@@ -1081,4 +1302,60 @@ int Lua_optoption(lua_State *L, int narg,
 	return -1;
 }
 
+// Makes a table of the names in a NULL-terminated option list, each
+// mapped to its index, for Lua_optfield and Lua_checkfield.
+// Returns its reference in the registry.
+int Lua_CreateFieldTable(lua_State *L, const char *const lst[])
+{
+	int i;
+
+	for (i = 0; lst[i]; i++)
+		;
+	lua_createtable(L, 0, i);
+	// last to first, so that a repeated name still gets its first index
+	while (i--)
+	{
+		lua_pushinteger(L, i);
+		lua_setfield(L, -2, lst[i]);
+	}
+	return luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+// Same as Lua_optoption, but with the field table made from the option
+// list. The name is an interned string already, so this is a single
+// table lookup rather than a compare against every option in turn.
+int Lua_optfield(lua_State *L, int narg, const char *def, int ref)
+{
+	int i = -1;
+
+	if (def && lua_isnoneornil(L, narg))
+	{
+		lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+		lua_getfield(L, -1, def);
+	}
+	else
+	{
+		luaL_checkstring(L, narg);
+		lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+		lua_pushvalue(L, narg);
+		lua_rawget(L, -2);
+	}
+	if (lua_isnumber(L, -1))
+		i = (int)lua_tointeger(L, -1);
+	lua_pop(L, 2);
+	return i;
+}
+
+// Same as luaL_checkoption, but with the field table made from the
+// option list, see Lua_optfield.
+int Lua_checkfield(lua_State *L, int narg, const char *def, int ref)
+{
+	int i = Lua_optfield(L, narg, def, ref);
+
+	if (i == -1)
+		return luaL_argerror(L, narg, lua_pushfstring(L, "invalid option " LUA_QS,
+			(def && lua_isnoneornil(L, narg)) ? def : lua_tostring(L, narg)));
+	return i;
+}
+
 #endif // HAVE_BLUA
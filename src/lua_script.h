@@ -15,6 +15,7 @@
 #include "m_fixed.h"
 #include "doomtype.h"
 #include "d_player.h"
+#include "command.h"
 
 #include "blua/lua.h"
 #include "blua/lualib.h"
@@ -49,12 +50,17 @@ void LUA_InvalidateLevel(void);
 void LUA_InvalidateMapthings(void);
 void LUA_InvalidatePlayer(player_t *player);
 void LUA_Step(void);
+void Command_LuaGC_f(void);
+extern consvar_t cv_luagcbudget;
 void LUA_Archive(void);
 void LUA_UnArchive(void);
 void Got_Luacmd(UINT8 **cp, INT32 playernum); // lua_consolelib.c
 void LUA_CVarChanged(const char *name); // lua_consolelib.c
 int Lua_optoption(lua_State *L, int narg,
 	const char *def, const char *const lst[]);
+int Lua_CreateFieldTable(lua_State *L, const char *const lst[]);
+int Lua_optfield(lua_State *L, int narg, const char *def, int ref);
+int Lua_checkfield(lua_State *L, int narg, const char *def, int ref);
 void LUAh_NetArchiveHook(lua_CFunction archFunc);
 
 // Console wrapper
@@ -79,13 +79,14 @@ static const char *const skin_opt[] = {
 	"highresscale",
 	"soundsid",
 	NULL};
+static int skin_fields_ref = LUA_NOREF;
 
 #define UNIMPLEMENTED luaL_error(L, LUA_QL("skin_t") " field " LUA_QS " is not implemented for Lua and cannot be accessed.", skin_opt[field])
 
 static int skin_get(lua_State *L)
 {
 	skin_t *skin = *((skin_t **)luaL_checkudata(L, 1, META_SKIN));
-	enum skin field = luaL_checkoption(L, 2, NULL, skin_opt);
+	enum skin field = Lua_checkfield(L, 2, NULL, skin_fields_ref);
 	INT32 i;
 
 	// skins are always valid, only added, never removed
@@ -297,6 +298,8 @@ static int soundsid_num(lua_State *L)
 
 int LUA_SkinLib(lua_State *L)
 {
+	skin_fields_ref = Lua_CreateFieldTable(L, skin_opt);
+
 	luaL_newmetatable(L, META_SKIN);
 		lua_pushcfunction(L, skin_get);
 		lua_setfield(L, -2, "__index");
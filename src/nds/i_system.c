@@ -24,6 +24,12 @@ tic_t I_GetTime(void)
 	return ticcount;
 }
 
+// No finer timer here, so profiling only gets tic resolution.
+UINT64 I_GetTimeMicros(void)
+{
+	return (UINT64)ticcount * 1000000 / TICRATE;
+}
+
 void I_Sleep(void){}
 
 void I_GetEvent(void)
@@ -2570,7 +2570,7 @@ void A_MonitorPop(mobj_t *actor)
 	remains = P_SpawnMobj(actor->x, actor->y,
 		((actor->eflags & MFE_VERTICALFLIP) ? (actor->z + actor->height - FixedMul(mobjinfo[actor->info->speed].height, actor->scale)) : actor->z),
 		actor->info->speed);
-	remains->type = actor->type; // Transfer type information
+	P_SetMobjType(remains, actor->type); // Transfer type information
 	P_UnsetThingPosition(remains);
 	if (sector_list)
 	{
@@ -2783,23 +2783,18 @@ bossjustdie:
 		P_SetTarget(&mo->target, NULL);
 
 		// Flee! Flee! Find a point to escape to! If none, just shoot upward!
-		// scan the thinkers to find the runaway point
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		// scan the fly points to find the runaway point
+		for (mo2 = mobjtypelist[MT_BOSSFLYPOINT]; mo2; mo2 = mo2->tnext)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+			if (P_MobjWasRemoved(mo2))
 				continue;
 
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type == MT_BOSSFLYPOINT)
-			{
-				// If this one's closer then the last one, go for it.
-				if (!mo->target ||
-					P_AproxDistance(P_AproxDistance(mo->x - mo2->x, mo->y - mo2->y), mo->z - mo2->z) <
-					P_AproxDistance(P_AproxDistance(mo->x - mo->target->x, mo->y - mo->target->y), mo->z - mo->target->z))
-						P_SetTarget(&mo->target, mo2);
-				// Otherwise... Don't!
-			}
+			// If this one's closer then the last one, go for it.
+			if (!mo->target ||
+				P_AproxDistance(P_AproxDistance(mo->x - mo2->x, mo->y - mo2->y), mo->z - mo2->z) <
+				P_AproxDistance(P_AproxDistance(mo->x - mo->target->x, mo->y - mo->target->y), mo->z - mo->target->z))
+					P_SetTarget(&mo->target, mo2);
+			// Otherwise... Don't!
 		}
 
 		mo->flags |= MF_NOGRAVITY|MF_NOCLIP;
@@ -6881,23 +6876,21 @@ void A_Boss3Path(mobj_t *actor)
 	}
 	else if (actor->threshold >= 0) // Traveling mode
 	{
-		thinker_t *th;
 		mobj_t *mo2;
 		fixed_t dist, dist2;
 		fixed_t speed;
 
 		P_SetTarget(&actor->target, NULL);
 
-		// scan the thinkers
+		// scan the waypoints
 		// to find a point that matches
 		// the number
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (mo2 = mobjtypelist[MT_BOSS3WAYPOINT]; mo2; mo2 = mo2->tnext)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+			if (P_MobjWasRemoved(mo2))
 				continue;
 
-			mo2 = (mobj_t *)th;
-			if (mo2->type == MT_BOSS3WAYPOINT && mo2->spawnpoint && mo2->spawnpoint->angle == actor->threshold)
+			if (mo2->spawnpoint && mo2->spawnpoint->angle == actor->threshold)
 			{
 				P_SetTarget(&actor->target, mo2);
 				break;
@@ -7270,7 +7263,6 @@ void A_FindTarget(mobj_t *actor)
 	INT32 locvar1 = var1;
 	INT32 locvar2 = var2;
 	mobj_t *targetedmobj = NULL;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist1 = 0, dist2 = 0;
 #ifdef HAVE_BLUA
@@ -7280,34 +7272,29 @@ void A_FindTarget(mobj_t *actor)
 
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTarget called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
-	// scan the thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the mobjs of that type
+	for (mo2 = P_FirstMobjOfType(locvar1); mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)locvar1)
+		if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
+			continue; // Ignore spectators
+		if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
+			continue; // Ignore dead things
+		if (targetedmobj == NULL)
 		{
-			if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
-				continue; // Ignore spectators
-			if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
-				continue; // Ignore dead things
-			if (targetedmobj == NULL)
+			targetedmobj = mo2;
+			dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+		}
+		else
+		{
+			dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+			if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
 			{
 				targetedmobj = mo2;
-				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-			}
-			else
-			{
-				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-				if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
-				{
-					targetedmobj = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -7335,7 +7322,6 @@ void A_FindTracer(mobj_t *actor)
 	INT32 locvar1 = var1;
 	INT32 locvar2 = var2;
 	mobj_t *targetedmobj = NULL;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist1 = 0, dist2 = 0;
 #ifdef HAVE_BLUA
@@ -7345,34 +7331,29 @@ void A_FindTracer(mobj_t *actor)
 
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTracer called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
-	// scan the thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the mobjs of that type
+	for (mo2 = P_FirstMobjOfType(locvar1); mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)locvar1)
+		if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
+			continue; // Ignore spectators
+		if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
+			continue; // Ignore dead things
+		if (targetedmobj == NULL)
 		{
-			if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
-				continue; // Ignore spectators
-			if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
-				continue; // Ignore dead things
-			if (targetedmobj == NULL)
+			targetedmobj = mo2;
+			dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+		}
+		else
+		{
+			dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+			if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
 			{
 				targetedmobj = mo2;
-				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-			}
-			else
-			{
-				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-				if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
-				{
-					targetedmobj = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -7904,34 +7885,28 @@ void A_RemoteAction(mobj_t *actor)
 	{
 		///* DO A_FINDTARGET STUFF *///
 		mobj_t *targetedmobj = NULL;
-		thinker_t *th;
 		mobj_t *mo2;
 		fixed_t dist1 = 0, dist2 = 0;
 
-		// scan the thinkers
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		// scan the mobjs of that type
+		for (mo2 = P_FirstMobjOfType(locvar1); mo2; mo2 = mo2->tnext)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+			if (P_MobjWasRemoved(mo2))
 				continue;
 
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type == (mobjtype_t)locvar1)
+			if (targetedmobj == NULL)
+			{
+				targetedmobj = mo2;
+				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+			}
+			else
 			{
-				if (targetedmobj == NULL)
+				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+				if ((locvar2 && dist1 < dist2) || (!locvar2 && dist1 > dist2))
 				{
 					targetedmobj = mo2;
-					dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-				}
-				else
-				{
-					dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-					if ((locvar2 && dist1 < dist2) || (!locvar2 && dist1 > dist2))
-					{
-						targetedmobj = mo2;
-						dist2 = dist1;
-					}
+					dist2 = dist1;
 				}
 			}
 		}
@@ -8122,7 +8097,6 @@ void A_SetObjectTypeState(mobj_t *actor)
 	const UINT16 loc2lw = (UINT16)(locvar2 & 65535);
 	const UINT16 loc2up = (UINT16)(locvar2 >> 16);
 
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist = 0;
 
@@ -8131,26 +8105,21 @@ void A_SetObjectTypeState(mobj_t *actor)
 		return;
 #endif
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (mo2 = P_FirstMobjOfType(loc2lw); mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
+		dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
 
-		if (mo2->type == (mobjtype_t)loc2lw)
+		if (mo2->health > 0)
 		{
-			dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
-
-			if (mo2->health > 0)
+			if (loc2up == 0)
+				P_SetMobjState(mo2, locvar1);
+			else
 			{
-				if (loc2up == 0)
+				if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
 					P_SetMobjState(mo2, locvar1);
-				else
-				{
-					if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
-						P_SetMobjState(mo2, locvar1);
-				}
 			}
 		}
 	}
@@ -8761,7 +8730,6 @@ void A_CheckThingCount(mobj_t *actor)
 	const UINT16 loc2up = (UINT16)(locvar2 >> 16);
 
 	INT32 count = 0;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist = 0;
 #ifdef HAVE_BLUA
@@ -8769,24 +8737,19 @@ void A_CheckThingCount(mobj_t *actor)
 		return;
 #endif
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (mo2 = P_FirstMobjOfType(loc1up); mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
+		dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
 
-		if (mo2->type == (mobjtype_t)loc1up)
+		if (loc2up == 0)
+			count++;
+		else
 		{
-			dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
-
-			if (loc2up == 0)
+			if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
 				count++;
-			else
-			{
-				if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
-					count++;
-			}
 		}
 	}
 
@@ -92,18 +92,15 @@ void P_RampConstant(const BasicFF_t *FFInfo, INT32 Start, INT32 End)
   */
 void P_ClearStarPost(INT32 postnum)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
-	// scan the thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the starposts
+	for (mo2 = mobjtypelist[MT_STARPOST]; mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_STARPOST && mo2->health <= postnum)
+		if (mo2->health <= postnum)
 			P_SetMobjState(mo2, mo2->info->seestate);
 	}
 	return;
@@ -116,19 +113,15 @@ void P_ClearStarPost(INT32 postnum)
 //
 void P_ResetStarposts(void)
 {
-	// Search through all the thinkers.
-	thinker_t *th;
+	// Search through all the starposts.
 	mobj_t *post;
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (post = mobjtypelist[MT_STARPOST]; post; post = post->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(post))
 			continue;
 
-		post = (mobj_t *)th;
-
-		if (post->type == MT_STARPOST)
-			P_SetMobjState(post, post->info->spawnstate);
+		P_SetMobjState(post, post->info->spawnstate);
 	}
 }
 
@@ -1103,7 +1096,6 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 		case MT_AXE:
 			{
 				line_t junk;
-				thinker_t  *th;
 				mobj_t *mo2;
 
 				if (player->bot)
@@ -1112,18 +1104,14 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 				junk.tag = 649;
 				EV_DoElevator(&junk, bridgeFall, false);
 
-				// scan the remaining thinkers to find koopa
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				// find the first koopa
+				for (mo2 = mobjtypelist[MT_KOOPA]; mo2; mo2 = mo2->tnext)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+					if (P_MobjWasRemoved(mo2))
 						continue;
 
-					mo2 = (mobj_t *)th;
-					if (mo2->type == MT_KOOPA)
-					{
-						mo2->momz = 5*FRACUNIT;
-						break;
-					}
+					mo2->momz = 5*FRACUNIT;
+					break;
 				}
 			}
 			break;
@@ -1173,20 +1161,17 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 
 			// Find all starposts in the level with this value.
 			{
-				thinker_t *th;
 				mobj_t *mo2;
 
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (mo2 = mobjtypelist[MT_STARPOST]; mo2; mo2 = mo2->tnext)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-					continue;
-
-					mo2 = (mobj_t *)th;
+					if (P_MobjWasRemoved(mo2))
+						continue;
 
 					if (mo2 == special)
 						continue;
 
-					if (mo2->type == MT_STARPOST && mo2->health == special->health)
+					if (mo2->health == special->health)
 					{
 						if (!(netgame && circuitmap && player != &players[consoleplayer]))
 							P_SetMobjState(mo2, mo2->info->painstate);
@@ -2290,18 +2275,16 @@ void P_KillMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 
 	if (target->type == MT_EGGMOBILE3)
 	{
-		thinker_t *th;
 		UINT32 i = 0; // to check how many clones we've removed
 
-		// scan the thinkers to make sure all the old pinch dummies are gone on death
+		// scan the clones to make sure all the old pinch dummies are gone on death
 		// this can happen if the boss was hurt earlier than expected
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (mo = P_FirstMobjOfType(target->info->mass); mo; mo = mo->tnext)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+			if (P_MobjWasRemoved(mo))
 				continue;
 
-			mo = (mobj_t *)th;
-			if (mo->type == (mobjtype_t)target->info->mass && mo->tracer == target)
+			if (mo->tracer == target)
 			{
 				P_RemoveMobj(mo);
 				i++;
@@ -102,6 +102,7 @@ boolean P_TeleportMove(mobj_t *thing, fixed_t x, fixed_t y, fixed_t z)
 	thing->floorz = tmfloorz;
 	thing->ceilingz = tmceilingz;
 
+	P_UpdateMobjConsistancy(thing);
 	return true;
 }
 
@@ -2172,6 +2173,7 @@ boolean P_TryMove(mobj_t *thing, fixed_t x, fixed_t y, boolean allowdropoff)
 		thing->eflags |= MFE_ONGROUND;
 
 	P_SetThingPosition(thing);
+	P_UpdateMobjConsistancy(thing);
 	return true;
 }
 
@@ -2228,6 +2230,7 @@ boolean P_SceneryTryMove(mobj_t *thing, fixed_t x, fixed_t y)
 		thing->eflags |= MFE_ONGROUND;
 
 	P_SetThingPosition(thing);
+	P_UpdateMobjConsistancy(thing);
 	return true;
 }
 
@@ -337,6 +337,7 @@ boolean P_SetPlayerMobjState(mobj_t *mobj, statenum_t state)
 		for (;(state = seenstate[i]) > S_NULL; i = state - 1)
 			seenstate[i] = S_NULL; // erase memory of states
 
+	P_UpdateMobjConsistancy(mobj);
 	return true;
 }
 
@@ -402,6 +403,7 @@ boolean P_SetMobjState(mobj_t *mobj, statenum_t state)
 		for (;(state = seenstate[i]) > S_NULL; i = state - 1)
 			seenstate[i] = S_NULL; // erase memory of states
 
+	P_UpdateMobjConsistancy(mobj);
 	return true;
 }
 
@@ -429,6 +431,7 @@ boolean P_SetMobjStateNF(mobj_t *mobj, statenum_t state)
 	mobj->frame = st->frame;
 	mobj->anim_duration = (UINT16)st->var2; // only used if FF_ANIMATE is set
 
+	P_UpdateMobjConsistancy(mobj);
 	return true;
 }
 
@@ -7677,6 +7680,185 @@ void P_SceneryThinker(mobj_t *mobj)
 	P_CycleMobjState(mobj);
 }
 
+//
+// MOBJ TYPE LISTS
+// Every mobj in the thinker list is also kept in a list of the mobjs
+// of its type, so looking for all things of one type doesn't have to
+// walk every thinker in the level.
+//
+
+mobj_t *mobjtypelist[NUMMOBJTYPES];
+
+// XOR of every thinking mobj's hash, see P_UpdateMobjConsistancy
+UINT32 mobjconsistancy = 0;
+
+//
+// P_LinkMobjType
+// Adds a mobj at the end of its type's list.
+//
+void P_LinkMobjType(mobj_t *mobj)
+{
+	mobj_t **head = &mobjtypelist[mobj->type];
+
+	I_Assert(mobj->tprev == NULL);
+
+	mobj->tnext = NULL;
+	if (*head)
+	{
+		mobj->tprev = (*head)->tprev;
+		mobj->tprev->tnext = mobj;
+		(*head)->tprev = mobj;
+	}
+	else
+		*head = mobj->tprev = mobj;
+}
+
+//
+// P_UnlinkMobjType
+// Removes a mobj from its type's list, if it is in it.
+//
+void P_UnlinkMobjType(mobj_t *mobj)
+{
+	mobj_t **head = &mobjtypelist[mobj->type];
+
+	if (!mobj->tprev)
+		return;
+
+	if (*head == mobj)
+	{
+		*head = mobj->tnext;
+		if (*head)
+			(*head)->tprev = mobj->tprev;
+	}
+	else
+	{
+		mobj->tprev->tnext = mobj->tnext;
+		if (mobj->tnext)
+			mobj->tnext->tprev = mobj->tprev;
+		else
+			(*head)->tprev = mobj->tprev;
+	}
+
+	mobj->tprev = NULL;
+}
+
+//
+// P_InsertMobjType
+// Adds a mobj to its type's list where it falls in thinker order,
+// which isn't the end if it already existed as another type.
+//
+static void P_InsertMobjType(mobj_t *mobj)
+{
+	mobj_t **head = &mobjtypelist[mobj->type];
+	mobj_t *next = NULL;
+	thinker_t *th;
+
+	I_Assert(mobj->tprev == NULL);
+
+	// find the next mobj of this type in the thinker list
+	if (*head)
+		for (th = mobj->thinker.next; th != &thinkercap; th = th->next)
+		{
+			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+				continue;
+			if (((mobj_t *)th)->type == mobj->type && ((mobj_t *)th)->tprev)
+			{
+				next = (mobj_t *)th;
+				break;
+			}
+		}
+
+	if (!next) // nothing after it, so it goes at the end
+	{
+		P_LinkMobjType(mobj);
+		return;
+	}
+
+	mobj->tnext = next;
+	mobj->tprev = next->tprev;
+	if (*head == next)
+		*head = mobj; // the tail is still the head's tprev
+	else
+		mobj->tprev->tnext = mobj;
+	next->tprev = mobj;
+}
+
+//
+// P_SetMobjType
+// Changes a mobj's type, keeping the type lists in order.
+//
+void P_SetMobjType(mobj_t *mobj, mobjtype_t type)
+{
+	boolean linked = (mobj->tprev != NULL);
+
+	if (linked)
+		P_UnlinkMobjType(mobj);
+	mobj->type = type;
+	if (linked)
+		P_InsertMobjType(mobj);
+
+	P_UpdateMobjConsistancy(mobj);
+}
+
+//
+// P_MobjConsistancy
+// The hash of a mobj that goes into mobjconsistancy.
+//
+static UINT32 P_MobjConsistancy(const mobj_t *mobj)
+{
+	UINT32 hash = (UINT32)mobj->type;
+
+	switch (mobj->type)
+	{
+		// hoops aren't saved, joiners respawn their own from the map
+		case MT_HOOP:
+		case MT_HOOPCOLLIDE:
+		case MT_HOOPCENTER:
+		// display-only, each node spawns these depending on whose view it's
+		// watching (P_DoPlayerHeadSigns, seenames), so no two nodes agree
+		case MT_TAG:
+		case MT_GOTFLAG:
+		case MT_GOTFLAG2:
+#ifdef SEENAMES
+		case MT_NAMECHECK:
+#endif
+		// P_RunOverlays turns these to face the local camera
+		case MT_OVERLAY:
+			return 0;
+		default:
+			break;
+	}
+
+	hash = (hash ^ (UINT32)mobj->x) * 0x9E3779B1;
+	hash = (hash ^ (UINT32)mobj->y) * 0x9E3779B1;
+	hash = (hash ^ (UINT32)mobj->z) * 0x9E3779B1;
+	hash = (hash ^ (UINT32)(mobj->state - states)) * 0x9E3779B1;
+	return hash ^ (hash >> 16);
+}
+
+//
+// P_UpdateMobjConsistancy
+// Swaps a mobj's old hash in mobjconsistancy for its current one.
+// Called wherever a mobj moves or changes state, so the world hash costs
+// nothing more than the mobjs that changed this tic.
+//
+// Only mobjs in the thinker list count, as they are the ones savegames
+// carry to joining players. Anything that moves without coming through
+// here keeps its old hash until it does, which every node does alike.
+//
+void P_UpdateMobjConsistancy(mobj_t *mobj)
+{
+	UINT32 hash;
+
+	if (P_MobjWasRemoved(mobj) || !mobj->tprev)
+		hash = 0;
+	else
+		hash = P_MobjConsistancy(mobj);
+
+	mobjconsistancy ^= mobj->consistancy ^ hash;
+	mobj->consistancy = hash;
+}
+
 //
 // GAME SPAWN FUNCTIONS
 //
@@ -7898,7 +8080,10 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	}
 
 	if (!(mobj->flags & MF_NOTHINK))
+	{
 		P_AddThinker(&mobj->thinker);
+		P_LinkMobjType(mobj);
+	}
 
 	// Call action functions when the state is set
 	if (st->action.acp1 && (mobj->flags & MF_RUNSPAWNFUNC))
@@ -7929,6 +8114,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	if (CheckForReverseGravity && !(mobj->flags & MF_NOBLOCKMAP))
 		P_CheckGravity(mobj, false);
 
+	P_UpdateMobjConsistancy(mobj);
 	return mobj;
 }
 
@@ -8044,6 +8230,10 @@ void P_RemoveMobj(mobj_t *mobj)
 	if (mobj->type == MT_OVERLAY)
 		P_RemoveOverlay(mobj);
 
+	mobjconsistancy ^= mobj->consistancy;
+	mobj->consistancy = 0;
+	P_UnlinkMobjType(mobj);
+
 	mobj->health = 0; // Just because
 
 	// unlink from sector and block lists
@@ -8126,8 +8316,9 @@ void P_RemovePrecipMobj(precipmobj_t *mobj)
 // Clearing out stuff for savegames
 void P_RemoveSavegameMobj(mobj_t *mobj)
 {
-	// unlink from sector and block lists
+	// unlink from sector, block and type lists
 	P_UnsetThingPosition(mobj);
+	P_UnlinkMobjType(mobj);
 
 	// Remove touching_sectorlist from mobj.
 	if (sector_list)
@@ -313,6 +313,12 @@ typedef struct mobj_s
 	struct mobj_s *hnext;
 	struct mobj_s *hprev;
 
+	// List: links in mobjtypelist, only for mobjs in the thinker list.
+	// tprev is NULL when unlinked; tnext is left alone so a walk of the
+	// list survives the current mobj being removed.
+	struct mobj_s *tnext;
+	struct mobj_s *tprev; // the head's tprev points to the tail
+
 	mobjtype_t type;
 	const mobjinfo_t *info; // &mobjinfo[mobj->type]
 
@@ -346,6 +352,7 @@ typedef struct mobj_s
 	fixed_t waterbottom; // bottom of the water FOF the mobj is in
 
 	UINT32 mobjnum; // A unique number for this mobj. Used for restoring pointers on save games.
+	UINT32 consistancy; // What this mobj last put into mobjconsistancy
 
 	fixed_t scale;
 	fixed_t destscale;
@@ -423,6 +430,14 @@ typedef struct actioncache_s
 
 extern actioncache_t actioncachehead;
 
+// Per-type lists of thinking mobjs, in thinker list order
+extern mobj_t *mobjtypelist[NUMMOBJTYPES];
+// Head of a type list for a type that comes from SOC/Lua variables, NULL if out of range
+#define P_FirstMobjOfType(type) ((UINT32)(type) < NUMMOBJTYPES ? mobjtypelist[(type)] : NULL)
+void P_LinkMobjType(mobj_t *mobj);
+void P_UnlinkMobjType(mobj_t *mobj);
+void P_SetMobjType(mobj_t *mobj, mobjtype_t type);
+
 void P_InitCachedActions(void);
 void P_RunCachedActions(void);
 void P_AddCachedAction(mobj_t *mobj, INT32 statenum);
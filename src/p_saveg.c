@@ -37,6 +37,91 @@
 savedata_t savedata;
 UINT8 *save_p;
 
+// Pages of the savegame being written, and the one save_p is in
+static savepage_t *savepages = NULL, *savepage = NULL;
+
+// P_SaveReserve leaves this much past what it's asked for,
+// for the end markers and counts written between records
+#define SAVESLACK 64
+
+static savepage_t *P_NewSavePage(size_t size)
+{
+	savepage_t *page = malloc(offsetof(savepage_t, data) + size);
+	if (!page)
+		I_Error("No more free memory for savegame\n");
+	page->next = NULL;
+	page->size = size;
+	page->length = 0;
+	return page;
+}
+
+static void P_CloseSavePage(void)
+{
+	savepage->length = save_p - savepage->data;
+	if (savepage->length > savepage->size)
+		I_Error("Savegame buffer overrun");
+}
+
+/** Starts writing a savegame with P_SaveNetGame
+  *
+  * \sa P_EndSave
+  */
+void P_BeginSave(void)
+{
+	I_Assert(savepages == NULL);
+	savepages = savepage = P_NewSavePage(SAVEPAGESIZE);
+	save_p = savepage->data;
+}
+
+/** Makes sure the next record fits where save_p is,
+  * starting a new page if it doesn't
+  *
+  * \param size The most bytes the record can take
+  */
+void P_SaveReserve(size_t size)
+{
+	savepage_t *page;
+
+	size += SAVESLACK;
+	if (size <= savepage->size - (size_t)(save_p - savepage->data))
+		return;
+
+	P_CloseSavePage();
+	page = P_NewSavePage(max(size, SAVEPAGESIZE));
+	savepage->next = page;
+	savepage = page;
+	save_p = page->data;
+}
+
+/** Finishes a savegame
+  *
+  * \param length Set to the total length of all the pages
+  * \return The pages, to be freed with P_FreeSave
+  */
+savepage_t *P_EndSave(size_t *length)
+{
+	savepage_t *pages = savepages, *page;
+
+	P_CloseSavePage();
+	*length = 0;
+	for (page = pages; page; page = page->next)
+		*length += page->length;
+
+	savepages = savepage = NULL;
+	save_p = NULL;
+	return pages;
+}
+
+void P_FreeSave(savepage_t *pages)
+{
+	while (pages)
+	{
+		savepage_t *next = pages->next;
+		free(pages);
+		pages = next;
+	}
+}
+
 // Block UINT32s to attempt to ensure that the correct data is
 // being sent and received
 #define ARCHIVEBLOCK_MISC     0x7FEEDEED
@@ -121,6 +206,7 @@ static void P_NetArchivePlayers(void)
 		if (!playeringame[i])
 			continue;
 
+		P_SaveReserve(SAVERECORDSIZE);
 		flags = 0;
 
 		// no longer send ticcmds, player name, skin, or color
@@ -578,6 +664,10 @@ static void P_NetArchiveWorld(void)
 		{
 			statsec++;
 
+			save_p = put;
+			P_SaveReserve(SAVERECORDSIZE);
+			put = save_p;
+
 			WRITEUINT16(put, i);
 			WRITEUINT8(put, diff);
 			if (diff & SD_DIFF2)
@@ -631,6 +721,10 @@ static void P_NetArchiveWorld(void)
 
 					if (fflr_diff)
 					{
+						save_p = put;
+						P_SaveReserve(7);
+						put = save_p;
+
 						WRITEUINT16(put, j); // save ffloor "number"
 						WRITEUINT8(put, fflr_diff);
 						if (fflr_diff & 1)
@@ -695,6 +789,11 @@ static void P_NetArchiveWorld(void)
 		if (diff)
 		{
 			statline++;
+
+			save_p = put;
+			P_SaveReserve(SAVERECORDSIZE);
+			put = save_p;
+
 			WRITEINT16(put, i);
 			WRITEUINT8(put, diff);
 			if (diff & LD_DIFF2)
@@ -1263,408 +1362,386 @@ static void SaveMobjThinker(const thinker_t *th, const UINT8 type)
 #endif
 
 	WRITEUINT32(save_p, mobj->mobjnum);
+	WRITEUINT32(save_p, mobj->consistancy);
 }
 
 //
-// SaveSpecialLevelThinker
+// Thinker descriptions
 //
-// Saves a levelspecthink_t thinker
+// Every thinker but the mobj is saved and loaded from a list of its
+// fields, in the order they are in the savegame. Runs of 32-bit fields
+// that are next to each other in the struct are copied in one go.
 //
-static void SaveSpecialLevelThinker(const thinker_t *th, const UINT8 type)
+typedef enum
 {
-	const levelspecthink_t *ht  = (const void *)th;
-	size_t i;
-	WRITEUINT8(save_p, type);
-	for (i = 0; i < 16; i++)
-	{
-		WRITEFIXED(save_p, ht->vars[i]); //var[16]
-		WRITEFIXED(save_p, ht->var2s[i]); //var[16]
-	}
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-}
+	TF_LONG,   // Some 32-bit fields in a row
+	TF_BYTE,   // A field of any size, saved as one byte
+	TF_SECTOR, // sector_t *, saved as its number
+	TF_LINE,   // line_t *, saved as its number
+	TF_PLAYER, // player_t *, saved as its number
+	TF_MOBJ,   // mobj_t *, saved as its mobjnum and relinked once all are loaded
+	TF_END
+} thinkerfieldtype_t;
+
+typedef struct
+{
+	UINT8 type;
+	UINT8 count; // How many fields for TF_LONG, the size of the field for TF_BYTE
+	UINT16 offset;
+} thinkerfield_t;
+
+#define TFLONG(t, f, n) {TF_LONG, n, (UINT16)offsetof(t, f)}
+#define TFBYTE(t, f) {TF_BYTE, (UINT8)sizeof (((t *)0)->f), (UINT16)offsetof(t, f)}
+#define TFPTR(k, t, f) {k, 0, (UINT16)offsetof(t, f)}
+#define TFEND {TF_END, 0, 0}
 
-//
-// SaveCeilingThinker
-//
-// Saves a ceiling_t thinker
-//
-static void SaveCeilingThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t levelspecthinkfields[] =
+{
+	TFLONG(levelspecthink_t, vars, 32), // vars and var2s
+	TFPTR(TF_LINE, levelspecthink_t, sourceline),
+	TFPTR(TF_SECTOR, levelspecthink_t, sector),
+	TFEND
+};
+
+static const thinkerfield_t ceilingfields[] =
+{
+	TFBYTE(ceiling_t, type),
+	TFPTR(TF_SECTOR, ceiling_t, sector),
+	TFLONG(ceiling_t, bottomheight, 6), // to delaytimer
+	TFBYTE(ceiling_t, crush),
+	TFLONG(ceiling_t, texture, 6), // to sourceline
+	TFEND
+};
+
+static const thinkerfield_t floormovefields[] =
 {
-	const ceiling_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEFIXED(save_p, ht->bottomheight);
-	WRITEFIXED(save_p, ht->topheight);
-	WRITEFIXED(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->oldspeed);
-	WRITEFIXED(save_p, ht->delay);
-	WRITEFIXED(save_p, ht->delaytimer);
-	WRITEUINT8(save_p, ht->crush);
-	WRITEINT32(save_p, ht->texture);
-	WRITEINT32(save_p, ht->direction);
-	WRITEINT32(save_p, ht->tag);
-	WRITEINT32(save_p, ht->olddirection);
-	WRITEFIXED(save_p, ht->origspeed);
-	WRITEFIXED(save_p, ht->sourceline);
-}
+	TFBYTE(floormove_t, type),
+	TFBYTE(floormove_t, crush),
+	TFPTR(TF_SECTOR, floormove_t, sector),
+	TFLONG(floormove_t, direction, 7), // to delaytimer
+	TFEND
+};
 
-//
-// SaveFloormoveThinker
-//
-// Saves a floormove_t thinker
-//
-static void SaveFloormoveThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t lightflashfields[] =
 {
-	const floormove_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEUINT8(save_p, ht->crush);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->direction);
-	WRITEINT32(save_p, ht->texture);
-	WRITEFIXED(save_p, ht->floordestheight);
-	WRITEFIXED(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->origspeed);
-	WRITEFIXED(save_p, ht->delay);
-	WRITEFIXED(save_p, ht->delaytimer);
-}
+	TFPTR(TF_SECTOR, lightflash_t, sector),
+	TFLONG(lightflash_t, maxlight, 2),
+	TFEND
+};
 
-//
-// SaveLightflashThinker
-//
-// Saves a lightflash_t thinker
-//
-static void SaveLightflashThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t strobefields[] =
 {
-	const lightflash_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->maxlight);
-	WRITEINT32(save_p, ht->minlight);
-}
+	TFPTR(TF_SECTOR, strobe_t, sector),
+	TFLONG(strobe_t, count, 5),
+	TFEND
+};
 
-//
-// SaveStrobeThinker
-//
-// Saves a strobe_t thinker
-//
-static void SaveStrobeThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t glowfields[] =
 {
-	const strobe_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->count);
-	WRITEINT32(save_p, ht->minlight);
-	WRITEINT32(save_p, ht->maxlight);
-	WRITEINT32(save_p, ht->darktime);
-	WRITEINT32(save_p, ht->brighttime);
-}
+	TFPTR(TF_SECTOR, glow_t, sector),
+	TFLONG(glow_t, minlight, 4),
+	TFEND
+};
 
-//
-// SaveGlowThinker
-//
-// Saves a glow_t thinker
-//
-static void SaveGlowThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t fireflickerfields[] =
 {
-	const glow_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->minlight);
-	WRITEINT32(save_p, ht->maxlight);
-	WRITEINT32(save_p, ht->direction);
-	WRITEINT32(save_p, ht->speed);
-}
-//
-// SaveFireflickerThinker
-//
-// Saves a fireflicker_t thinker
-//
-static inline void SaveFireflickerThinker(const thinker_t *th, const UINT8 type)
+	TFPTR(TF_SECTOR, fireflicker_t, sector),
+	TFLONG(fireflicker_t, count, 4),
+	TFEND
+};
+
+static const thinkerfield_t elevatorfields[] =
 {
-	const fireflicker_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->count);
-	WRITEINT32(save_p, ht->resetcount);
-	WRITEINT32(save_p, ht->maxlight);
-	WRITEINT32(save_p, ht->minlight);
-}
-//
-// SaveElevatorThinker
-//
-// Saves a elevator_t thinker
-//
-static void SaveElevatorThinker(const thinker_t *th, const UINT8 type)
+	TFBYTE(elevator_t, type),
+	TFPTR(TF_SECTOR, elevator_t, sector),
+	TFPTR(TF_SECTOR, elevator_t, actionsector),
+	TFLONG(elevator_t, direction, 12), // to ceilingwasheight
+	TFPTR(TF_PLAYER, elevator_t, player), // was dummy
+	TFPTR(TF_LINE, elevator_t, sourceline),
+	TFEND
+};
+
+static const thinkerfield_t scrollfields[] =
 {
-	const elevator_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEUINT32(save_p, SaveSector(ht->actionsector));
-	WRITEINT32(save_p, ht->direction);
-	WRITEFIXED(save_p, ht->floordestheight);
-	WRITEFIXED(save_p, ht->ceilingdestheight);
-	WRITEFIXED(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->origspeed);
-	WRITEFIXED(save_p, ht->low);
-	WRITEFIXED(save_p, ht->high);
-	WRITEFIXED(save_p, ht->distance);
-	WRITEFIXED(save_p, ht->delay);
-	WRITEFIXED(save_p, ht->delaytimer);
-	WRITEFIXED(save_p, ht->floorwasheight);
-	WRITEFIXED(save_p, ht->ceilingwasheight);
-	WRITEUINT32(save_p, SavePlayer(ht->player)); // was dummy
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-}
+	TFLONG(scroll_t, dx, 9), // to exclusive
+	TFBYTE(scroll_t, type),
+	TFEND
+};
 
-//
-// SaveScrollThinker
-//
-// Saves a scroll_t thinker
-//
-static inline void SaveScrollThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t frictionfields[] =
 {
-	const scroll_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEFIXED(save_p, ht->dx);
-	WRITEFIXED(save_p, ht->dy);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEINT32(save_p, ht->control);
-	WRITEFIXED(save_p, ht->last_height);
-	WRITEFIXED(save_p, ht->vdx);
-	WRITEFIXED(save_p, ht->vdy);
-	WRITEINT32(save_p, ht->accel);
-	WRITEINT32(save_p, ht->exclusive);
-	WRITEUINT8(save_p, ht->type);
-}
+	TFLONG(friction_t, friction, 4), // to referrer
+	TFBYTE(friction_t, roverfriction),
+	TFEND
+};
+
+static const thinkerfield_t pusherfields[] =
+{
+	TFBYTE(pusher_t, type),
+	TFLONG(pusher_t, x_mag, 8), // to affectee
+	TFBYTE(pusher_t, roverpusher),
+	TFLONG(pusher_t, referrer, 3), // to slider
+	TFEND
+};
 
-//
-// SaveFrictionThinker
-//
-// Saves a friction_t thinker
-//
-static inline void SaveFrictionThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t laserfields[] =
 {
-	const friction_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->friction);
-	WRITEINT32(save_p, ht->movefactor);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEINT32(save_p, ht->referrer);
-	WRITEUINT8(save_p, ht->roverfriction);
-}
+	TFPTR(TF_SECTOR, laserthink_t, sector),
+	TFPTR(TF_SECTOR, laserthink_t, sec),
+	TFPTR(TF_LINE, laserthink_t, sourceline),
+	TFEND
+};
 
-//
-// SavePusherThinker
-//
-// Saves a pusher_t thinker
-//
-static inline void SavePusherThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t lightlevelfields[] =
 {
-	const pusher_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEINT32(save_p, ht->x_mag);
-	WRITEINT32(save_p, ht->y_mag);
-	WRITEINT32(save_p, ht->magnitude);
-	WRITEINT32(save_p, ht->radius);
-	WRITEINT32(save_p, ht->x);
-	WRITEINT32(save_p, ht->y);
-	WRITEINT32(save_p, ht->z);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEUINT8(save_p, ht->roverpusher);
-	WRITEINT32(save_p, ht->referrer);
-	WRITEINT32(save_p, ht->exclusive);
-	WRITEINT32(save_p, ht->slider);
-}
+	TFPTR(TF_SECTOR, lightlevel_t, sector),
+	TFLONG(lightlevel_t, destlevel, 2),
+	TFEND
+};
 
-//
-// SaveLaserThinker
-//
-// Saves a laserthink_t thinker
-//
-static void SaveLaserThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t executorfields[] =
 {
-	const laserthink_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEUINT32(save_p, SaveSector(ht->sec));
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-}
+	TFPTR(TF_LINE, executor_t, line),
+	TFPTR(TF_MOBJ, executor_t, caller),
+	TFPTR(TF_SECTOR, executor_t, sector),
+	TFLONG(executor_t, timer, 1),
+	TFEND
+};
 
-//
-// SaveLightlevelThinker
-//
-// Saves a lightlevel_t thinker
-//
-static void SaveLightlevelThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t disappearfields[] =
 {
-	const lightlevel_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->destlevel);
-	WRITEINT32(save_p, ht->speed);
-}
+	TFLONG(disappear_t, appeartime, 7), // to exists
+	TFEND
+};
 
-//
-// SaveExecutorThinker
-//
-// Saves a executor_t thinker
-//
-static void SaveExecutorThinker(const thinker_t *th, const UINT8 type)
+#ifdef POLYOBJECTS
+static const thinkerfield_t polyrotatefields[] =
 {
-	const executor_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->line));
-	WRITEUINT32(save_p, SaveMobjnum(ht->caller));
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->timer);
-}
+	TFLONG(polyrotate_t, polyObjNum, 3), // to distance
+	TFEND
+};
 
-//
-// SaveDisappearThinker
-//
-// Saves a disappear_t thinker
-//
-static void SaveDisappearThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t polymovefields[] =
 {
-	const disappear_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, ht->appeartime);
-	WRITEUINT32(save_p, ht->disappeartime);
-	WRITEUINT32(save_p, ht->offset);
-	WRITEUINT32(save_p, ht->timer);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEINT32(save_p, ht->sourceline);
-	WRITEINT32(save_p, ht->exists);
-}
+	TFLONG(polymove_t, polyObjNum, 6), // to angle
+	TFEND
+};
 
-#ifdef POLYOBJECTS
+static const thinkerfield_t polywaypointfields[] =
+{
+	TFLONG(polywaypoint_t, polyObjNum, 5), // to direction
+	TFBYTE(polywaypoint_t, comeback),
+	TFBYTE(polywaypoint_t, wrap),
+	TFBYTE(polywaypoint_t, continuous),
+	TFBYTE(polywaypoint_t, stophere),
+	TFLONG(polywaypoint_t, diffx, 3), // to diffz
+	TFEND
+};
 
-//
-// SavePolyrotateThinker
-//
-// Saves a polyrotate_t thinker
-//
-static inline void SavePolyrotatetThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t polyslidedoorfields[] =
 {
-	const polyrotate_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->speed);
-	WRITEINT32(save_p, ht->distance);
-}
+	TFLONG(polyslidedoor_t, polyObjNum, 12), // to momy
+	TFBYTE(polyslidedoor_t, closing),
+	TFEND
+};
 
-//
-// SavePolymoveThinker
-//
-// Saves a polymovet_t thinker
-//
-static void SavePolymoveThinker(const thinker_t *th, const UINT8 type)
+static const thinkerfield_t polyswingdoorfields[] =
 {
-	const polymove_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->momx);
-	WRITEFIXED(save_p, ht->momy);
-	WRITEINT32(save_p, ht->distance);
-	WRITEANGLE(save_p, ht->angle);
+	TFLONG(polyswingdoor_t, polyObjNum, 7), // to distance
+	TFBYTE(polyswingdoor_t, closing),
+	TFEND
+};
+
+static const thinkerfield_t polydisplacefields[] =
+{
+	TFLONG(polydisplace_t, polyObjNum, 1),
+	TFPTR(TF_SECTOR, polydisplace_t, controlSector),
+	TFLONG(polydisplace_t, dx, 3), // to oldHeights
+	TFEND
+};
+#endif
+
+#undef TFLONG
+#undef TFBYTE
+#undef TFPTR
+#undef TFEND
+
+// Which of its sector's thinker pointers a thinker takes when loaded
+#define TD_FLOOR    0x01
+#define TD_CEILING  0x02
+#define TD_LIGHTING 0x04
+
+// Recomputes what a pusher_t doesn't save
+static void PusherLoaded(thinker_t *th)
+{
+	pusher_t *ht = (void *)th;
+	ht->source = P_GetPushThing(ht->affectee);
 }
 
-//
-// SavePolywaypointThinker
-//
-// Saves a polywaypoint_t thinker
-//
-static void SavePolywaypointThinker(const thinker_t *th, UINT8 type)
+// Finds the FOF a laserthink_t flashes
+static void LaserLoaded(thinker_t *th)
 {
-	const polywaypoint_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->speed);
-	WRITEINT32(save_p, ht->sequence);
-	WRITEINT32(save_p, ht->pointnum);
-	WRITEINT32(save_p, ht->direction);
-	WRITEUINT8(save_p, ht->comeback);
-	WRITEUINT8(save_p, ht->wrap);
-	WRITEUINT8(save_p, ht->continuous);
-	WRITEUINT8(save_p, ht->stophere);
-	WRITEFIXED(save_p, ht->diffx);
-	WRITEFIXED(save_p, ht->diffy);
-	WRITEFIXED(save_p, ht->diffz);
+	laserthink_t *ht = (void *)th;
+	ffloor_t *rover;
+	for (rover = ht->sector->ffloors; rover; rover = rover->next)
+		if (rover->secnum == (size_t)(ht->sec - sectors)
+		&& rover->master == ht->sourceline)
+			ht->ffloor = rover;
 }
 
-//
-// SavePolyslidedoorThinker
-//
-// Saves a polyslidedoor_t thinker
-//
-static void SavePolyslidedoorThinker(const thinker_t *th, const UINT8 type)
+typedef struct
+{
+	actionf_p1 function;
+	size_t size;
+	const thinkerfield_t *fields; // NULL for the mobj, which has its own
+	UINT8 sectordata; // TD_ flags
+	size_t sectorfield; // offsetof its sector_t *sector, if it has TD_ flags
+	void (*loaded)(thinker_t *th); // Fixes up anything not saved
+} thinkerclass_t;
+
+#define TC(f, t, fields, data) {(actionf_p1)f, sizeof (t), fields, data, offsetof(t, sector), NULL}
+#define TCNOSECTOR(f, t, fields, loaded) {(actionf_p1)f, sizeof (t), fields, 0, 0, loaded}
+
+// In the order of specials_e
+static const thinkerclass_t thinkerclasses[tc_end] =
+{
+	{(actionf_p1)P_MobjThinker, sizeof (mobj_t), NULL, 0, 0, NULL}, // tc_mobj
+	TC(T_MoveCeiling, ceiling_t, ceilingfields, TD_CEILING),
+	TC(T_MoveFloor, floormove_t, floormovefields, TD_FLOOR),
+	TC(T_LightningFlash, lightflash_t, lightflashfields, TD_LIGHTING),
+	TC(T_StrobeFlash, strobe_t, strobefields, TD_LIGHTING),
+	TC(T_Glow, glow_t, glowfields, TD_LIGHTING),
+	TC(T_FireFlicker, fireflicker_t, fireflickerfields, TD_LIGHTING),
+	TC(T_ThwompSector, levelspecthink_t, levelspecthinkfields, TD_FLOOR|TD_CEILING),
+	/// \todo rewrite all the code that uses an elevator_t but isn't an elevator
+	TC(T_CameraScanner, elevator_t, elevatorfields, 0),
+	TC(T_MoveElevator, elevator_t, elevatorfields, TD_FLOOR|TD_CEILING),
+	TC(T_ContinuousFalling, levelspecthink_t, levelspecthinkfields, TD_FLOOR|TD_CEILING),
+	TC(T_BounceCheese, levelspecthink_t, levelspecthinkfields, TD_CEILING),
+	TC(T_StartCrumble, elevator_t, elevatorfields, TD_FLOOR),
+	TC(T_MarioBlock, levelspecthink_t, levelspecthinkfields, TD_FLOOR|TD_CEILING),
+	TC(T_MarioBlockChecker, levelspecthink_t, levelspecthinkfields, 0),
+	TC(T_SpikeSector, levelspecthink_t, levelspecthinkfields, 0),
+	TC(T_FloatSector, levelspecthink_t, levelspecthinkfields, 0),
+	TC(T_BridgeThinker, levelspecthink_t, levelspecthinkfields, TD_FLOOR|TD_CEILING),
+	TC(T_CrushCeiling, ceiling_t, ceilingfields, TD_CEILING),
+	TCNOSECTOR(T_Scroll, scroll_t, scrollfields, NULL),
+	TCNOSECTOR(T_Friction, friction_t, frictionfields, NULL),
+	TCNOSECTOR(T_Pusher, pusher_t, pusherfields, PusherLoaded),
+	TCNOSECTOR(T_LaserFlash, laserthink_t, laserfields, LaserLoaded),
+	TC(T_LightFade, lightlevel_t, lightlevelfields, TD_LIGHTING),
+	TCNOSECTOR(T_ExecutorDelay, executor_t, executorfields, NULL),
+	TC(T_RaiseSector, levelspecthink_t, levelspecthinkfields, 0),
+	TC(T_NoEnemiesSector, levelspecthink_t, levelspecthinkfields, 0),
+	TC(T_EachTimeThinker, levelspecthink_t, levelspecthinkfields, 0),
+	TCNOSECTOR(T_Disappear, disappear_t, disappearfields, NULL),
+#ifdef POLYOBJECTS
+	TCNOSECTOR(T_PolyObjRotate, polyrotate_t, polyrotatefields, NULL),
+	TCNOSECTOR(T_PolyObjMove, polymove_t, polymovefields, NULL),
+	TCNOSECTOR(T_PolyObjWaypoint, polywaypoint_t, polywaypointfields, NULL),
+	TCNOSECTOR(T_PolyDoorSlide, polyslidedoor_t, polyslidedoorfields, NULL),
+	TCNOSECTOR(T_PolyDoorSwing, polyswingdoor_t, polyswingdoorfields, NULL),
+	TCNOSECTOR(T_PolyObjFlag, polymove_t, polymovefields, NULL),
+	TCNOSECTOR(T_PolyObjDisplace, polydisplace_t, polydisplacefields, NULL),
+#endif
+};
+
+#undef TC
+#undef TCNOSECTOR
+
+// Thinker function to specials_e, so a thinker's class is found
+// without comparing it to every function in turn
+#define THINKERHASHSIZE 128
+static UINT8 thinkerhash[THINKERHASHSIZE]; // specials_e + 1, 0 if empty
+static boolean thinkerhashready = false;
+
+static size_t ThinkerHash(actionf_p1 function)
 {
-	const polyslidedoor_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->delay);
-	WRITEINT32(save_p, ht->delayCount);
-	WRITEINT32(save_p, ht->initSpeed);
-	WRITEINT32(save_p, ht->speed);
-	WRITEINT32(save_p, ht->initDistance);
-	WRITEINT32(save_p, ht->distance);
-	WRITEUINT32(save_p, ht->initAngle);
-	WRITEUINT32(save_p, ht->angle);
-	WRITEUINT32(save_p, ht->revAngle);
-	WRITEFIXED(save_p, ht->momx);
-	WRITEFIXED(save_p, ht->momy);
-	WRITEUINT8(save_p, ht->closing);
+	size_t h = (size_t)function;
+	h ^= h >> 7;
+	h ^= h >> 13;
+	return h & (THINKERHASHSIZE-1);
 }
 
 //
-// SavePolyswingdoorThinker
+// ThinkerClass
 //
-// Saves a polyswingdoor_t thinker
+// Returns the class of a thinker's function, tc_end if it isn't saved
 //
-static void SavePolyswingdoorThinker(const thinker_t *th, const UINT8 type)
+static UINT8 ThinkerClass(actionf_p1 function)
 {
-	const polyswingdoor_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->delay);
-	WRITEINT32(save_p, ht->delayCount);
-	WRITEINT32(save_p, ht->initSpeed);
-	WRITEINT32(save_p, ht->speed);
-	WRITEINT32(save_p, ht->initDistance);
-	WRITEINT32(save_p, ht->distance);
-	WRITEUINT8(save_p, ht->closing);
-}
+	size_t h;
 
-static void SavePolydisplaceThinker(const thinker_t *th, const UINT8 type)
-{
-	const polydisplace_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEUINT32(save_p, SaveSector(ht->controlSector));
-	WRITEFIXED(save_p, ht->dx);
-	WRITEFIXED(save_p, ht->dy);
-	WRITEFIXED(save_p, ht->oldHeights);
+	if (!thinkerhashready)
+	{
+		UINT8 i;
+		for (i = 0; i < tc_end; i++)
+		{
+			for (h = ThinkerHash(thinkerclasses[i].function); thinkerhash[h]; h = (h+1) & (THINKERHASHSIZE-1))
+				;
+			thinkerhash[h] = (UINT8)(i+1);
+		}
+		thinkerhashready = true;
+	}
+
+	for (h = ThinkerHash(function); thinkerhash[h]; h = (h+1) & (THINKERHASHSIZE-1))
+		if (thinkerclasses[thinkerhash[h]-1].function == function)
+			return (UINT8)(thinkerhash[h]-1);
+	return tc_end;
 }
 
-#endif
-/*
 //
-// SaveWhatThinker
+// SaveThinker
 //
-// Saves a what_t thinker
+// Saves any thinker but a mobj from its description
 //
-static inline void SaveWhatThinker(const thinker_t *th, const UINT8 type)
+static void SaveThinker(const thinker_t *th, const UINT8 type)
 {
-	const what_t *ht = (const void *)th;
+	const thinkerfield_t *f;
+	const UINT8 *base = (const UINT8 *)th;
+
 	WRITEUINT8(save_p, type);
+	for (f = thinkerclasses[type].fields; f->type != TF_END; f++)
+	{
+		const UINT8 *field = base + f->offset;
+		switch (f->type)
+		{
+			case TF_LONG:
+#ifdef SRB2_BIG_ENDIAN
+			{
+				UINT8 i;
+				for (i = 0; i < f->count; i++)
+					WRITEINT32(save_p, ((const INT32 *)field)[i]);
+				break;
+			}
+#else
+				M_Memcpy(save_p, field, f->count*4);
+				save_p += f->count*4;
+				break;
+#endif
+			case TF_BYTE:
+				if (f->count == sizeof (UINT32))
+					WRITEUINT8(save_p, *(const UINT32 *)field);
+				else if (f->count == sizeof (UINT16))
+					WRITEUINT8(save_p, *(const UINT16 *)field);
+				else
+					WRITEUINT8(save_p, *field);
+				break;
+			case TF_SECTOR:
+				WRITEUINT32(save_p, SaveSector(*(sector_t *const *)field));
+				break;
+			case TF_LINE:
+				WRITEUINT32(save_p, SaveLine(*(line_t *const *)field));
+				break;
+			case TF_PLAYER:
+				WRITEUINT32(save_p, SavePlayer(*(player_t *const *)field));
+				break;
+			case TF_MOBJ:
+				WRITEUINT32(save_p, SaveMobjnum(*(mobj_t *const *)field));
+				break;
+		}
+	}
 }
-*/
 
 //
 // P_NetArchiveThinkers
@@ -1680,218 +1757,99 @@ static void P_NetArchiveThinkers(void)
 	// save off the current thinkers
 	for (th = thinkercap.next; th != &thinkercap; th = th->next)
 	{
+		UINT8 type;
+
 		if (!(th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed
 		 || th->function.acp1 == (actionf_p1)P_NullPrecipThinker))
 			numsaved++;
 
-		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
-		{
+		P_SaveReserve(SAVERECORDSIZE);
+
+		type = ThinkerClass(th->function.acp1);
+		if (type == tc_mobj)
 			SaveMobjThinker(th, tc_mobj);
-			continue;
-		}
+		else if (type != tc_end)
+			SaveThinker(th, type);
 #ifdef PARANOIA
-		else if (th->function.acp1 == (actionf_p1)P_NullPrecipThinker);
+		else if (th->function.acp1 != (actionf_p1)P_NullPrecipThinker
+			&& th->function.acv != P_RemoveThinkerDelayed) // wait garbage collection
+			I_Error("unknown thinker type %p", th->function.acp1);
 #endif
-		else if (th->function.acp1 == (actionf_p1)T_MoveCeiling)
-		{
-			SaveCeilingThinker(th, tc_ceiling);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_CrushCeiling)
-		{
-			SaveCeilingThinker(th, tc_crushceiling);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_MoveFloor)
-		{
-			SaveFloormoveThinker(th, tc_floor);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_LightningFlash)
-		{
-			SaveLightflashThinker(th, tc_flash);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_StrobeFlash)
-		{
-			SaveStrobeThinker(th, tc_strobe);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_Glow)
-		{
-			SaveGlowThinker(th, tc_glow);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_FireFlicker)
-		{
-			SaveFireflickerThinker(th, tc_fireflicker);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_MoveElevator)
-		{
-			SaveElevatorThinker(th, tc_elevator);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_ContinuousFalling)
-		{
-			SaveSpecialLevelThinker(th, tc_continuousfalling);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_ThwompSector)
-		{
-			SaveSpecialLevelThinker(th, tc_thwomp);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_NoEnemiesSector)
-		{
-			SaveSpecialLevelThinker(th, tc_noenemies);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_EachTimeThinker)
-		{
-			SaveSpecialLevelThinker(th, tc_eachtime);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_RaiseSector)
-		{
-			SaveSpecialLevelThinker(th, tc_raisesector);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_CameraScanner)
-		{
-			SaveElevatorThinker(th, tc_camerascanner);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_Scroll)
-		{
-			SaveScrollThinker(th, tc_scroll);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_Friction)
-		{
-			SaveFrictionThinker(th, tc_friction);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_Pusher)
-		{
-			SavePusherThinker(th, tc_pusher);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_BounceCheese)
-		{
-			SaveSpecialLevelThinker(th, tc_bouncecheese);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_StartCrumble)
-		{
-			SaveElevatorThinker(th, tc_startcrumble);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_MarioBlock)
-		{
-			SaveSpecialLevelThinker(th, tc_marioblock);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_MarioBlockChecker)
-		{
-			SaveSpecialLevelThinker(th, tc_marioblockchecker);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_SpikeSector)
-		{
-			SaveSpecialLevelThinker(th, tc_spikesector);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_FloatSector)
-		{
-			SaveSpecialLevelThinker(th, tc_floatsector);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_BridgeThinker)
-		{
-			SaveSpecialLevelThinker(th, tc_bridgethinker);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_LaserFlash)
-		{
-			SaveLaserThinker(th, tc_laserflash);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_LightFade)
-		{
-			SaveLightlevelThinker(th, tc_lightfade);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_ExecutorDelay)
-		{
-			SaveExecutorThinker(th, tc_executor);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_Disappear)
-		{
-			SaveDisappearThinker(th, tc_disappear);
-			continue;
-		}
-#ifdef POLYOBJECTS
-		else if (th->function.acp1 == (actionf_p1)T_PolyObjRotate)
-		{
-			SavePolyrotatetThinker(th, tc_polyrotate);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_PolyObjMove)
-		{
-			SavePolymoveThinker(th, tc_polymove);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_PolyObjWaypoint)
-		{
-			SavePolywaypointThinker(th, tc_polywaypoint);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_PolyDoorSlide)
-		{
-			SavePolyslidedoorThinker(th, tc_polyslidedoor);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_PolyDoorSwing)
-		{
-			SavePolyswingdoorThinker(th, tc_polyswingdoor);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_PolyObjFlag)
-		{
-			SavePolymoveThinker(th, tc_polyflag);
-			continue;
-		}
-		else if (th->function.acp1 == (actionf_p1)T_PolyObjDisplace)
-		{
-			SavePolydisplaceThinker(th, tc_polydisplace);
-			continue;
-		}
-#endif
-#ifdef PARANOIA
-		else if (th->function.acv != P_RemoveThinkerDelayed) // wait garbage collection
-			I_Error("unknown thinker type %p", th->function.acp1);
-#endif
-	}
-
-	CONS_Debug(DBG_NETPLAY, "%u thinkers saved\n", numsaved);
-
-	WRITEUINT8(save_p, tc_end);
-}
-
-// Now save the pointers, tracer and target, but at load time we must
-// relink to this; the savegame contains the old position in the pointer
-// field copyed in the info field temporarily, but finally we just search
-// for the old position and relink to it.
-mobj_t *P_FindNewPosition(UINT32 oldposition)
-{
-	thinker_t *th;
-	mobj_t *mobj;
-
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
-	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+	}
+
+	CONS_Debug(DBG_NETPLAY, "%u thinkers saved\n", numsaved);
+
+	WRITEUINT8(save_p, tc_end);
+}
+
+// mobjnum -> mobj for every mobj loaded from the current netgame, so
+// relinking a pointer is an index instead of a walk of the thinker list.
+// Only exists while P_LoadNetGame runs.
+static mobj_t **mobjnumtable = NULL;
+static UINT32 mobjnumtablesize = 0;
+static UINT32 mobjnumloaded = 0;
+
+static void P_FreeMobjnumTable(void)
+{
+	free(mobjnumtable);
+	mobjnumtable = NULL;
+	mobjnumtablesize = mobjnumloaded = 0;
+}
+
+//
+// P_AddMobjnum
+//
+// Records a mobj as it's loaded. Mobjnums are handed out in thinker order
+// when saving, so the n-th mobj loaded can't have a mobjnum above n;
+// anything bigger is garbage and left out rather than allowed to size the
+// table.
+//
+static void P_AddMobjnum(mobj_t *mobj)
+{
+	mobjnumloaded++;
+
+	// hoops aren't numbered when saving, whatever they hold is stale
+	if (mobj->type == MT_HOOP || mobj->type == MT_HOOPCOLLIDE || mobj->type == MT_HOOPCENTER)
+		return;
+	if (mobj->mobjnum == 0 || mobj->mobjnum > mobjnumloaded)
+		return;
+
+	if (mobj->mobjnum >= mobjnumtablesize)
+	{
+		UINT32 newsize = mobjnumtablesize ? mobjnumtablesize*2 : 1024;
+		while (newsize <= mobj->mobjnum)
+			newsize *= 2;
+		mobjnumtable = realloc(mobjnumtable, newsize * sizeof (*mobjnumtable));
+		if (!mobjnumtable)
+			I_Error("Out of memory relinking savegame mobjs");
+		memset(mobjnumtable + mobjnumtablesize, 0, (newsize - mobjnumtablesize) * sizeof (*mobjnumtable));
+		mobjnumtablesize = newsize;
+	}
+
+	if (!mobjnumtable[mobj->mobjnum])
+		mobjnumtable[mobj->mobjnum] = mobj;
+}
+
+// Now save the pointers, tracer and target, but at load time we must
+// relink to this; the savegame contains the old position in the pointer
+// field copyed in the info field temporarily, but finally we just look
+// up the old position and relink to it.
+mobj_t *P_FindNewPosition(UINT32 oldposition)
+{
+	thinker_t *th;
+	mobj_t *mobj;
+
+	if (mobjnumtable)
+	{
+		if (oldposition < mobjnumtablesize && mobjnumtable[oldposition])
+			return mobjnumtable[oldposition];
+		CONS_Debug(DBG_GAMELOGIC, "mobj not found\n");
+		return NULL;
+	}
+
+	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	{
+		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
 
 		mobj = (mobj_t *)th;
@@ -2149,6 +2107,11 @@ static void LoadMobjThinker(actionf_p1 thinker)
 	P_SetThingPosition(mobj);
 
 	mobj->mobjnum = READUINT32(save_p);
+	P_AddMobjnum(mobj);
+
+	// keep the server's hash, which may be from before the mobj last moved
+	mobj->consistancy = READUINT32(save_p);
+	mobjconsistancy ^= mobj->consistancy;
 
 	if (mobj->player)
 	{
@@ -2159,480 +2122,106 @@ static void LoadMobjThinker(actionf_p1 thinker)
 	}
 
 	P_AddThinker(&mobj->thinker);
+	P_LinkMobjType(mobj);
 
 	mobj->info = (mobjinfo_t *)next; // temporarily, set when leave this function
 }
 
 //
-// LoadSpecialLevelThinker
-//
-// Loads a levelspecthink_t from a save game
+// LoadThinker
 //
-// floorOrCeiling:
-//		0 - Don't set
-//		1 - Floor Only
-//		2 - Ceiling Only
-//		3 - Both
+// Loads any thinker but a mobj from its description.
+// Returns true if it points to mobjs, which are relinked later.
 //
-static void LoadSpecialLevelThinker(actionf_p1 thinker, UINT8 floorOrCeiling)
+static boolean LoadThinker(const UINT8 type)
 {
-	levelspecthink_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	size_t i;
-	ht->thinker.function.acp1 = thinker;
-	for (i = 0; i < 16; i++)
-	{
-		ht->vars[i] = READFIXED(save_p); //var[16]
-		ht->var2s[i] = READFIXED(save_p); //var[16]
-	}
-	ht->sourceline = LoadLine(READUINT32(save_p));
-	ht->sector = LoadSector(READUINT32(save_p));
+	const thinkerclass_t *tc = &thinkerclasses[type];
+	const thinkerfield_t *f;
+	thinker_t *th = Z_Calloc(tc->size, PU_LEVSPEC, NULL);
+	UINT8 *base = (UINT8 *)th;
+	boolean relink = false;
 
-	if (ht->sector)
+	th->function.acp1 = tc->function;
+	for (f = tc->fields; f->type != TF_END; f++)
 	{
-		if (floorOrCeiling & 2)
-			ht->sector->ceilingdata = ht;
-		if (floorOrCeiling & 1)
-			ht->sector->floordata = ht;
+		UINT8 *field = base + f->offset;
+		switch (f->type)
+		{
+			case TF_LONG:
+#ifdef SRB2_BIG_ENDIAN
+			{
+				UINT8 i;
+				for (i = 0; i < f->count; i++)
+					((INT32 *)field)[i] = READINT32(save_p);
+				break;
+			}
+#else
+				M_Memcpy(field, save_p, f->count*4);
+				save_p += f->count*4;
+				break;
+#endif
+			case TF_BYTE:
+				if (f->count == sizeof (UINT32))
+					*(UINT32 *)field = READUINT8(save_p);
+				else if (f->count == sizeof (UINT16))
+					*(UINT16 *)field = READUINT8(save_p);
+				else
+					*field = READUINT8(save_p);
+				break;
+			case TF_SECTOR:
+				*(sector_t **)field = LoadSector(READUINT32(save_p));
+				break;
+			case TF_LINE:
+				*(line_t **)field = LoadLine(READUINT32(save_p));
+				break;
+			case TF_PLAYER:
+				*(player_t **)field = LoadPlayer(READUINT32(save_p));
+				break;
+			case TF_MOBJ:
+				if ((*(mobj_t **)field = LoadMobj(READUINT32(save_p))) != NULL)
+					relink = true;
+				break;
+		}
 	}
 
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadCeilingThinker
-//
-// Loads a ceiling_t from a save game
-//
-static void LoadCeilingThinker(actionf_p1 thinker)
-{
-	ceiling_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->type = READUINT8(save_p);
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->bottomheight = READFIXED(save_p);
-	ht->topheight = READFIXED(save_p);
-	ht->speed = READFIXED(save_p);
-	ht->oldspeed = READFIXED(save_p);
-	ht->delay = READFIXED(save_p);
-	ht->delaytimer = READFIXED(save_p);
-	ht->crush = READUINT8(save_p);
-	ht->texture = READINT32(save_p);
-	ht->direction = READINT32(save_p);
-	ht->tag = READINT32(save_p);
-	ht->olddirection = READINT32(save_p);
-	ht->origspeed = READFIXED(save_p);
-	ht->sourceline = READFIXED(save_p);
-	if (ht->sector)
-		ht->sector->ceilingdata = ht;
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadFloormoveThinker
-//
-// Loads a floormove_t from a save game
-//
-static void LoadFloormoveThinker(actionf_p1 thinker)
-{
-	floormove_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->type = READUINT8(save_p);
-	ht->crush = READUINT8(save_p);
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->direction = READINT32(save_p);
-	ht->texture = READINT32(save_p);
-	ht->floordestheight = READFIXED(save_p);
-	ht->speed = READFIXED(save_p);
-	ht->origspeed = READFIXED(save_p);
-	ht->delay = READFIXED(save_p);
-	ht->delaytimer = READFIXED(save_p);
-	if (ht->sector)
-		ht->sector->floordata = ht;
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadLightflashThinker
-//
-// Loads a lightflash_t from a save game
-//
-static void LoadLightflashThinker(actionf_p1 thinker)
-{
-	lightflash_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->maxlight = READINT32(save_p);
-	ht->minlight = READINT32(save_p);
-	if (ht->sector)
-		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadStrobeThinker
-//
-// Loads a strobe_t from a save game
-//
-static void LoadStrobeThinker(actionf_p1 thinker)
-{
-	strobe_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->count = READINT32(save_p);
-	ht->minlight = READINT32(save_p);
-	ht->maxlight = READINT32(save_p);
-	ht->darktime = READINT32(save_p);
-	ht->brighttime = READINT32(save_p);
-	if (ht->sector)
-		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadGlowThinker
-//
-// Loads a glow_t from a save game
-//
-static void LoadGlowThinker(actionf_p1 thinker)
-{
-	glow_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->minlight = READINT32(save_p);
-	ht->maxlight = READINT32(save_p);
-	ht->direction = READINT32(save_p);
-	ht->speed = READINT32(save_p);
-	if (ht->sector)
-		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
-}
-//
-// LoadFireflickerThinker
-//
-// Loads a fireflicker_t from a save game
-//
-static void LoadFireflickerThinker(actionf_p1 thinker)
-{
-	fireflicker_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->count = READINT32(save_p);
-	ht->resetcount = READINT32(save_p);
-	ht->maxlight = READINT32(save_p);
-	ht->minlight = READINT32(save_p);
-	if (ht->sector)
-		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
-}
-//
-// LoadElevatorThinker
-//
-// Loads a elevator_t from a save game
-//
-static void LoadElevatorThinker(actionf_p1 thinker, UINT8 floorOrCeiling)
-{
-	elevator_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->type = READUINT8(save_p);
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->actionsector = LoadSector(READUINT32(save_p));
-	ht->direction = READINT32(save_p);
-	ht->floordestheight = READFIXED(save_p);
-	ht->ceilingdestheight = READFIXED(save_p);
-	ht->speed = READFIXED(save_p);
-	ht->origspeed = READFIXED(save_p);
-	ht->low = READFIXED(save_p);
-	ht->high = READFIXED(save_p);
-	ht->distance = READFIXED(save_p);
-	ht->delay = READFIXED(save_p);
-	ht->delaytimer = READFIXED(save_p);
-	ht->floorwasheight = READFIXED(save_p);
-	ht->ceilingwasheight = READFIXED(save_p);
-	ht->player = LoadPlayer(READUINT32(save_p)); // was dummy
-	ht->sourceline = LoadLine(READUINT32(save_p));
-
-	if (ht->sector)
+	if (tc->sectordata)
 	{
-		if (floorOrCeiling & 2)
-			ht->sector->ceilingdata = ht;
-		if (floorOrCeiling & 1)
-			ht->sector->floordata = ht;
+		sector_t *sector = *(sector_t **)(base + tc->sectorfield);
+		if (sector)
+		{
+			if (tc->sectordata & TD_CEILING)
+				sector->ceilingdata = th;
+			if (tc->sectordata & TD_FLOOR)
+				sector->floordata = th;
+			if (tc->sectordata & TD_LIGHTING)
+				sector->lightingdata = th;
+		}
 	}
 
-	P_AddThinker(&ht->thinker);
-}
+	if (tc->loaded)
+		tc->loaded(th);
 
-//
-// LoadScrollThinker
-//
-// Loads a scroll_t from a save game
-//
-static void LoadScrollThinker(actionf_p1 thinker)
-{
-	scroll_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->dx = READFIXED(save_p);
-	ht->dy = READFIXED(save_p);
-	ht->affectee = READINT32(save_p);
-	ht->control = READINT32(save_p);
-	ht->last_height = READFIXED(save_p);
-	ht->vdx = READFIXED(save_p);
-	ht->vdy = READFIXED(save_p);
-	ht->accel = READINT32(save_p);
-	ht->exclusive = READINT32(save_p);
-	ht->type = READUINT8(save_p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(th);
+	return relink;
 }
 
 //
-// LoadFrictionThinker
+// RelinkThinker
 //
-// Loads a friction_t from a save game
+// Turns the mobjnums a thinker's TF_MOBJ fields were loaded as back into mobjs
 //
-static inline void LoadFrictionThinker(actionf_p1 thinker)
-{
-	friction_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->friction = READINT32(save_p);
-	ht->movefactor = READINT32(save_p);
-	ht->affectee = READINT32(save_p);
-	ht->referrer = READINT32(save_p);
-	ht->roverfriction = READUINT8(save_p);
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadPusherThinker
-//
-// Loads a pusher_t from a save game
-//
-static void LoadPusherThinker(actionf_p1 thinker)
-{
-	pusher_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->type = READUINT8(save_p);
-	ht->x_mag = READINT32(save_p);
-	ht->y_mag = READINT32(save_p);
-	ht->magnitude = READINT32(save_p);
-	ht->radius = READINT32(save_p);
-	ht->x = READINT32(save_p);
-	ht->y = READINT32(save_p);
-	ht->z = READINT32(save_p);
-	ht->affectee = READINT32(save_p);
-	ht->roverpusher = READUINT8(save_p);
-	ht->referrer = READINT32(save_p);
-	ht->exclusive = READINT32(save_p);
-	ht->slider = READINT32(save_p);
-	ht->source = P_GetPushThing(ht->affectee);
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadLaserThinker
-//
-// Loads a laserthink_t from a save game
-//
-static inline void LoadLaserThinker(actionf_p1 thinker)
-{
-	laserthink_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ffloor_t *rover = NULL;
-	ht->thinker.function.acp1 = thinker;
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->sec = LoadSector(READUINT32(save_p));
-	ht->sourceline = LoadLine(READUINT32(save_p));
-	for (rover = ht->sector->ffloors; rover; rover = rover->next)
-		if (rover->secnum == (size_t)(ht->sec - sectors)
-		&& rover->master == ht->sourceline)
-			ht->ffloor = rover;
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadLightlevelThinker
-//
-// Loads a lightlevel_t from a save game
-//
-static inline void LoadLightlevelThinker(actionf_p1 thinker)
-{
-	lightlevel_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->destlevel = READINT32(save_p);
-	ht->speed = READINT32(save_p);
-	if (ht->sector)
-		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadExecutorThinker
-//
-// Loads a executor_t from a save game
-//
-static inline void LoadExecutorThinker(actionf_p1 thinker)
-{
-	executor_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->line = LoadLine(READUINT32(save_p));
-	ht->caller = LoadMobj(READUINT32(save_p));
-	ht->sector = LoadSector(READUINT32(save_p));
-	ht->timer = READINT32(save_p);
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadDisappearThinker
-//
-// Loads a disappear_t thinker
-//
-static inline void LoadDisappearThinker(actionf_p1 thinker)
-{
-	disappear_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->appeartime = READUINT32(save_p);
-	ht->disappeartime = READUINT32(save_p);
-	ht->offset = READUINT32(save_p);
-	ht->timer = READUINT32(save_p);
-	ht->affectee = READINT32(save_p);
-	ht->sourceline = READINT32(save_p);
-	ht->exists = READINT32(save_p);
-	P_AddThinker(&ht->thinker);
-}
-
-#ifdef POLYOBJECTS
-
-//
-// LoadPolyrotateThinker
-//
-// Loads a polyrotate_t thinker
-//
-static inline void LoadPolyrotatetThinker(actionf_p1 thinker)
-{
-	polyrotate_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->polyObjNum = READINT32(save_p);
-	ht->speed = READINT32(save_p);
-	ht->distance = READINT32(save_p);
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadPolymoveThinker
-//
-// Loads a polymovet_t thinker
-//
-static void LoadPolymoveThinker(actionf_p1 thinker)
-{
-	polymove_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->polyObjNum = READINT32(save_p);
-	ht->speed = READINT32(save_p);
-	ht->momx = READFIXED(save_p);
-	ht->momy = READFIXED(save_p);
-	ht->distance = READINT32(save_p);
-	ht->angle = READANGLE(save_p);
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadPolywaypointThinker
-//
-// Loads a polywaypoint_t thinker
-//
-static inline void LoadPolywaypointThinker(actionf_p1 thinker)
-{
-	polywaypoint_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->polyObjNum = READINT32(save_p);
-	ht->speed = READINT32(save_p);
-	ht->sequence = READINT32(save_p);
-	ht->pointnum = READINT32(save_p);
-	ht->direction = READINT32(save_p);
-	ht->comeback = READUINT8(save_p);
-	ht->wrap = READUINT8(save_p);
-	ht->continuous = READUINT8(save_p);
-	ht->stophere = READUINT8(save_p);
-	ht->diffx = READFIXED(save_p);
-	ht->diffy = READFIXED(save_p);
-	ht->diffz = READFIXED(save_p);
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadPolyslidedoorThinker
-//
-// loads a polyslidedoor_t thinker
-//
-static inline void LoadPolyslidedoorThinker(actionf_p1 thinker)
-{
-	polyslidedoor_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->polyObjNum = READINT32(save_p);
-	ht->delay = READINT32(save_p);
-	ht->delayCount = READINT32(save_p);
-	ht->initSpeed = READINT32(save_p);
-	ht->speed = READINT32(save_p);
-	ht->initDistance = READINT32(save_p);
-	ht->distance = READINT32(save_p);
-	ht->initAngle = READUINT32(save_p);
-	ht->angle = READUINT32(save_p);
-	ht->revAngle = READUINT32(save_p);
-	ht->momx = READFIXED(save_p);
-	ht->momy = READFIXED(save_p);
-	ht->closing = READUINT8(save_p);
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadPolyswingdoorThinker
-//
-// Loads a polyswingdoor_t thinker
-//
-static inline void LoadPolyswingdoorThinker(actionf_p1 thinker)
-{
-	polyswingdoor_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->polyObjNum = READINT32(save_p);
-	ht->delay = READINT32(save_p);
-	ht->delayCount = READINT32(save_p);
-	ht->initSpeed = READINT32(save_p);
-	ht->speed = READINT32(save_p);
-	ht->initDistance = READINT32(save_p);
-	ht->distance = READINT32(save_p);
-	ht->closing = READUINT8(save_p);
-	P_AddThinker(&ht->thinker);
-}
-
-//
-// LoadPolydisplaceThinker
-//
-// Loads a polydisplace_t thinker
-//
-static inline void LoadPolydisplaceThinker(actionf_p1 thinker)
-{
-	polydisplace_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
-	ht->polyObjNum = READINT32(save_p);
-	ht->controlSector = LoadSector(READUINT32(save_p));
-	ht->dx = READFIXED(save_p);
-	ht->dy = READFIXED(save_p);
-	ht->oldHeights = READFIXED(save_p);
-	P_AddThinker(&ht->thinker);
-}
-#endif
-
-/*
-//
-// LoadWhatThinker
-//
-// load a what_t thinker
-//
-static inline void LoadWhatThinker(actionf_p1 thinker)
+static void RelinkThinker(thinker_t *th, const UINT8 type)
 {
-	what_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
-	ht->thinker.function.acp1 = thinker;
+	const thinkerfield_t *f;
+	for (f = thinkerclasses[type].fields; f->type != TF_END; f++)
+		if (f->type == TF_MOBJ)
+		{
+			mobj_t **field = (mobj_t **)((UINT8 *)th + f->offset);
+			UINT32 mobjnum = (UINT32)(size_t)*field;
+			if (mobjnum)
+				*field = P_FindNewPosition(mobjnum);
+		}
 }
-*/
 
 //
 // P_NetUnArchiveThinkers
@@ -2680,175 +2269,24 @@ static void P_NetUnArchiveThinkers(void)
 			break; // leave the saved thinker reading loop
 		numloaded++;
 
-		switch (tclass)
-		{
-			case tc_mobj:
-				LoadMobjThinker((actionf_p1)P_MobjThinker);
-				break;
-
-			case tc_ceiling:
-				LoadCeilingThinker((actionf_p1)T_MoveCeiling);
-				break;
-
-			case tc_crushceiling:
-				LoadCeilingThinker((actionf_p1)T_CrushCeiling);
-				break;
-
-			case tc_floor:
-				LoadFloormoveThinker((actionf_p1)T_MoveFloor);
-				break;
-
-			case tc_flash:
-				LoadLightflashThinker((actionf_p1)T_LightningFlash);
-				break;
-
-			case tc_strobe:
-				LoadStrobeThinker((actionf_p1)T_StrobeFlash);
-				break;
-
-			case tc_glow:
-				LoadGlowThinker((actionf_p1)T_Glow);
-				break;
-
-			case tc_fireflicker:
-				LoadFireflickerThinker((actionf_p1)T_FireFlicker);
-				break;
-
-			case tc_elevator:
-				LoadElevatorThinker((actionf_p1)T_MoveElevator, 3);
-				break;
-
-			case tc_continuousfalling:
-				LoadSpecialLevelThinker((actionf_p1)T_ContinuousFalling, 3);
-				break;
-
-			case tc_thwomp:
-				LoadSpecialLevelThinker((actionf_p1)T_ThwompSector, 3);
-				break;
-
-			case tc_noenemies:
-				LoadSpecialLevelThinker((actionf_p1)T_NoEnemiesSector, 0);
-				break;
-
-			case tc_eachtime:
-				LoadSpecialLevelThinker((actionf_p1)T_EachTimeThinker, 0);
-				break;
-
-			case tc_raisesector:
-				LoadSpecialLevelThinker((actionf_p1)T_RaiseSector, 0);
-				break;
-
-			/// \todo rewrite all the code that uses an elevator_t but isn't an elevator
-			/// \note working on it!
-			case tc_camerascanner:
-				LoadElevatorThinker((actionf_p1)T_CameraScanner, 0);
-				break;
-
-			case tc_bouncecheese:
-				LoadSpecialLevelThinker((actionf_p1)T_BounceCheese, 2);
-				break;
-
-			case tc_startcrumble:
-				LoadElevatorThinker((actionf_p1)T_StartCrumble, 1);
-				break;
-
-			case tc_marioblock:
-				LoadSpecialLevelThinker((actionf_p1)T_MarioBlock, 3);
-				break;
-
-			case tc_marioblockchecker:
-				LoadSpecialLevelThinker((actionf_p1)T_MarioBlockChecker, 0);
-				break;
-
-			case tc_spikesector:
-				LoadSpecialLevelThinker((actionf_p1)T_SpikeSector, 0);
-				break;
-
-			case tc_floatsector:
-				LoadSpecialLevelThinker((actionf_p1)T_FloatSector, 0);
-				break;
-
-			case tc_bridgethinker:
-				LoadSpecialLevelThinker((actionf_p1)T_BridgeThinker, 3);
-				break;
-
-			case tc_laserflash:
-				LoadLaserThinker((actionf_p1)T_LaserFlash);
-				break;
-
-			case tc_lightfade:
-				LoadLightlevelThinker((actionf_p1)T_LightFade);
-				break;
-
-			case tc_executor:
-				LoadExecutorThinker((actionf_p1)T_ExecutorDelay);
-				restoreNum = true;
-				break;
-
-			case tc_disappear:
-				LoadDisappearThinker((actionf_p1)T_Disappear);
-				break;
-#ifdef POLYOBJECTS
-			case tc_polyrotate:
-				LoadPolyrotatetThinker((actionf_p1)T_PolyObjRotate);
-				break;
-
-			case tc_polymove:
-				LoadPolymoveThinker((actionf_p1)T_PolyObjMove);
-				break;
-
-			case tc_polywaypoint:
-				LoadPolywaypointThinker((actionf_p1)T_PolyObjWaypoint);
-				break;
-
-			case tc_polyslidedoor:
-				LoadPolyslidedoorThinker((actionf_p1)T_PolyDoorSlide);
-				break;
-
-			case tc_polyswingdoor:
-				LoadPolyswingdoorThinker((actionf_p1)T_PolyDoorSwing);
-				break;
-
-			case tc_polyflag:
-				LoadPolymoveThinker((actionf_p1)T_PolyObjFlag);
-				break;
-
-			case tc_polydisplace:
-				LoadPolydisplaceThinker((actionf_p1)T_PolyObjDisplace);
-				break;
-#endif
-			case tc_scroll:
-				LoadScrollThinker((actionf_p1)T_Scroll);
-				break;
-
-			case tc_friction:
-				LoadFrictionThinker((actionf_p1)T_Friction);
-				break;
-
-			case tc_pusher:
-				LoadPusherThinker((actionf_p1)T_Pusher);
-				break;
-
-			default:
-				I_Error("P_UnarchiveSpecials: Unknown tclass %d in savegame", tclass);
-		}
+		if (tclass == tc_mobj)
+			LoadMobjThinker((actionf_p1)P_MobjThinker);
+		else if (tclass < tc_end)
+			restoreNum |= LoadThinker(tclass);
+		else
+			I_Error("P_UnarchiveSpecials: Unknown tclass %d in savegame", tclass);
 	}
 
 	CONS_Debug(DBG_NETPLAY, "%u thinkers loaded\n", numloaded);
 
 	if (restoreNum)
 	{
-		executor_t *delay = NULL;
-		UINT32 mobjnum;
 		for (currentthinker = thinkercap.next; currentthinker != &thinkercap;
 			currentthinker = currentthinker->next)
 		{
-			if (currentthinker->function.acp1 == (actionf_p1)T_ExecutorDelay)
-			{
-				delay = (void *)currentthinker;
-				if ((mobjnum = (UINT32)(size_t)delay->caller))
-					delay->caller = P_FindNewPosition(mobjnum);
-			}
+			tclass = ThinkerClass(currentthinker->function.acp1);
+			if (tclass != tc_mobj && tclass != tc_end)
+				RelinkThinker(currentthinker, tclass);
 		}
 	}
 }
@@ -2928,7 +2366,10 @@ static inline void P_ArchivePolyObjects(void)
 	WRITEINT32(save_p, numPolyObjects);
 
 	for (i = 0; i < numPolyObjects; ++i)
+	{
+		P_SaveReserve(SAVERECORDSIZE);
 		P_ArchivePolyObj(&PolyObjects[i]);
+	}
 }
 
 static inline void P_UnArchivePolyObjects(void)
@@ -3051,12 +2492,14 @@ static inline void P_NetArchiveSpecials(void)
 {
 	size_t i, z;
 
+	P_SaveReserve(SAVERECORDSIZE);
 	WRITEUINT32(save_p, ARCHIVEBLOCK_SPECIALS);
 
 	// itemrespawn queue for deathmatch
 	i = iquetail;
 	while (iquehead != i)
 	{
+		P_SaveReserve(8);
 		for (z = 0; z < nummapthings; z++)
 		{
 			if (&mapthings[z] == itemrespawnque[i])
@@ -3193,6 +2636,7 @@ static void P_NetArchiveMisc(void)
 	UINT32 pig = 0;
 	INT32 i;
 
+	P_SaveReserve(SAVERECORDSIZE);
 	WRITEUINT32(save_p, ARCHIVEBLOCK_MISC);
 
 	WRITEINT16(save_p, gamemap);
@@ -3392,6 +2836,7 @@ boolean P_LoadGame(INT16 mapoverride)
 
 boolean P_LoadNetGame(void)
 {
+	P_FreeMobjnumTable(); // in case an earlier load was cut short
 	CV_LoadNetVars(&save_p);
 	if (!P_NetUnArchiveMisc())
 		return false;
@@ -3410,6 +2855,7 @@ boolean P_LoadNetGame(void)
 #ifdef HAVE_BLUA
 	LUA_UnArchive();
 #endif
+	P_FreeMobjnumTable();
 
 	// This is stupid and hacky, but maybe it'll work!
 	P_SetRandSeed(P_GetInitSeed());
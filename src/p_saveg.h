@@ -43,4 +43,23 @@ typedef struct
 extern savedata_t savedata;
 extern UINT8 *save_p;
 
+// A netgame savegame is written into a chain of pages, so it has no
+// size limit. Records never straddle two pages: P_SaveReserve moves
+// save_p to a new page when the next one might not fit.
+#define SAVEPAGESIZE (64*1024)
+#define SAVERECORDSIZE 2048 // Enough for any one player, thinker, sector...
+
+typedef struct savepage_s
+{
+	struct savepage_s *next;
+	size_t size; // Room in data
+	size_t length; // How much of it is used
+	UINT8 data[1];
+} savepage_t;
+
+void P_BeginSave(void);
+void P_SaveReserve(size_t size);
+savepage_t *P_EndSave(size_t *length);
+void P_FreeSave(savepage_t *pages);
+
 #endif
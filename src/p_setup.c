@@ -394,9 +394,9 @@ static inline void P_LoadRawVertexes(UINT8 *data, size_t i)
 
 static inline void P_LoadVertexes(lumpnum_t lumpnum)
 {
-	UINT8 *data = W_CacheLumpNum(lumpnum, PU_STATIC);
+	UINT8 *data = W_ViewLumpNum(lumpnum);
 	P_LoadRawVertexes(data, W_LumpLength(lumpnum));
-	Z_Free(data);
+	W_ReleaseLumpView(lumpnum, data);
 }
 
 /** Computes the length of a seg in fracunits.
@@ -485,9 +485,9 @@ static void P_LoadRawSegs(UINT8 *data, size_t i)
 
 static void P_LoadSegs(lumpnum_t lumpnum)
 {
-	UINT8 *data = W_CacheLumpNum(lumpnum, PU_STATIC);
+	UINT8 *data = W_ViewLumpNum(lumpnum);
 	P_LoadRawSegs(data, W_LumpLength(lumpnum));
-	Z_Free(data);
+	W_ReleaseLumpView(lumpnum, data);
 }
 
 
@@ -522,9 +522,9 @@ static inline void P_LoadRawSubsectors(void *data, size_t i)
 
 static void P_LoadSubsectors(lumpnum_t lumpnum)
 {
-	UINT8 *data = W_CacheLumpNum(lumpnum, PU_STATIC);
+	UINT8 *data = W_ViewLumpNum(lumpnum);
 	P_LoadRawSubsectors(data, W_LumpLength(lumpnum));
-	Z_Free(data);
+	W_ReleaseLumpView(lumpnum, data);
 }
 
 //
@@ -766,9 +766,9 @@ static void P_LoadRawSectors(UINT8 *data, size_t i)
 
 static void P_LoadSectors(lumpnum_t lumpnum)
 {
-	UINT8 *data = W_CacheLumpNum(lumpnum, PU_STATIC);
+	UINT8 *data = W_ViewLumpNum(lumpnum);
 	P_LoadRawSectors(data, W_LumpLength(lumpnum));
-	Z_Free(data);
+	W_ReleaseLumpView(lumpnum, data);
 }
 
 //
@@ -805,9 +805,9 @@ static void P_LoadRawNodes(UINT8 *data, size_t i)
 
 static void P_LoadNodes(lumpnum_t lumpnum)
 {
-	UINT8 *data = W_CacheLumpNum(lumpnum, PU_STATIC);
+	UINT8 *data = W_ViewLumpNum(lumpnum);
 	P_LoadRawNodes(data, W_LumpLength(lumpnum));
-	Z_Free(data);
+	W_ReleaseLumpView(lumpnum, data);
 }
 
 //
@@ -979,9 +979,9 @@ static void P_PrepareRawThings(UINT8 *data, size_t i)
 
 static void P_PrepareThings(lumpnum_t lumpnum)
 {
-	UINT8 *data = W_CacheLumpNum(lumpnum, PU_STATIC);
+	UINT8 *data = W_ViewLumpNum(lumpnum);
 	P_PrepareRawThings(data, W_LumpLength(lumpnum));
-	Z_Free(data);
+	W_ReleaseLumpView(lumpnum, data);
 }
 
 static void P_LoadThings(void)
@@ -1277,9 +1277,9 @@ static void P_LoadRawLineDefs(UINT8 *data, size_t i)
 
 static void P_LoadLineDefs(lumpnum_t lumpnum)
 {
-	UINT8 *data = W_CacheLumpNum(lumpnum, PU_STATIC);
+	UINT8 *data = W_ViewLumpNum(lumpnum);
 	P_LoadRawLineDefs(data, W_LumpLength(lumpnum));
-	Z_Free(data);
+	W_ReleaseLumpView(lumpnum, data);
 }
 
 static void P_LoadLineDefs2(void)
@@ -1649,9 +1649,9 @@ static void P_LoadRawSideDefs2(void *data)
 // Delay loading texture names until after loaded linedefs.
 static void P_LoadSideDefs2(lumpnum_t lumpnum)
 {
-	UINT8 *data = W_CacheLumpNum(lumpnum, PU_STATIC);
+	UINT8 *data = W_ViewLumpNum(lumpnum);
 	P_LoadRawSideDefs2(data);
-	Z_Free(data);
+	W_ReleaseLumpView(lumpnum, data);
 }
 
 
@@ -3721,7 +3721,6 @@ void P_ProcessSpecialSector(player_t *player, sector_t *sector, sector_t *rovers
 			break;
 		case 9: // Egg trap capsule
 		{
-			thinker_t *th;
 			mobj_t *mo2;
 			line_t junk;
 
@@ -3730,14 +3729,12 @@ void P_ProcessSpecialSector(player_t *player, sector_t *sector, sector_t *rovers
 
 			// Find the center of the Eggtrap and release all the pretty animals!
 			// The chimps are my friends.. heeheeheheehehee..... - LouisJM
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (mo2 = mobjtypelist[MT_EGGTRAP]; mo2; mo2 = mo2->tnext)
 			{
-				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+				if (P_MobjWasRemoved(mo2))
 					continue;
 
-				mo2 = (mobj_t *)th;
-				if (mo2->type == MT_EGGTRAP)
-					P_KillMobj(mo2, NULL, player->mo);
+				P_KillMobj(mo2, NULL, player->mo);
 			}
 
 			// clear the special so you can't push the button twice.
@@ -3994,7 +3991,6 @@ DoneSection2:
 				INT32 sequence;
 				fixed_t speed;
 				INT32 lineindex;
-				thinker_t *th;
 				mobj_t *waypoint = NULL;
 				mobj_t *mo2;
 				angle_t an;
@@ -4015,17 +4011,14 @@ DoneSection2:
 				speed = abs(lines[lineindex].dx)/8;
 				sequence = abs(lines[lineindex].dy)>>FRACBITS;
 
-				// scan the thinkers
-				// to find the first waypoint
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				// scan the waypoints
+				// to find the first one
+				for (mo2 = mobjtypelist[MT_TUBEWAYPOINT]; mo2; mo2 = mo2->tnext)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+					if (P_MobjWasRemoved(mo2))
 						continue;
 
-					mo2 = (mobj_t *)th;
-
-					if (mo2->type == MT_TUBEWAYPOINT && mo2->threshold == sequence
-						&& mo2->health == 0)
+					if (mo2->threshold == sequence && mo2->health == 0)
 					{
 						waypoint = mo2;
 						break;
@@ -4067,7 +4060,6 @@ DoneSection2:
 				INT32 sequence;
 				fixed_t speed;
 				INT32 lineindex;
-				thinker_t *th;
 				mobj_t *waypoint = NULL;
 				mobj_t *mo2;
 				angle_t an;
@@ -4088,16 +4080,14 @@ DoneSection2:
 				speed = -(abs(lines[lineindex].dx)/8); // Negative means reverse
 				sequence = abs(lines[lineindex].dy)>>FRACBITS;
 
-				// scan the thinkers
-				// to find the last waypoint
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				// scan the waypoints
+				// to find the last one
+				for (mo2 = mobjtypelist[MT_TUBEWAYPOINT]; mo2; mo2 = mo2->tnext)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+					if (P_MobjWasRemoved(mo2))
 						continue;
 
-					mo2 = (mobj_t *)th;
-
-					if (mo2->type == MT_TUBEWAYPOINT && mo2->threshold == sequence)
+					if (mo2->threshold == sequence)
 					{
 						if (!waypoint)
 							waypoint = mo2;
@@ -4184,7 +4174,6 @@ DoneSection2:
 				INT32 sequence;
 				fixed_t speed;
 				INT32 lineindex;
-				thinker_t *th;
 				mobj_t *waypointmid = NULL;
 				mobj_t *waypointhigh = NULL;
 				mobj_t *waypointlow = NULL;
@@ -4232,16 +4221,11 @@ DoneSection2:
 				// Determine the closest spot on the line between the three waypoints
 				// Put player at that location.
 
-				// scan the thinkers
+				// scan the waypoints
 				// to find the first waypoint
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (mo2 = mobjtypelist[MT_TUBEWAYPOINT]; mo2; mo2 = mo2->tnext)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-						continue;
-
-					mo2 = (mobj_t *)th;
-
-					if (mo2->type != MT_TUBEWAYPOINT)
+					if (P_MobjWasRemoved(mo2))
 						continue;
 
 					if (mo2->threshold != sequence)
@@ -4272,14 +4256,9 @@ DoneSection2:
 				}
 
 				// Find waypoint before this one (waypointlow)
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (mo2 = mobjtypelist[MT_TUBEWAYPOINT]; mo2; mo2 = mo2->tnext)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-						continue;
-
-					mo2 = (mobj_t *)th;
-
-					if (mo2->type != MT_TUBEWAYPOINT)
+					if (P_MobjWasRemoved(mo2))
 						continue;
 
 					if (mo2->threshold != sequence)
@@ -4299,14 +4278,9 @@ DoneSection2:
 				}
 
 				// Find waypoint after this one (waypointhigh)
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (mo2 = mobjtypelist[MT_TUBEWAYPOINT]; mo2; mo2 = mo2->tnext)
 				{
-					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-						continue;
-
-					mo2 = (mobj_t *)th;
-
-					if (mo2->type != MT_TUBEWAYPOINT)
+					if (P_MobjWasRemoved(mo2))
 						continue;
 
 					if (mo2->threshold != sequence)
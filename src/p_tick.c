@@ -21,12 +21,30 @@
 #include "m_random.h"
 #include "lua_script.h"
 #include "lua_hook.h"
+#include "i_system.h" // I_GetTimeMicros
 
 // Object place
 #include "m_cheat.h"
 
 tic_t leveltime;
 
+// Per-phase profiling of P_Ticker, only done while tickphasetiming is set
+boolean tickphasetiming = false;
+UINT32 tickphasetime[NUMTICKPHASES];
+static UINT64 tickphasestart;
+
+static inline void P_StartTickPhase(void)
+{
+	if (tickphasetiming)
+		tickphasestart = I_GetTimeMicros();
+}
+
+static inline void P_EndTickPhase(tickphase_t phase)
+{
+	if (tickphasetiming)
+		tickphasetime[phase] += (UINT32)(I_GetTimeMicros() - tickphasestart);
+}
+
 //
 // THINKERS
 // All thinkers should be allocated by Z_Calloc
@@ -179,6 +197,8 @@ void Command_CountMobjs_f(void)
 void P_InitThinkers(void)
 {
 	thinkercap.prev = thinkercap.next = &thinkercap;
+	memset(mobjtypelist, 0, sizeof (mobjtypelist));
+	mobjconsistancy = 0;
 }
 
 //
@@ -601,39 +621,52 @@ void P_Ticker(boolean run)
 		if (demoplayback)
 			G_ReadDemoTiccmd(&players[consoleplayer].cmd, 0);
 
+		P_StartTickPhase();
 		for (i = 0; i < MAXPLAYERS; i++)
 			if (playeringame[i] && players[i].mo && !P_MobjWasRemoved(players[i].mo))
 				P_PlayerThink(&players[i]);
+		P_EndTickPhase(TICKPHASE_PLAYERTHINK);
 	}
 
 	// Keep track of how long they've been playing!
 	if (!demoplayback) // Don't increment if a demo is playing.
 		totalplaytime++;
 
+	P_StartTickPhase();
 	if (!useNightsSS && G_IsSpecialStage(gamemap))
 		P_DoSpecialStageStuff();
 
 	if (runemeraldmanager)
 		P_EmeraldManager(); // Power stone mode
+	P_EndTickPhase(TICKPHASE_SPECIALS);
 
 	if (run)
 	{
+		P_StartTickPhase();
 		P_RunThinkers();
+		P_EndTickPhase(TICKPHASE_THINKERS);
 
 		// Run any "after all the other thinkers" stuff
+		P_StartTickPhase();
 		for (i = 0; i < MAXPLAYERS; i++)
 			if (playeringame[i] && players[i].mo && !P_MobjWasRemoved(players[i].mo))
 				P_PlayerAfterThink(&players[i]);
+		P_EndTickPhase(TICKPHASE_PLAYERTHINK);
 
 #ifdef HAVE_BLUA
+		P_StartTickPhase();
 		LUAh_ThinkFrame();
+		P_EndTickPhase(TICKPHASE_LUA);
 #endif
 	}
 
 	// Run shield positioning
+	P_StartTickPhase();
 	P_RunShields();
 	P_RunOverlays();
+	P_EndTickPhase(TICKPHASE_THINKERS);
 
+	P_StartTickPhase();
 	P_UpdateSpecials();
 	P_RespawnSpecials();
 
@@ -649,6 +682,7 @@ void P_Ticker(boolean run)
 
 	if (G_GametypeHasTeams())
 		P_DoCTFStuff();
+	P_EndTickPhase(TICKPHASE_SPECIALS);
 
 	if (run)
 	{
@@ -686,6 +720,7 @@ void P_Ticker(boolean run)
 		else
 			quake.x = quake.y = quake.z = 0;
 
+		P_StartTickPhase();
 		if (metalplayback)
 			G_ReadMetalTic(metalplayback);
 		if (metalrecording)
@@ -696,6 +731,7 @@ void P_Ticker(boolean run)
 			G_ConsGhostTic();
 		if (modeattacking)
 			G_GhostTicker();
+		P_EndTickPhase(TICKPHASE_GHOSTS);
 	}
 
 	P_MapEnd();
@@ -20,6 +20,20 @@
 
 extern tic_t leveltime;
 
+// Phases of P_Ticker timed separately by the simulation benchmark (-simbench)
+typedef enum
+{
+	TICKPHASE_PLAYERTHINK, // P_PlayerThink and P_PlayerAfterThink
+	TICKPHASE_THINKERS,    // P_RunThinkers, shields and overlays
+	TICKPHASE_LUA,         // LUAh_ThinkFrame
+	TICKPHASE_SPECIALS,    // sector specials, respawns, precipitation, gametype stuff
+	TICKPHASE_GHOSTS,      // metal sonic, demo ghosts
+	NUMTICKPHASES
+} tickphase_t;
+
+extern boolean tickphasetiming;
+extern UINT32 tickphasetime[NUMTICKPHASES]; // microseconds spent in each phase since last cleared
+
 // Called by G_Ticker. Carries out all thinking of enemies and players.
 void Command_Numthinkers_f(void);
 void Command_CountMobjs_f(void);
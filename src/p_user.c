@@ -343,23 +343,20 @@ void P_ResetScore(player_t *player)
 //
 UINT8 P_FindLowestMare(void)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	UINT8 mare = UINT8_MAX;
 
 	if (gametype == GT_RACE || gametype == GT_COMPETITION)
 		return 0;
 
-	// scan the thinkers
-	// to find the egg capsule with the lowest mare
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the egg capsules
+	// to find the one with the lowest mare
+	for (mo2 = mobjtypelist[MT_EGGCAPSULE]; mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_EGGCAPSULE && mo2->health > 0)
+		if (mo2->health > 0)
 		{
 			const UINT8 threshold = (UINT8)mo2->threshold;
 			if (mare == 255)
@@ -383,7 +380,6 @@ UINT8 P_FindLowestMare(void)
 //
 boolean P_TransferToNextMare(player_t *player)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis = NULL;
 	INT32 lowestaxisnum = -1;
@@ -397,35 +393,30 @@ boolean P_TransferToNextMare(player_t *player)
 
 	player->mare = mare;
 
-	// scan the thinkers
-	// to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the axis points
+	// to find the closest one
+	for (mo2 = mobjtypelist[MT_AXIS]; mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_AXIS)
+		if (mo2->threshold == mare)
 		{
-			if (mo2->threshold == mare)
+			if (closestaxis == NULL)
 			{
-				if (closestaxis == NULL)
+				closestaxis = mo2;
+				lowestaxisnum = mo2->health;
+				dist2 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
+			}
+			else if (mo2->health < lowestaxisnum)
+			{
+				dist1 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
+
+				if (dist1 < dist2)
 				{
 					closestaxis = mo2;
 					lowestaxisnum = mo2->health;
-					dist2 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
-				}
-				else if (mo2->health < lowestaxisnum)
-				{
-					dist1 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
-
-					if (dist1 < dist2)
-					{
-						closestaxis = mo2;
-						lowestaxisnum = mo2->health;
-						dist2 = dist1;
-					}
+					dist2 = dist1;
 				}
 			}
 		}
@@ -445,27 +436,21 @@ boolean P_TransferToNextMare(player_t *player)
 // the mobj for that axis point.
 static mobj_t *P_FindAxis(INT32 mare, INT32 axisnum)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
-	// scan the thinkers
-	// to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the axis points
+	// to find the closest one
+	for (mo2 = mobjtypelist[MT_AXIS]; mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-
-		// Axis things are only at beginning of list.
+		// only the map's own axis things, as set up by P_SpawnMapThing
 		if (!(mo2->flags2 & MF2_AXIS))
-			return NULL;
+			continue;
 
-		if (mo2->type == MT_AXIS)
-		{
-			if (mo2->health == axisnum && mo2->threshold == mare)
-				return mo2;
-		}
+		if (mo2->health == axisnum && mo2->threshold == mare)
+			return mo2;
 	}
 
 	return NULL;
@@ -478,27 +463,20 @@ static mobj_t *P_FindAxis(INT32 mare, INT32 axisnum)
 // the mobj for that axis transfer point.
 static mobj_t *P_FindAxisTransfer(INT32 mare, INT32 axisnum, mobjtype_t type)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
-	// scan the thinkers
-	// to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the axis transfer points
+	for (mo2 = mobjtypelist[type]; mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-
-		// Axis things are only at beginning of list.
+		// only the map's own axis things, as set up by P_SpawnMapThing
 		if (!(mo2->flags2 & MF2_AXIS))
-			return NULL;
+			continue;
 
-		if (mo2->type == type)
-		{
-			if (mo2->health == axisnum && mo2->threshold == mare)
-				return mo2;
-		}
+		if (mo2->health == axisnum && mo2->threshold == mare)
+			return mo2;
 	}
 
 	return NULL;
@@ -510,7 +488,6 @@ static mobj_t *P_FindAxisTransfer(INT32 mare, INT32 axisnum, mobjtype_t type)
 // Finds the CLOSEST axis with the number specified.
 void P_TransferToAxis(player_t *player, INT32 axisnum)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis;
 	INT32 mare = player->mare;
@@ -520,33 +497,28 @@ void P_TransferToAxis(player_t *player, INT32 axisnum)
 
 	closestaxis = NULL;
 
-	// scan the thinkers
-	// to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// scan the axis points
+	// to find the closest one
+	for (mo2 = mobjtypelist[MT_AXIS]; mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_AXIS)
+		if (mo2->health == axisnum && mo2->threshold == mare)
 		{
-			if (mo2->health == axisnum && mo2->threshold == mare)
+			if (closestaxis == NULL)
 			{
-				if (closestaxis == NULL)
+				closestaxis = mo2;
+				dist2 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
+			}
+			else
+			{
+				dist1 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
+
+				if (dist1 < dist2)
 				{
 					closestaxis = mo2;
-					dist2 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
-				}
-				else
-				{
-					dist1 = R_PointToDist2(player->mo->x, player->mo->y, mo2->x, mo2->y)-mo2->radius;
-
-					if (dist1 < dist2)
-					{
-						closestaxis = mo2;
-						dist2 = dist1;
-					}
+					dist2 = dist1;
 				}
 			}
 		}
@@ -571,7 +543,6 @@ void P_TransferToAxis(player_t *player, INT32 axisnum)
 //
 static void P_DeNightserizePlayer(player_t *player)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
 	player->pflags &= ~PF_NIGHTSMODE;
@@ -620,13 +591,9 @@ static void P_DeNightserizePlayer(player_t *player)
 	}
 
 	// Check to see if the player should be killed.
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (mo2 = mobjtypelist[MT_NIGHTSDRONE]; mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
-
-		mo2 = (mobj_t *)th;
-		if (!(mo2->type == MT_NIGHTSDRONE))
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
 		if (mo2->flags2 & MF2_AMBUSH)
@@ -1341,7 +1308,6 @@ boolean P_IsLocalPlayer(player_t *player)
 void P_SpawnShieldOrb(player_t *player)
 {
 	mobjtype_t orbtype;
-	thinker_t *th;
 	mobj_t *shieldobj, *ov;
 
 #ifdef PARANOIA
@@ -1372,15 +1338,13 @@ void P_SpawnShieldOrb(player_t *player)
 		return;
 	}
 
-	// blaze through the thinkers to see if an orb already exists!
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// blaze through the orbs to see if one already exists!
+	for (shieldobj = mobjtypelist[orbtype]; shieldobj; shieldobj = shieldobj->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(shieldobj))
 			continue;
 
-		shieldobj = (mobj_t *)th;
-
-		if (shieldobj->type == orbtype && shieldobj->target == player->mo)
+		if (shieldobj->target == player->mo)
 			P_RemoveMobj(shieldobj); //kill the old one(s)
 	}
 
@@ -5526,7 +5490,6 @@ static void P_NiGHTSMovement(player_t *player)
 	boolean still = false, moved = false, backwardaxis = false, firstdrill;
 	INT16 newangle = 0;
 	fixed_t xspeed, yspeed;
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis = NULL;
 	fixed_t newx, newy, radius;
@@ -5606,33 +5569,28 @@ static void P_NiGHTSMovement(player_t *player)
 	{
 		fixed_t dist1, dist2 = 0;
 
-		// scan the thinkers
-		// to find the closest axis point
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		// scan the axis points
+		// to find the closest one
+		for (mo2 = mobjtypelist[MT_AXIS]; mo2; mo2 = mo2->tnext)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+			if (P_MobjWasRemoved(mo2))
 				continue;
 
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type == MT_AXIS)
+			if (mo2->threshold == player->mare)
 			{
-				if (mo2->threshold == player->mare)
+				if (closestaxis == NULL)
 				{
-					if (closestaxis == NULL)
+					closestaxis = mo2;
+					dist2 = R_PointToDist2(newx, newy, mo2->x, mo2->y)-mo2->radius;
+				}
+				else
+				{
+					dist1 = R_PointToDist2(newx, newy, mo2->x, mo2->y)-mo2->radius;
+
+					if (dist1 < dist2)
 					{
 						closestaxis = mo2;
-						dist2 = R_PointToDist2(newx, newy, mo2->x, mo2->y)-mo2->radius;
-					}
-					else
-					{
-						dist1 = R_PointToDist2(newx, newy, mo2->x, mo2->y)-mo2->radius;
-
-						if (dist1 < dist2)
-						{
-							closestaxis = mo2;
-							dist2 = dist1;
-						}
+						dist2 = dist1;
 					}
 				}
 			}
@@ -6401,18 +6359,14 @@ static void P_MovePlayer(player_t *player)
 	{
 		if (!player->capsule && !player->bonustime)
 		{
-			thinker_t *th;
 			mobj_t *mo2;
 
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (mo2 = mobjtypelist[MT_EGGCAPSULE]; mo2; mo2 = mo2->tnext)
 			{
-				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+				if (P_MobjWasRemoved(mo2))
 					continue;
 
-				mo2 = (mobj_t *)th;
-
-				if (mo2->type == MT_EGGCAPSULE
-					&& mo2->threshold == player->mare)
+				if (mo2->threshold == player->mare)
 					P_SetTarget(&player->capsule, mo2);
 			}
 		}
@@ -7105,7 +7059,6 @@ static void P_DoZoomTube(player_t *player)
 {
 	INT32 sequence;
 	fixed_t speed;
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *waypoint = NULL;
 	fixed_t dist;
@@ -7155,14 +7108,9 @@ static void P_DoZoomTube(player_t *player)
 		CONS_Debug(DBG_GAMELOGIC, "Looking for next waypoint...\n");
 
 		// Find next waypoint
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (mo2 = mobjtypelist[MT_TUBEWAYPOINT]; mo2; mo2 = mo2->tnext)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_TUBEWAYPOINT)
+			if (P_MobjWasRemoved(mo2))
 				continue;
 
 			if (mo2->threshold == sequence)
@@ -7224,7 +7172,6 @@ static void P_DoRopeHang(player_t *player)
 {
 	INT32 sequence;
 	fixed_t speed;
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *waypoint = NULL;
 	fixed_t dist;
@@ -7287,14 +7234,9 @@ static void P_DoRopeHang(player_t *player)
 		CONS_Debug(DBG_GAMELOGIC, "Looking for next waypoint...\n");
 
 		// Find next waypoint
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (mo2 = mobjtypelist[MT_TUBEWAYPOINT]; mo2; mo2 = mo2->tnext)
 		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_TUBEWAYPOINT)
+			if (P_MobjWasRemoved(mo2))
 				continue;
 
 			if (mo2->threshold == sequence)
@@ -7312,14 +7254,9 @@ static void P_DoRopeHang(player_t *player)
 			CONS_Debug(DBG_GAMELOGIC, "Next waypoint not found, wrapping to start...\n");
 
 			// Wrap around back to first waypoint
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (mo2 = mobjtypelist[MT_TUBEWAYPOINT]; mo2; mo2 = mo2->tnext)
 			{
-				if (th->function.acp1 != (actionf_p1)P_MobjThinker) // Not a mobj thinker
-					continue;
-
-				mo2 = (mobj_t *)th;
-
-				if (mo2->type != MT_TUBEWAYPOINT)
+				if (P_MobjWasRemoved(mo2))
 					continue;
 
 				if (mo2->threshold == sequence)
@@ -7590,28 +7527,23 @@ void P_HomingAttack(mobj_t *source, mobj_t *enemy) // Home in on your target
 // Search for emeralds
 void P_FindEmerald(void)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
 	hunt1 = hunt2 = hunt3 = NULL;
 
-	// scan the remaining thinkers
+	// scan the emerald hunt mobjs
 	// to find all emeralds
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (mo2 = mobjtypelist[MT_EMERHUNT]; mo2; mo2 = mo2->tnext)
 	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+		if (P_MobjWasRemoved(mo2))
 			continue;
 
-		mo2 = (mobj_t *)th;
-		if (mo2->type == MT_EMERHUNT)
-		{
-			if (!hunt1)
-				hunt1 = mo2;
-			else if (!hunt2)
-				hunt2 = mo2;
-			else if (!hunt3)
-				hunt3 = mo2;
-		}
+		if (!hunt1)
+			hunt1 = mo2;
+		else if (!hunt2)
+			hunt2 = mo2;
+		else if (!hunt3)
+			hunt3 = mo2;
 	}
 	return;
 }
@@ -8979,31 +8911,27 @@ void P_PlayerThink(player_t *player)
 	if (!objectplacing && !((netgame || multiplayer) && player->spectator)
 	&& maptol & TOL_NIGHTS && (!(player->pflags & PF_NIGHTSMODE) || player->powers[pw_nights_helper]))
 	{
-		thinker_t *th;
+		static const mobjtype_t pulltypes[] = {MT_NIGHTSWING, MT_RING, MT_COIN, MT_BLUEBALL};
+		size_t i;
 		mobj_t *mo2;
 		fixed_t x = player->mo->x;
 		fixed_t y = player->mo->y;
 		fixed_t z = player->mo->z;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
-		{
-			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (!(mo2->type == MT_NIGHTSWING || mo2->type == MT_RING || mo2->type == MT_COIN
-			   || mo2->type == MT_BLUEBALL))
-				continue;
+		for (i = 0; i < sizeof (pulltypes) / sizeof (pulltypes[0]); i++)
+			for (mo2 = mobjtypelist[pulltypes[i]]; mo2; mo2 = mo2->tnext)
+			{
+				if (P_MobjWasRemoved(mo2))
+					continue;
 
-			if (P_AproxDistance(P_AproxDistance(mo2->x - x, mo2->y - y), mo2->z - z) > FixedMul(128*FRACUNIT, player->mo->scale))
-				continue;
+				if (P_AproxDistance(P_AproxDistance(mo2->x - x, mo2->y - y), mo2->z - z) > FixedMul(128*FRACUNIT, player->mo->scale))
+					continue;
 
-			// Yay! The thing's in reach! Pull it in!
-			mo2->flags |= MF_NOCLIP|MF_NOCLIPHEIGHT;
-			mo2->flags2 |= MF2_NIGHTSPULL;
-			P_SetTarget(&mo2->tracer, player->mo);
-		}
+				// Yay! The thing's in reach! Pull it in!
+				mo2->flags |= MF_NOCLIP|MF_NOCLIPHEIGHT;
+				mo2->flags2 |= MF2_NIGHTSPULL;
+				P_SetTarget(&mo2->tracer, player->mo);
+			}
 	}
 
 	if (player->linktimer && !player->powers[pw_nights_linkfreeze])
@@ -1525,6 +1525,56 @@ INT32 R_TextureNumForName(const char *name)
 	return i;
 }
 
+//
+// R_PrefetchLevelLumps
+// Has the lumps of the level's flats, and of the textures
+// and sprites marked present, decompressed ahead of time.
+//
+static void R_PrefetchLevelLumps(const char *texturepresent, const char *spritepresent)
+{
+	lumpnum_t *lumps;
+	size_t numlumps = 0, maxlumps = numlevelflats;
+	size_t i, j, k;
+	spriteframe_t *sf;
+
+	for (j = 0; j < (unsigned)numtextures; j++)
+		if (texturepresent[j])
+			maxlumps += textures[j]->patchcount;
+	for (i = 0; i < numsprites; i++)
+		if (spritepresent[i])
+			maxlumps += sprites[i].numframes * 8;
+
+	lumps = malloc(maxlumps * sizeof (*lumps));
+	if (!lumps)
+		return; // just don't prefetch
+
+	for (i = 0; i < numlevelflats; i++)
+		lumps[numlumps++] = levelflats[i].lumpnum;
+
+	for (j = 0; j < (unsigned)numtextures; j++)
+	{
+		if (!texturepresent[j] || texturecache[j])
+			continue;
+		for (k = 0; k < (unsigned)textures[j]->patchcount; k++)
+			lumps[numlumps++] = (textures[j]->patches[k].wad<<16) + textures[j]->patches[k].lump;
+	}
+
+	for (i = 0; i < numsprites; i++)
+	{
+		if (!spritepresent[i])
+			continue;
+		for (j = 0; j < sprites[i].numframes; j++)
+		{
+			sf = &sprites[i].spriteframes[j];
+			for (k = 0; k < 8; k++)
+				lumps[numlumps++] = sf->lumppat[k];
+		}
+	}
+
+	W_PrefetchLumps(lumps, numlumps);
+	free(lumps);
+}
+
 //
 // R_PrecacheLevel
 //
@@ -1546,11 +1596,8 @@ void R_PrecacheLevel(void)
 	if (rendermode != render_soft)
 		return;
 
-	// Precache flats.
-	flatmemory = P_PrecacheLevelFlats();
-
 	//
-	// Precache textures.
+	// Find the textures and sprites used.
 	//
 	// no need to precache all software textures in 3D mode
 	// (note they are still used with the reference software view)
@@ -1573,6 +1620,23 @@ void R_PrecacheLevel(void)
 	// while the sky texture is stored like a wall texture, with a skynum dependent name.
 	texturepresent[skytexture] = 1;
 
+	spritepresent = calloc(numsprites, sizeof (*spritepresent));
+	if (spritepresent == NULL) I_Error("%s: Out of memory looking up sprites", "R_PrecacheLevel");
+
+	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
+			spritepresent[((mobj_t *)th)->sprite] = 1;
+
+	// Decompress everything ahead of time, in parallel,
+	// so caching it below doesn't have to.
+	R_PrefetchLevelLumps(texturepresent, spritepresent);
+
+	// Precache flats.
+	flatmemory = P_PrecacheLevelFlats();
+
+	//
+	// Precache textures.
+	//
 	texturememory = 0;
 	for (j = 0; j < (unsigned)numtextures; j++)
 	{
@@ -1589,13 +1653,6 @@ void R_PrecacheLevel(void)
 	//
 	// Precache sprites.
 	//
-	spritepresent = calloc(numsprites, sizeof (*spritepresent));
-	if (spritepresent == NULL) I_Error("%s: Out of memory looking up sprites", "R_PrecacheLevel");
-
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
-		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
-			spritepresent[((mobj_t *)th)->sprite] = 1;
-
 	spritememory = 0;
 	for (i = 0; i < numsprites; i++)
 	{
@@ -25,11 +25,22 @@
 #include "w_wad.h"
 #include "z_zone.h"
 #include "console.h" // Until buffering gets finished
+#include "i_threads.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
 #endif
 
+#ifdef SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef SIMD_AVX2
+#include <immintrin.h>
+#endif
+#ifdef SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 // ==========================================================================
 //                     COMMON DATA FOR 8bpp AND 16bpp
 // ==========================================================================
@@ -61,13 +72,13 @@ UINT8 *topleft;
 //                      COLUMN DRAWING CODE STUFF
 // =========================================================================
 
-lighttable_t *dc_colormap;
-INT32 dc_x = 0, dc_yl = 0, dc_yh = 0;
+DRAWLOCAL lighttable_t *dc_colormap;
+DRAWLOCAL INT32 dc_x = 0, dc_yl = 0, dc_yh = 0;
 
-fixed_t dc_iscale, dc_texturemid;
-UINT8 dc_hires; // under MSVC boolean is a byte, while on other systems, it a bit,
+DRAWLOCAL fixed_t dc_iscale, dc_texturemid;
+DRAWLOCAL UINT8 dc_hires; // under MSVC boolean is a byte, while on other systems, it a bit,
                // soo lets make it a byte on all system for the ASM code
-UINT8 *dc_source;
+DRAWLOCAL UINT8 *dc_source;
 
 // -----------------------
 // translucency stuff here
@@ -78,7 +89,7 @@ UINT8 *transtables; // translucency tables
 
 /**	\brief R_DrawTransColumn uses this
 */
-UINT8 *dc_transmap; // one of the translucency tables
+DRAWLOCAL UINT8 *dc_transmap; // one of the translucency tables
 
 // ----------------------
 // translation stuff here
@@ -87,32 +98,38 @@ UINT8 *dc_transmap; // one of the translucency tables
 
 /**	\brief R_DrawTranslatedColumn uses this
 */
-UINT8 *dc_translation;
+DRAWLOCAL UINT8 *dc_translation;
 
 struct r_lightlist_s *dc_lightlist = NULL;
-INT32 dc_numlights = 0, dc_maxlights, dc_texheight;
+INT32 dc_numlights = 0, dc_maxlights;
+DRAWLOCAL INT32 dc_texheight;
 
 // =========================================================================
 //                      SPAN DRAWING CODE STUFF
 // =========================================================================
 
-INT32 ds_y, ds_x1, ds_x2;
-lighttable_t *ds_colormap;
-fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+DRAWLOCAL INT32 ds_y, ds_x1, ds_x2;
+DRAWLOCAL lighttable_t *ds_colormap;
+DRAWLOCAL fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+
+DRAWLOCAL UINT8 *ds_source; // start of a 64*64 tile image
+DRAWLOCAL UINT8 *ds_transmap; // one of the translucency tables
 
-UINT8 *ds_source; // start of a 64*64 tile image
-UINT8 *ds_transmap; // one of the translucency tables
+#ifndef NOWATER
+DRAWLOCAL INT32 ds_bgofs, ds_waterofs;
+#endif
 
 #ifdef ESLOPE
 pslope_t *ds_slope; // Current slope being used
-floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
-float focallengthf, zeroheight;
+DRAWLOCAL floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
+float focallengthf;
+DRAWLOCAL float zeroheight;
 #endif
 
 /**	\brief Variable flat sizes
 */
 
-UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
+DRAWLOCAL UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
 
 // ==========================================================================
 //                        OLD DOOM FUZZY EFFECT
@@ -795,11 +812,486 @@ void R_DrawViewBorder(void)
 }
 #endif
 
+// ==========================================================================
+//                        THREADED DRAWING
+// ==========================================================================
+
+#ifdef THREADEDDRAW
+static CV_PossibleValue_t drawthreads_cons_t[] = {{0, "MIN"}, {MAXDRAWTHREADS, "MAX"}, {0, NULL}};
+consvar_t cv_drawthreads = {"drawthreads", "0", CV_SAVE, drawthreads_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+boolean drawqueueactive = false;
+
+DRAWLOCAL INT32 ds_clipx1 = INT32_MIN, ds_clipx2 = INT32_MAX;
+
+/**	\brief The column drawer state a queued column is drawn with
+*/
+typedef struct
+{
+	lighttable_t *colormap;
+	INT32 x, yl, yh;
+	fixed_t iscale, texturemid;
+	UINT8 hires;
+	UINT8 *source;
+	UINT8 *transmap;
+	UINT8 *translation;
+	INT32 texheight;
+} colstate_t;
+
+/**	\brief The span drawer state a queued span is drawn with
+*/
+typedef struct
+{
+	INT32 y, x1, x2;
+	lighttable_t *colormap;
+	fixed_t xfrac, yfrac, xstep, ystep;
+	UINT8 *source;
+	UINT8 *transmap;
+	UINT32 xshift, yshift, shiftup, mask;
+	lighttable_t **zlight;
+#ifndef NOWATER
+	INT32 bgofs, waterofs;
+#endif
+#ifdef ESLOPE
+	floatv3_t su, sv, sz;
+	float zeroheight;
+#endif
+} spanstate_t;
+
+typedef struct
+{
+	void (*drawer)(void);
+	boolean isspan;
+	size_t scratch; // offset of dc_source in drawscratch, or (size_t)-1
+	union
+	{
+		colstate_t col;
+		spanstate_t span;
+	} u;
+} drawcmd_t;
+
+static drawcmd_t *drawcmds = NULL;
+static size_t numdrawcmds = 0, maxdrawcmds = 0;
+
+static UINT8 *drawscratch = NULL;
+static size_t drawscratchused = 0, drawscratchsize = 0;
+
+static I_mutex draw_mutex;
+static I_cond draw_cond;
+static I_cond draw_done_cond;
+
+static INT32 drawworkers = 0; // threads started
+static INT32 drawhelpers = 0; // threads taking part in this flush
+static INT32 drawstrips = 0, drawnextstrip = 0, drawstripsleft = 0;
+static boolean drawspawnfailed = false;
+
+static void R_SaveColumnState(colstate_t *st)
+{
+	st->colormap = dc_colormap;
+	st->x = dc_x;
+	st->yl = dc_yl;
+	st->yh = dc_yh;
+	st->iscale = dc_iscale;
+	st->texturemid = dc_texturemid;
+	st->hires = dc_hires;
+	st->source = dc_source;
+	st->transmap = dc_transmap;
+	st->translation = dc_translation;
+	st->texheight = dc_texheight;
+}
+
+static void R_LoadColumnState(const colstate_t *st)
+{
+	dc_colormap = st->colormap;
+	dc_x = st->x;
+	dc_yl = st->yl;
+	dc_yh = st->yh;
+	dc_iscale = st->iscale;
+	dc_texturemid = st->texturemid;
+	dc_hires = st->hires;
+	dc_source = st->source;
+	dc_transmap = st->transmap;
+	dc_translation = st->translation;
+	dc_texheight = st->texheight;
+}
+
+static void R_SaveSpanState(spanstate_t *st)
+{
+	st->y = ds_y;
+	st->x1 = ds_x1;
+	st->x2 = ds_x2;
+	st->colormap = ds_colormap;
+	st->xfrac = ds_xfrac;
+	st->yfrac = ds_yfrac;
+	st->xstep = ds_xstep;
+	st->ystep = ds_ystep;
+	st->source = ds_source;
+	st->transmap = ds_transmap;
+	st->xshift = nflatxshift;
+	st->yshift = nflatyshift;
+	st->shiftup = nflatshiftup;
+	st->mask = nflatmask;
+	st->zlight = planezlight;
+#ifndef NOWATER
+	st->bgofs = ds_bgofs;
+	st->waterofs = ds_waterofs;
+#endif
+#ifdef ESLOPE
+	st->su = ds_su;
+	st->sv = ds_sv;
+	st->sz = ds_sz;
+	st->zeroheight = zeroheight;
+#endif
+}
+
+static void R_LoadSpanState(const spanstate_t *st)
+{
+	ds_y = st->y;
+	ds_x1 = st->x1;
+	ds_x2 = st->x2;
+	ds_colormap = st->colormap;
+	ds_xfrac = st->xfrac;
+	ds_yfrac = st->yfrac;
+	ds_xstep = st->xstep;
+	ds_ystep = st->ystep;
+	ds_source = st->source;
+	ds_transmap = st->transmap;
+	nflatxshift = st->xshift;
+	nflatyshift = st->yshift;
+	nflatshiftup = st->shiftup;
+	nflatmask = st->mask;
+	planezlight = st->zlight;
+#ifndef NOWATER
+	ds_bgofs = st->bgofs;
+	ds_waterofs = st->waterofs;
+#endif
+#ifdef ESLOPE
+	ds_su = st->su;
+	ds_sv = st->sv;
+	ds_sz = st->sz;
+	zeroheight = st->zeroheight;
+#endif
+}
+
+static drawcmd_t *R_NewDrawCmd(void (*drawer)(void))
+{
+	drawcmd_t *cmd;
+
+	if (numdrawcmds == maxdrawcmds)
+	{
+		maxdrawcmds = maxdrawcmds ? maxdrawcmds*2 : 8192;
+		drawcmds = realloc(drawcmds, maxdrawcmds * sizeof (*drawcmds));
+		if (!drawcmds)
+			I_Error("R_NewDrawCmd: out of memory");
+	}
+
+	cmd = &drawcmds[numdrawcmds++];
+	cmd->drawer = drawer;
+	return cmd;
+}
+
+void R_QueueColumn(void (*drawer)(void))
+{
+	drawcmd_t *cmd;
+
+	// This one only cuts the column up between other drawers, and the
+	// caller may look at the dc_ variables it leaves behind. Run it now
+	// and queue the pieces.
+	if (drawer == R_DrawColumnShadowed_8)
+	{
+		drawer();
+		return;
+	}
+
+	cmd = R_NewDrawCmd(drawer);
+	cmd->isspan = false;
+	R_SaveColumnState(&cmd->u.col);
+
+	// the scratch buffer can move before the column is drawn
+	if (drawscratch && dc_source >= drawscratch && dc_source < drawscratch + drawscratchused)
+		cmd->scratch = (size_t)(dc_source - drawscratch);
+	else
+		cmd->scratch = (size_t)-1;
+}
+
+void R_QueueSpan(void (*drawer)(void))
+{
+	drawcmd_t *cmd = R_NewDrawCmd(drawer);
+	cmd->isspan = true;
+	cmd->scratch = (size_t)-1;
+	R_SaveSpanState(&cmd->u.span);
+}
+
+static boolean R_IsTiltedSpan(void (*drawer)(void))
+{
+#ifdef ESLOPE
+	return (drawer == R_DrawTiltedSpan_8
+		|| drawer == R_DrawTiltedTranslucentSpan_8
+		|| drawer == R_DrawTiltedSplat_8
+#ifdef SIMD_SSE2
+		|| drawer == R_DrawTiltedSpan_8_SSE2
+#endif
+#ifdef SIMD_AVX2
+		|| drawer == R_DrawTiltedSpan_8_AVX2
+#endif
+#ifdef SIMD_NEON
+		|| drawer == R_DrawTiltedSpan_8_NEON
+#endif
+		);
+#else
+	(void)drawer;
+	return false;
+#endif
+}
+
+/**	\brief	Draw the part of every queued column and span inside x1 to x2
+
+	Commands run in the order they were queued, and no two strips share
+	a pixel, so the result is the same as drawing them all on one thread.
+*/
+static void R_DrawStrip(INT32 x1, INT32 x2)
+{
+	drawcmd_t *cmd = drawcmds, *end = drawcmds + numdrawcmds;
+	UINT32 skip;
+
+	for (; cmd < end; cmd++)
+	{
+		if (!cmd->isspan)
+		{
+			if (cmd->u.col.x < x1 || cmd->u.col.x > x2)
+				continue;
+
+			R_LoadColumnState(&cmd->u.col);
+			if (cmd->scratch != (size_t)-1)
+				dc_source = drawscratch + cmd->scratch;
+			cmd->drawer();
+			continue;
+		}
+
+		if (cmd->u.span.x2 < x1 || cmd->u.span.x1 > x2)
+			continue;
+
+		R_LoadSpanState(&cmd->u.span);
+
+		if (R_IsTiltedSpan(cmd->drawer))
+		{
+			ds_clipx1 = x1;
+			ds_clipx2 = x2;
+			cmd->drawer();
+			continue;
+		}
+
+		// The other span drawers step the texture by a fixed amount each
+		// pixel, so starting partway in gives the same pixels.
+		if (ds_x1 < x1)
+		{
+			skip = (UINT32)(x1 - ds_x1);
+			ds_xfrac = (fixed_t)((UINT32)ds_xfrac + skip*(UINT32)ds_xstep);
+			ds_yfrac = (fixed_t)((UINT32)ds_yfrac + skip*(UINT32)ds_ystep);
+			ds_x1 = x1;
+		}
+		if (ds_x2 > x2)
+			ds_x2 = x2;
+		cmd->drawer();
+	}
+
+	ds_clipx1 = INT32_MIN;
+	ds_clipx2 = INT32_MAX;
+}
+
+// Take strips until there are none left; draw_mutex must be locked
+static void R_RunDrawStrips(void)
+{
+	INT32 strip, x1, x2;
+
+	while (drawnextstrip < drawstrips)
+	{
+		strip = drawnextstrip++;
+		I_UnlockMutex(draw_mutex);
+
+		// The outer strips take anything that strays off the view
+		x1 = strip ? strip*viewwidth/drawstrips : INT32_MIN;
+		x2 = (strip < drawstrips-1) ? (strip+1)*viewwidth/drawstrips - 1 : INT32_MAX;
+		R_DrawStrip(x1, x2);
+
+		I_LockMutex(&draw_mutex);
+		if (!--drawstripsleft)
+			I_WakeAllCond(&draw_done_cond);
+	}
+}
+
+static void R_DrawThread(void *userdata)
+{
+	const INT32 index = (INT32)(size_t)userdata;
+
+	I_LockMutex(&draw_mutex);
+	for (;;)
+	{
+		if (index < drawhelpers)
+			R_RunDrawStrips();
+		I_HoldCond(&draw_cond, draw_mutex);
+	}
+}
+
+static INT32 R_DrawThreadCount(void)
+{
+	INT32 threads = cv_drawthreads.value;
+
+	if (!threads)
+		threads = I_GetCPUCount();
+	if (threads > MAXDRAWTHREADS)
+		threads = MAXDRAWTHREADS;
+
+	return threads;
+}
+
+static void R_SpawnDrawThreads(INT32 count)
+{
+	while (drawworkers < count && !drawspawnfailed)
+	{
+		if (I_SpawnThread("draw", R_DrawThread, (void *)(size_t)drawworkers))
+			drawworkers++;
+		else
+		{
+			CONS_Alert(CONS_WARNING, M_GetText("Couldn't start a drawing thread, drawing with %d\n"), drawworkers + 1);
+			drawspawnfailed = true;
+		}
+	}
+}
+#endif // THREADEDDRAW
+
+/**	\brief	Start queueing columns and spans for R_FlushDrawQueue
+
+	Does nothing unless more than one drawing thread is wanted.
+*/
+void R_StartDrawQueue(void)
+{
+#ifdef THREADEDDRAW
+	drawqueueactive = (R_DrawThreadCount() > 1);
+#endif
+}
+
+/**	\brief	Draw everything queued so far, split into strips across threads
+
+	Call before anything reads the screen back or changes the view
+	variables the drawers use (centery, viewx, ...).
+*/
+void R_FlushDrawQueue(void)
+{
+#ifdef THREADEDDRAW
+	colstate_t col;
+	spanstate_t span;
+	INT32 helpers;
+
+	if (!numdrawcmds)
+		return;
+
+	// this thread draws too, so hold on to what the renderer was doing
+	R_SaveColumnState(&col);
+	R_SaveSpanState(&span);
+
+	helpers = R_DrawThreadCount() - 1;
+	R_SpawnDrawThreads(helpers);
+	if (helpers > drawworkers)
+		helpers = drawworkers;
+
+	if (helpers <= 0)
+		R_DrawStrip(INT32_MIN, INT32_MAX);
+	else
+	{
+		I_LockMutex(&draw_mutex);
+
+		// A couple of strips per thread evens out the busier middle of
+		// the view. Keep them at least 8 wide, since R_DrawSpan_8 skips
+		// spans that start in the last 8 pixels of the screen.
+		drawhelpers = helpers;
+		drawstrips = (helpers + 1) * 2;
+		if (drawstrips > viewwidth/8)
+			drawstrips = viewwidth/8;
+		if (drawstrips < 1)
+			drawstrips = 1;
+		drawnextstrip = 0;
+		drawstripsleft = drawstrips;
+
+		I_WakeAllCond(&draw_cond);
+		R_RunDrawStrips();
+		while (drawstripsleft)
+			I_HoldCond(&draw_done_cond, draw_mutex);
+
+		I_UnlockMutex(draw_mutex);
+	}
+
+	R_LoadColumnState(&col);
+	R_LoadSpanState(&span);
+
+	numdrawcmds = 0;
+	drawscratchused = 0;
+#endif
+}
+
+/**	\brief	Draw what's left in the queue and stop queueing
+*/
+void R_FinishDrawQueue(void)
+{
+#ifdef THREADEDDRAW
+	R_FlushDrawQueue();
+	drawqueueactive = false;
+#endif
+}
+
+// The gathering drawers read a whole dword from short columns
+#define COLUMNSOURCEPAD 3
+
+/**	\brief	Get room for column data made on the fly
+
+	While queueing, the data has to last until the column is drawn, so
+	it comes from a buffer that's emptied by R_FlushDrawQueue.
+
+	\param	length	bytes needed
+	\return	column data, to be given back with R_FreeColumnSource
+*/
+UINT8 *R_AllocColumnSource(size_t length)
+{
+#ifdef THREADEDDRAW
+	if (drawqueueactive)
+	{
+		UINT8 *source;
+
+		if (drawscratchused + length + COLUMNSOURCEPAD > drawscratchsize)
+		{
+			if (!drawscratchsize)
+				drawscratchsize = 16384;
+			while (drawscratchused + length + COLUMNSOURCEPAD > drawscratchsize)
+				drawscratchsize *= 2;
+			drawscratch = realloc(drawscratch, drawscratchsize);
+			if (!drawscratch)
+				I_Error("R_AllocColumnSource: out of memory");
+		}
+
+		source = drawscratch + drawscratchused;
+		drawscratchused += length;
+		return source;
+	}
+#endif
+	return ZZ_Alloc(length + COLUMNSOURCEPAD);
+}
+
+void R_FreeColumnSource(UINT8 *source)
+{
+#ifdef THREADEDDRAW
+	if (drawqueueactive)
+		return; // goes away with the queue
+#endif
+	Z_Free(source);
+}
+
+
 // ==========================================================================
 //                   INCLUDE 8bpp DRAWING CODE HERE
 // ==========================================================================
 
 #include "r_draw8.c"
+#include "r_draw8_simd.c"
 
 // ==========================================================================
 //                   INCLUDE 16bpp DRAWING CODE HERE
@@ -16,6 +16,23 @@
 
 #include "r_defs.h"
 
+// The C drawers can be run by several threads at once, each drawing its
+// own strip of the view; see R_FlushDrawQueue. The ASM drawers read the
+// dc_/ds_ variables by symbol, so they can't use thread-local copies.
+#if defined (HAVE_THREADS) && !defined (USEASM)
+#define THREADEDDRAW
+#endif
+
+#ifdef THREADEDDRAW
+#ifdef _MSC_VER
+#define DRAWLOCAL __declspec(thread)
+#else
+#define DRAWLOCAL __thread
+#endif
+#else
+#define DRAWLOCAL
+#endif
+
 // -------------------------------
 // COMMON STUFF FOR 8bpp AND 16bpp
 // -------------------------------
@@ -29,36 +46,44 @@ extern UINT8 *topleft;
 // COLUMN DRAWING CODE STUFF
 // -------------------------
 
-extern lighttable_t *dc_colormap;
-extern INT32 dc_x, dc_yl, dc_yh;
-extern fixed_t dc_iscale, dc_texturemid;
-extern UINT8 dc_hires;
+extern DRAWLOCAL lighttable_t *dc_colormap;
+extern DRAWLOCAL INT32 dc_x, dc_yl, dc_yh;
+extern DRAWLOCAL fixed_t dc_iscale, dc_texturemid;
+extern DRAWLOCAL UINT8 dc_hires;
 
-extern UINT8 *dc_source; // first pixel in a column
+extern DRAWLOCAL UINT8 *dc_source; // first pixel in a column
 
 // translucency stuff here
 extern UINT8 *transtables; // translucency tables, should be (*transtables)[5][256][256]
-extern UINT8 *dc_transmap;
+extern DRAWLOCAL UINT8 *dc_transmap;
 
 // translation stuff here
 
-extern UINT8 *dc_translation;
+extern DRAWLOCAL UINT8 *dc_translation;
 
 extern struct r_lightlist_s *dc_lightlist;
 extern INT32 dc_numlights, dc_maxlights;
 
 //Fix TUTIFRUTI
-extern INT32 dc_texheight;
+extern DRAWLOCAL INT32 dc_texheight;
 
 // -----------------------
 // SPAN DRAWING CODE STUFF
 // -----------------------
 
-extern INT32 ds_y, ds_x1, ds_x2;
-extern lighttable_t *ds_colormap;
-extern fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
-extern UINT8 *ds_source; // start of a 64*64 tile image
-extern UINT8 *ds_transmap;
+extern DRAWLOCAL INT32 ds_y, ds_x1, ds_x2;
+extern DRAWLOCAL lighttable_t *ds_colormap;
+extern DRAWLOCAL fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+extern DRAWLOCAL UINT8 *ds_source; // start of a 64*64 tile image
+extern DRAWLOCAL UINT8 *ds_transmap;
+
+#ifndef NOWATER
+extern DRAWLOCAL INT32 ds_bgofs, ds_waterofs; // water ripple offsets
+#endif
+
+#ifdef THREADEDDRAW
+extern DRAWLOCAL INT32 ds_clipx1, ds_clipx2; // strip the tilted drawers may touch
+#endif
 
 #ifdef ESLOPE
 typedef struct {
@@ -66,15 +91,47 @@ typedef struct {
 } floatv3_t;
 
 extern pslope_t *ds_slope; // Current slope being used
-extern floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
-extern float focallengthf, zeroheight;
+extern DRAWLOCAL floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
+extern float focallengthf;
+extern DRAWLOCAL float zeroheight;
 #endif
 
 // Variable flat sizes
-extern UINT32 nflatxshift;
-extern UINT32 nflatyshift;
-extern UINT32 nflatshiftup;
-extern UINT32 nflatmask;
+extern DRAWLOCAL UINT32 nflatxshift;
+extern DRAWLOCAL UINT32 nflatyshift;
+extern DRAWLOCAL UINT32 nflatshiftup;
+extern DRAWLOCAL UINT32 nflatmask;
+
+// ----------------------
+// THREADED DRAWING STUFF
+// ----------------------
+
+// Call a column or span drawer. While the draw queue is running, the
+// drawer and the dc_/ds_ state it reads are recorded instead, to be
+// drawn by R_FlushDrawQueue.
+#ifdef THREADEDDRAW
+#define MAXDRAWTHREADS 16
+
+extern consvar_t cv_drawthreads;
+extern boolean drawqueueactive;
+
+void R_QueueColumn(void (*drawer)(void));
+void R_QueueSpan(void (*drawer)(void));
+
+#define R_DrawColumnFunc(drawer) (drawqueueactive ? R_QueueColumn(drawer) : (drawer)())
+#define R_DrawSpanFunc(drawer) (drawqueueactive ? R_QueueSpan(drawer) : (drawer)())
+#else
+#define R_DrawColumnFunc(drawer) (drawer)()
+#define R_DrawSpanFunc(drawer) (drawer)()
+#endif
+
+void R_StartDrawQueue(void);
+void R_FlushDrawQueue(void);
+void R_FinishDrawQueue(void);
+
+// Scratch column data that has to live until the column is drawn
+UINT8 *R_AllocColumnSource(size_t length);
+void R_FreeColumnSource(UINT8 *source);
 
 /// \brief Top border
 #define BRDR_T 0
@@ -152,6 +209,8 @@ void R_DrawTranslatedColumn_8(void);
 void R_DrawTranslatedTranslucentColumn_8(void);
 void R_DrawSpan_8(void);
 #ifdef ESLOPE
+typedef void (*tiltedspanblock_t)(UINT8 *dest, UINT32 u, UINT32 v, UINT32 stepu, UINT32 stepv);
+
 void R_CalcTiltedLighting(fixed_t start, fixed_t end);
 void R_DrawTiltedSpan_8(void);
 void R_DrawTiltedTranslucentSpan_8(void);
@@ -166,6 +225,50 @@ void R_DrawFogSpan_8(void);
 void R_DrawFogColumn_8(void);
 void R_DrawColumnShadowed_8(void);
 
+// -------------------
+// 8bpp VECTOR DRAWERS
+// -------------------
+
+// These draw exactly what the C drawers above do, a few pixels at a
+// time. SCR_SetMode picks them when the CPU has the instructions.
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2
+#if defined (_MSC_VER) || defined (__clang__) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#define SIMD_AVX2
+#endif
+#endif
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define SIMD_NEON
+#endif
+
+#ifdef SIMD_SSE2
+void R_DrawTranslucentColumn_8_SSE2(void);
+void R_DrawSpan_8_SSE2(void);
+void R_DrawTranslucentSpan_8_SSE2(void);
+#ifdef ESLOPE
+void R_DrawTiltedSpan_8_SSE2(void);
+#endif
+#endif
+
+#ifdef SIMD_AVX2
+void R_DrawTranslucentColumn_8_AVX2(void);
+void R_DrawSpan_8_AVX2(void);
+void R_DrawTranslucentSpan_8_AVX2(void);
+#ifdef ESLOPE
+void R_DrawTiltedSpan_8_AVX2(void);
+#endif
+#endif
+
+#ifdef SIMD_NEON
+void R_DrawTranslucentColumn_8_NEON(void);
+void R_DrawSpan_8_NEON(void);
+void R_DrawTranslucentSpan_8_NEON(void);
+#ifdef ESLOPE
+void R_DrawTiltedSpan_8_NEON(void);
+#endif
+#endif
+
 // ------------------
 // 16bpp DRAWING CODE
 // ------------------
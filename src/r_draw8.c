@@ -623,7 +623,15 @@ void R_DrawSpan_8 (void)
 #ifdef ESLOPE
 // R_CalcTiltedLighting
 // Exactly what it says on the tin. I wish I wasn't too lazy to explain things properly.
-static INT32 tiltlighting[MAXVIDWIDTH];
+static DRAWLOCAL INT32 tiltlighting[MAXVIDWIDTH];
+
+// A tilted span has to be stepped from its left end to get the same
+// pixels, so a drawing thread runs all of it and only writes its strip.
+#ifdef THREADEDDRAW
+#define TILTEDCLIP(x) ((x) >= ds_clipx1 && (x) <= ds_clipx2)
+#else
+#define TILTEDCLIP(x) true
+#endif
 void R_CalcTiltedLighting(fixed_t start, fixed_t end)
 {
 	// ZDoom uses a different lighting setup to us, and I couldn't figure out how to adapt their version
@@ -645,16 +653,40 @@ void R_CalcTiltedLighting(fixed_t start, fixed_t end)
 }
 
 
-/**	\brief The R_DrawTiltedSpan_8 function
-	Draw slopes! Holy sheit!
+#define SPANSIZE 16
+#define INVSPAN	0.0625f
+
+/**	\brief The R_TiltedSpanBlock_8 function
+	Draws SPANSIZE pixels of a tilted span, with u and v stepping
+	evenly across them.
 */
-void R_DrawTiltedSpan_8(void)
+static void R_TiltedSpanBlock_8(UINT8 *dest, UINT32 u, UINT32 v, UINT32 stepu, UINT32 stepv)
+{
+	const UINT8 *source = ds_source;
+	UINT8 *colormap;
+	int i;
+
+	for (i = SPANSIZE-1; i >= 0; i--)
+	{
+		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
+		if (TILTEDCLIP(ds_x1-1))
+			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
+		dest++;
+		u += stepu;
+		v += stepv;
+	}
+}
+
+/**	\brief The R_DrawTiltedSpanWith_8 function
+	Does the perspective maths for R_DrawTiltedSpan_8 and its vector
+	versions, handing each whole SPANSIZE block to block to draw.
+*/
+static FUNCNOINLINE ATTRNOINLINE void R_DrawTiltedSpanWith_8(tiltedspanblock_t block)
 {
 	// x1, x2 = ds_x1, ds_x2
 	int width = ds_x2 - ds_x1;
 	double iz, uz, vz;
 	UINT32 u, v;
-	int i;
 
 	UINT8 *source;
 	UINT8 *colormap;
@@ -688,7 +720,6 @@ void R_DrawTiltedSpan_8(void)
 
 #if 0	// The "perfect" reference version of this routine. Pretty slow.
 		// Use it only to see how things are supposed to look.
-	i = 0;
 	do
 	{
 		double z = 1.f/iz;
@@ -704,9 +735,6 @@ void R_DrawTiltedSpan_8(void)
 		vz += ds_sv.x;
 	} while (--width >= 0);
 #else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
-
 	startz = 1.f/iz;
 	startu = uz*startz;
 	startv = vz*startz;
@@ -731,14 +759,9 @@ void R_DrawTiltedSpan_8(void)
 		u = (INT64)(startu) + viewx;
 		v = (INT64)(startv) + viewy;
 
-		for (i = SPANSIZE-1; i >= 0; i--)
-		{
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-			dest++;
-			u += stepu;
-			v += stepv;
-		}
+		block(dest, u, v, stepu, stepv);
+		dest += SPANSIZE;
+
 		startu = endu;
 		startv = endv;
 		width -= SPANSIZE;
@@ -750,7 +773,8 @@ void R_DrawTiltedSpan_8(void)
 			u = (INT64)(startu);
 			v = (INT64)(startv);
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
+			if (TILTEDCLIP(ds_x1-1))
+				*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
 		}
 		else
 		{
@@ -771,7 +795,8 @@ void R_DrawTiltedSpan_8(void)
 			for (; width != 0; width--)
 			{
 				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
+				if (TILTEDCLIP(ds_x1-1))
+					*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
 				dest++;
 				u += stepu;
 				v += stepv;
@@ -781,6 +806,14 @@ void R_DrawTiltedSpan_8(void)
 #endif
 }
 
+/**	\brief The R_DrawTiltedSpan_8 function
+	Draw slopes! Holy sheit!
+*/
+void R_DrawTiltedSpan_8(void)
+{
+	R_DrawTiltedSpanWith_8(R_TiltedSpanBlock_8);
+}
+
 /**	\brief The R_DrawTiltedTranslucentSpan_8 function
 	Like DrawTiltedSpan, but translucent
 */
@@ -869,7 +902,8 @@ void R_DrawTiltedTranslucentSpan_8(void)
 		for (i = SPANSIZE-1; i >= 0; i--)
 		{
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
+			if (TILTEDCLIP(ds_x1-1))
+				*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
 			dest++;
 			u += stepu;
 			v += stepv;
@@ -885,7 +919,8 @@ void R_DrawTiltedTranslucentSpan_8(void)
 			u = (INT64)(startu);
 			v = (INT64)(startv);
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
+			if (TILTEDCLIP(ds_x1-1))
+				*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
 		}
 		else
 		{
@@ -906,7 +941,8 @@ void R_DrawTiltedTranslucentSpan_8(void)
 			for (; width != 0; width--)
 			{
 				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
+				if (TILTEDCLIP(ds_x1-1))
+					*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
 				dest++;
 				u += stepu;
 				v += stepv;
@@ -1007,7 +1043,7 @@ void R_DrawTiltedSplat_8(void)
 		{
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 			val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-			if (val != TRANSPARENTPIXEL)
+			if (val != TRANSPARENTPIXEL && TILTEDCLIP(ds_x1-1))
 				*dest = colormap[val];
 			dest++;
 			u += stepu;
@@ -1025,7 +1061,7 @@ void R_DrawTiltedSplat_8(void)
 			v = (INT64)(startv);
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 			val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-			if (val != TRANSPARENTPIXEL)
+			if (val != TRANSPARENTPIXEL && TILTEDCLIP(ds_x1-1))
 				*dest = colormap[val];
 		}
 		else
@@ -1048,7 +1084,7 @@ void R_DrawTiltedSplat_8(void)
 			{
 				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 				val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-				if (val != TRANSPARENTPIXEL)
+				if (val != TRANSPARENTPIXEL && TILTEDCLIP(ds_x1-1))
 					*dest = colormap[val];
 				dest++;
 				u += stepu;
@@ -1481,7 +1517,7 @@ void R_DrawColumnShadowed_8(void)
 
 		if (dc_yh > realyh)
 			dc_yh = realyh;
-		basecolfunc();		// R_DrawColumn_8 for the appropriate architecture
+		R_DrawColumnFunc(basecolfunc);		// R_DrawColumn_8 for the appropriate architecture
 		if (solid)
 			dc_yl = bheight;
 		else
@@ -1491,5 +1527,5 @@ void R_DrawColumnShadowed_8(void)
 	}
 	dc_yh = realyh;
 	if (dc_yl <= realyh)
-		walldrawerfunc();		// R_DrawWallColumn_8 for the appropriate architecture
+		R_DrawColumnFunc(walldrawerfunc);		// R_DrawWallColumn_8 for the appropriate architecture
 }
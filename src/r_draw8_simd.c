@@ -0,0 +1,807 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1999-2018 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_draw8_simd.c
+/// \brief 8bpp span/column drawer functions, SSE2/AVX2/NEON versions
+/// \note  no includes because this is included as part of r_draw.c
+///        Each drawer here must put down exactly the pixels its C
+///        version in r_draw8.c does. The texture coordinates are
+///        stepped several pixels at a time; the integer maths is the
+///        same, so every pixel lands on the same texel.
+
+// ==========================================================================
+// SSE2
+// ==========================================================================
+
+#ifdef SIMD_SSE2
+
+// 4 lanes of a value stepping by step
+#define LANES_SSE2(p, step) _mm_setr_epi32((INT32)(p), (INT32)((p) + (step)), \
+	(INT32)((p) + 2*(step)), (INT32)((p) + 3*(step)))
+
+// flat offsets for 4 pixels at x, y; wants xshift, yshift and mask
+#define SPANOFS_SSE2(x, y) _mm_or_si128(_mm_and_si128(_mm_srl_epi32(y, yshift), mask), \
+	_mm_srl_epi32(x, xshift))
+
+/**	\brief The R_DrawTranslucentColumn_8_SSE2 function
+	R_DrawTranslucentColumn_8, 8 texels at a time
+*/
+void R_DrawTranslucentColumn_8_SSE2(void)
+{
+	INT32 count, i;
+	UINT8 *dest;
+	fixed_t frac, fracstep;
+	INT32 heightmask = dc_texheight - 1;
+	INT32 ofs[8];
+
+	// Only power of two textures step evenly; the rest wrap as they go
+	if (dc_texheight & heightmask)
+	{
+		R_DrawTranslucentColumn_8();
+		return;
+	}
+
+	count = dc_yh - dc_yl + 1;
+
+	if (count <= 0) // Zero length, column does not exceed a pixel.
+		return;
+
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		I_Error("R_DrawTranslucentColumn_8_SSE2: %d to %d at %d", dc_yl, dc_yh, dc_x);
+#endif
+
+	dest = &topleft[dc_yl*vid.width + dc_x];
+
+	fracstep = dc_iscale;
+	frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, fracstep))*(!dc_hires);
+
+	{
+		const UINT8 *source = dc_source;
+		const UINT8 *transmap = dc_transmap;
+		const lighttable_t *colormap = dc_colormap;
+
+		if (count >= 8)
+		{
+			const __m128i mask = _mm_set1_epi32(heightmask);
+			const __m128i step4 = _mm_set1_epi32((INT32)((UINT32)fracstep*4));
+			__m128i f = LANES_SSE2((UINT32)frac, (UINT32)fracstep);
+
+			do
+			{
+				_mm_storeu_si128((__m128i *)ofs, _mm_and_si128(_mm_srai_epi32(f, FRACBITS), mask));
+				f = _mm_add_epi32(f, step4);
+				_mm_storeu_si128((__m128i *)(ofs+4), _mm_and_si128(_mm_srai_epi32(f, FRACBITS), mask));
+				f = _mm_add_epi32(f, step4);
+
+				for (i = 0; i < 8; i++)
+				{
+					*dest = *(transmap + (colormap[source[ofs[i]]]<<8) + (*dest));
+					dest += vid.width;
+				}
+				count -= 8;
+			} while (count >= 8);
+
+			frac = _mm_cvtsi128_si32(f);
+		}
+
+		while (count--)
+		{
+			*dest = *(transmap + (colormap[source[(frac>>FRACBITS)&heightmask]]<<8) + (*dest));
+			dest += vid.width;
+			frac += fracstep;
+		}
+	}
+}
+
+/**	\brief The R_DrawSpan_8_SSE2 function
+	R_DrawSpan_8, 8 pixels at a time
+*/
+void R_DrawSpan_8_SSE2(void)
+{
+	UINT32 xposition;
+	UINT32 yposition;
+	UINT32 xstep, ystep;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+	const UINT8 *deststop = screens[0] + vid.rowbytes * vid.height;
+
+	size_t count, i;
+	UINT32 ofs[8];
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	source = ds_source;
+	colormap = ds_colormap;
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (dest+8 > deststop)
+		return;
+
+	if (count >= 8)
+	{
+		const __m128i xshift = _mm_cvtsi32_si128((INT32)nflatxshift);
+		const __m128i yshift = _mm_cvtsi32_si128((INT32)nflatyshift);
+		const __m128i mask = _mm_set1_epi32((INT32)nflatmask);
+		const __m128i xstep4 = _mm_set1_epi32((INT32)(xstep*4));
+		const __m128i ystep4 = _mm_set1_epi32((INT32)(ystep*4));
+		__m128i x = LANES_SSE2(xposition, xstep);
+		__m128i y = LANES_SSE2(yposition, ystep);
+
+		do
+		{
+			_mm_storeu_si128((__m128i *)ofs, SPANOFS_SSE2(x, y));
+			x = _mm_add_epi32(x, xstep4);
+			y = _mm_add_epi32(y, ystep4);
+			_mm_storeu_si128((__m128i *)(ofs+4), SPANOFS_SSE2(x, y));
+			x = _mm_add_epi32(x, xstep4);
+			y = _mm_add_epi32(y, ystep4);
+
+			for (i = 0; i < 8; i++)
+				dest[i] = colormap[source[ofs[i]]];
+			dest += 8;
+			count -= 8;
+		} while (count >= 8);
+
+		xposition = (UINT32)_mm_cvtsi128_si32(x);
+		yposition = (UINT32)_mm_cvtsi128_si32(y);
+	}
+
+	while (count-- && dest <= deststop)
+	{
+		*dest++ = colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]];
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+/**	\brief The R_DrawTranslucentSpan_8_SSE2 function
+	R_DrawTranslucentSpan_8, 8 pixels at a time
+*/
+void R_DrawTranslucentSpan_8_SSE2(void)
+{
+	UINT32 xposition;
+	UINT32 yposition;
+	UINT32 xstep, ystep;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+
+	size_t count, i;
+	UINT32 ofs[8];
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	source = ds_source;
+	colormap = ds_colormap;
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (count >= 8)
+	{
+		const __m128i xshift = _mm_cvtsi32_si128((INT32)nflatxshift);
+		const __m128i yshift = _mm_cvtsi32_si128((INT32)nflatyshift);
+		const __m128i mask = _mm_set1_epi32((INT32)nflatmask);
+		const __m128i xstep4 = _mm_set1_epi32((INT32)(xstep*4));
+		const __m128i ystep4 = _mm_set1_epi32((INT32)(ystep*4));
+		__m128i x = LANES_SSE2(xposition, xstep);
+		__m128i y = LANES_SSE2(yposition, ystep);
+
+		do
+		{
+			_mm_storeu_si128((__m128i *)ofs, SPANOFS_SSE2(x, y));
+			x = _mm_add_epi32(x, xstep4);
+			y = _mm_add_epi32(y, ystep4);
+			_mm_storeu_si128((__m128i *)(ofs+4), SPANOFS_SSE2(x, y));
+			x = _mm_add_epi32(x, xstep4);
+			y = _mm_add_epi32(y, ystep4);
+
+			for (i = 0; i < 8; i++)
+				dest[i] = *(ds_transmap + (colormap[source[ofs[i]]] << 8) + dest[i]);
+			dest += 8;
+			count -= 8;
+		} while (count >= 8);
+
+		xposition = (UINT32)_mm_cvtsi128_si32(x);
+		yposition = (UINT32)_mm_cvtsi128_si32(y);
+	}
+
+	while (count--)
+	{
+		*dest = *(ds_transmap + (colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]] << 8) + *dest);
+		dest++;
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+#ifdef ESLOPE
+static void R_TiltedSpanBlock_8_SSE2(UINT8 *dest, UINT32 u, UINT32 v, UINT32 stepu, UINT32 stepv)
+{
+	const __m128i xshift = _mm_cvtsi32_si128((INT32)nflatxshift);
+	const __m128i yshift = _mm_cvtsi32_si128((INT32)nflatyshift);
+	const __m128i mask = _mm_set1_epi32((INT32)nflatmask);
+	const __m128i ustep4 = _mm_set1_epi32((INT32)(stepu*4));
+	const __m128i vstep4 = _mm_set1_epi32((INT32)(stepv*4));
+	__m128i x = LANES_SSE2(u, stepu);
+	__m128i y = LANES_SSE2(v, stepv);
+	const UINT8 *source = ds_source;
+	UINT8 *colormap;
+	UINT32 ofs[SPANSIZE];
+	int i;
+
+	for (i = 0; i < SPANSIZE; i += 4)
+	{
+		_mm_storeu_si128((__m128i *)(ofs+i), SPANOFS_SSE2(x, y));
+		x = _mm_add_epi32(x, ustep4);
+		y = _mm_add_epi32(y, vstep4);
+	}
+
+	for (i = 0; i < SPANSIZE; i++)
+	{
+		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
+		if (TILTEDCLIP(ds_x1-1))
+			dest[i] = colormap[source[ofs[i]]];
+	}
+}
+
+/**	\brief The R_DrawTiltedSpan_8_SSE2 function
+	R_DrawTiltedSpan_8, addressing 16 texels at a time
+*/
+void R_DrawTiltedSpan_8_SSE2(void)
+{
+	R_DrawTiltedSpanWith_8(R_TiltedSpanBlock_8_SSE2);
+}
+#endif
+
+#undef LANES_SSE2
+#undef SPANOFS_SSE2
+#endif // SIMD_SSE2
+
+// ==========================================================================
+// AVX2
+// ==========================================================================
+
+#ifdef SIMD_AVX2
+
+// flat offsets for 8 pixels at x, y; wants xshift, yshift and mask
+#define SPANOFS_AVX2(x, y) _mm256_or_si256(_mm256_and_si256(_mm256_srl_epi32(y, yshift), mask), \
+	_mm256_srl_epi32(x, xshift))
+
+/**	\brief	Look up 8 bytes in a table at once
+
+	The gather loads the dword ending at each byte, or the table's first
+	dword for the first 3 bytes, so it never reads outside a table of at
+	least 4 bytes.
+*/
+static inline FUNCTARGET("avx2") __m256i R_GatherBytes_AVX2(const UINT8 *table, __m256i index)
+{
+	const __m256i back = _mm256_min_epi32(index, _mm256_set1_epi32(3));
+	const __m256i dwords = _mm256_i32gather_epi32((const int *)(const void *)table, _mm256_sub_epi32(index, back), 1);
+	return _mm256_and_si256(_mm256_srlv_epi32(dwords, _mm256_slli_epi32(back, 3)), _mm256_set1_epi32(0xFF));
+}
+
+// 8 lanes of bytes down to 8 bytes
+static inline FUNCTARGET("avx2") __m128i R_PackBytes_AVX2(__m256i v)
+{
+	const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+	return _mm_packus_epi16(words, words);
+}
+
+// 8 lanes of a value stepping by step
+static inline FUNCTARGET("avx2") __m256i R_Lanes_AVX2(UINT32 p, UINT32 step)
+{
+	return _mm256_add_epi32(_mm256_set1_epi32((INT32)p),
+		_mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((INT32)step)));
+}
+
+/**	\brief The R_DrawTranslucentColumn_8_AVX2 function
+	R_DrawTranslucentColumn_8, gathering 8 texels at a time
+*/
+FUNCTARGET("avx2") void R_DrawTranslucentColumn_8_AVX2(void)
+{
+	INT32 count, i;
+	UINT8 *dest;
+	fixed_t frac, fracstep;
+	INT32 heightmask = dc_texheight - 1;
+	UINT32 pixels[8];
+
+	// Only power of two textures step evenly; the rest wrap as they go
+	if (dc_texheight & heightmask)
+	{
+		R_DrawTranslucentColumn_8();
+		return;
+	}
+
+	count = dc_yh - dc_yl + 1;
+
+	if (count <= 0) // Zero length, column does not exceed a pixel.
+		return;
+
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		I_Error("R_DrawTranslucentColumn_8_AVX2: %d to %d at %d", dc_yl, dc_yh, dc_x);
+#endif
+
+	dest = &topleft[dc_yl*vid.width + dc_x];
+
+	fracstep = dc_iscale;
+	frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, fracstep))*(!dc_hires);
+
+	{
+		const UINT8 *source = dc_source;
+		const UINT8 *transmap = dc_transmap;
+		const lighttable_t *colormap = dc_colormap;
+		const INT32 w = vid.width;
+
+		if (count >= 8)
+		{
+			const __m256i mask = _mm256_set1_epi32(heightmask);
+			const __m256i step8 = _mm256_set1_epi32((INT32)((UINT32)fracstep*8));
+			__m256i f = R_Lanes_AVX2((UINT32)frac, (UINT32)fracstep);
+			__m256i texels, back;
+
+			do
+			{
+				texels = R_GatherBytes_AVX2(source, _mm256_and_si256(_mm256_srai_epi32(f, FRACBITS), mask));
+				texels = R_GatherBytes_AVX2(colormap, texels);
+				back = _mm256_setr_epi32(dest[0], dest[w], dest[2*w], dest[3*w],
+					dest[4*w], dest[5*w], dest[6*w], dest[7*w]);
+				texels = R_GatherBytes_AVX2(transmap, _mm256_add_epi32(_mm256_slli_epi32(texels, 8), back));
+				_mm256_storeu_si256((__m256i *)pixels, texels);
+
+				for (i = 0; i < 8; i++)
+				{
+					*dest = (UINT8)pixels[i];
+					dest += w;
+				}
+				f = _mm256_add_epi32(f, step8);
+				count -= 8;
+			} while (count >= 8);
+
+			frac = _mm_cvtsi128_si32(_mm256_castsi256_si128(f));
+		}
+
+		while (count--)
+		{
+			*dest = *(transmap + (colormap[source[(frac>>FRACBITS)&heightmask]]<<8) + (*dest));
+			dest += w;
+			frac += fracstep;
+		}
+	}
+}
+
+/**	\brief The R_DrawSpan_8_AVX2 function
+	R_DrawSpan_8, gathering 8 pixels at a time
+*/
+FUNCTARGET("avx2") void R_DrawSpan_8_AVX2(void)
+{
+	UINT32 xposition;
+	UINT32 yposition;
+	UINT32 xstep, ystep;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+	const UINT8 *deststop = screens[0] + vid.rowbytes * vid.height;
+
+	size_t count;
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	source = ds_source;
+	colormap = ds_colormap;
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (dest+8 > deststop)
+		return;
+
+	if (count >= 8)
+	{
+		const __m128i xshift = _mm_cvtsi32_si128((INT32)nflatxshift);
+		const __m128i yshift = _mm_cvtsi32_si128((INT32)nflatyshift);
+		const __m256i mask = _mm256_set1_epi32((INT32)nflatmask);
+		const __m256i xstep8 = _mm256_set1_epi32((INT32)(xstep*8));
+		const __m256i ystep8 = _mm256_set1_epi32((INT32)(ystep*8));
+		__m256i x = R_Lanes_AVX2(xposition, xstep);
+		__m256i y = R_Lanes_AVX2(yposition, ystep);
+		__m256i pixels;
+
+		do
+		{
+			pixels = R_GatherBytes_AVX2(source, SPANOFS_AVX2(x, y));
+			pixels = R_GatherBytes_AVX2(colormap, pixels);
+			_mm_storel_epi64((__m128i *)dest, R_PackBytes_AVX2(pixels));
+
+			x = _mm256_add_epi32(x, xstep8);
+			y = _mm256_add_epi32(y, ystep8);
+			dest += 8;
+			count -= 8;
+		} while (count >= 8);
+
+		xposition = (UINT32)_mm_cvtsi128_si32(_mm256_castsi256_si128(x));
+		yposition = (UINT32)_mm_cvtsi128_si32(_mm256_castsi256_si128(y));
+	}
+
+	while (count-- && dest <= deststop)
+	{
+		*dest++ = colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]];
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+/**	\brief The R_DrawTranslucentSpan_8_AVX2 function
+	R_DrawTranslucentSpan_8, gathering 8 pixels at a time
+*/
+FUNCTARGET("avx2") void R_DrawTranslucentSpan_8_AVX2(void)
+{
+	UINT32 xposition;
+	UINT32 yposition;
+	UINT32 xstep, ystep;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+
+	size_t count;
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	source = ds_source;
+	colormap = ds_colormap;
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (count >= 8)
+	{
+		const __m128i xshift = _mm_cvtsi32_si128((INT32)nflatxshift);
+		const __m128i yshift = _mm_cvtsi32_si128((INT32)nflatyshift);
+		const __m256i mask = _mm256_set1_epi32((INT32)nflatmask);
+		const __m256i xstep8 = _mm256_set1_epi32((INT32)(xstep*8));
+		const __m256i ystep8 = _mm256_set1_epi32((INT32)(ystep*8));
+		__m256i x = R_Lanes_AVX2(xposition, xstep);
+		__m256i y = R_Lanes_AVX2(yposition, ystep);
+		__m256i pixels, back;
+
+		do
+		{
+			pixels = R_GatherBytes_AVX2(source, SPANOFS_AVX2(x, y));
+			pixels = R_GatherBytes_AVX2(colormap, pixels);
+			back = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)dest));
+			pixels = R_GatherBytes_AVX2(ds_transmap, _mm256_add_epi32(_mm256_slli_epi32(pixels, 8), back));
+			_mm_storel_epi64((__m128i *)dest, R_PackBytes_AVX2(pixels));
+
+			x = _mm256_add_epi32(x, xstep8);
+			y = _mm256_add_epi32(y, ystep8);
+			dest += 8;
+			count -= 8;
+		} while (count >= 8);
+
+		xposition = (UINT32)_mm_cvtsi128_si32(_mm256_castsi256_si128(x));
+		yposition = (UINT32)_mm_cvtsi128_si32(_mm256_castsi256_si128(y));
+	}
+
+	while (count--)
+	{
+		*dest = *(ds_transmap + (colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]] << 8) + *dest);
+		dest++;
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+#ifdef ESLOPE
+static FUNCTARGET("avx2") void R_TiltedSpanBlock_8_AVX2(UINT8 *dest, UINT32 u, UINT32 v, UINT32 stepu, UINT32 stepv)
+{
+	const __m128i xshift = _mm_cvtsi32_si128((INT32)nflatxshift);
+	const __m128i yshift = _mm_cvtsi32_si128((INT32)nflatyshift);
+	const __m256i mask = _mm256_set1_epi32((INT32)nflatmask);
+	const __m256i x = R_Lanes_AVX2(u, stepu);
+	const __m256i y = R_Lanes_AVX2(v, stepv);
+	const __m256i ustep8 = _mm256_set1_epi32((INT32)(stepu*8));
+	const __m256i vstep8 = _mm256_set1_epi32((INT32)(stepv*8));
+	UINT8 texels[SPANSIZE];
+	UINT8 *colormap;
+	int i;
+
+	_mm_storel_epi64((__m128i *)texels,
+		R_PackBytes_AVX2(R_GatherBytes_AVX2(ds_source, SPANOFS_AVX2(x, y))));
+	_mm_storel_epi64((__m128i *)(texels+8),
+		R_PackBytes_AVX2(R_GatherBytes_AVX2(ds_source,
+			SPANOFS_AVX2(_mm256_add_epi32(x, ustep8), _mm256_add_epi32(y, vstep8)))));
+
+	for (i = 0; i < SPANSIZE; i++)
+	{
+		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
+		if (TILTEDCLIP(ds_x1-1))
+			dest[i] = colormap[texels[i]];
+	}
+}
+
+/**	\brief The R_DrawTiltedSpan_8_AVX2 function
+	R_DrawTiltedSpan_8, gathering 16 texels at a time
+*/
+void R_DrawTiltedSpan_8_AVX2(void)
+{
+	R_DrawTiltedSpanWith_8(R_TiltedSpanBlock_8_AVX2);
+}
+#endif
+
+#undef SPANOFS_AVX2
+#endif // SIMD_AVX2
+
+// ==========================================================================
+// NEON
+// ==========================================================================
+
+#ifdef SIMD_NEON
+
+// flat offsets for 4 pixels at x, y; wants xshift, yshift (negative,
+// to shift right) and mask
+#define SPANOFS_NEON(x, y) vorrq_u32(vandq_u32(vshlq_u32(y, yshift), mask), vshlq_u32(x, xshift))
+
+// 4 lanes of a value stepping by step
+static inline uint32x4_t R_Lanes_NEON(UINT32 p, UINT32 step)
+{
+	UINT32 lanes[4];
+	lanes[0] = p;
+	lanes[1] = p + step;
+	lanes[2] = p + 2*step;
+	lanes[3] = p + 3*step;
+	return vld1q_u32(lanes);
+}
+
+/**	\brief The R_DrawTranslucentColumn_8_NEON function
+	R_DrawTranslucentColumn_8, 8 texels at a time
+*/
+void R_DrawTranslucentColumn_8_NEON(void)
+{
+	INT32 count, i;
+	UINT8 *dest;
+	fixed_t frac, fracstep;
+	INT32 heightmask = dc_texheight - 1;
+	INT32 ofs[8];
+
+	// Only power of two textures step evenly; the rest wrap as they go
+	if (dc_texheight & heightmask)
+	{
+		R_DrawTranslucentColumn_8();
+		return;
+	}
+
+	count = dc_yh - dc_yl + 1;
+
+	if (count <= 0) // Zero length, column does not exceed a pixel.
+		return;
+
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		I_Error("R_DrawTranslucentColumn_8_NEON: %d to %d at %d", dc_yl, dc_yh, dc_x);
+#endif
+
+	dest = &topleft[dc_yl*vid.width + dc_x];
+
+	fracstep = dc_iscale;
+	frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, fracstep))*(!dc_hires);
+
+	{
+		const UINT8 *source = dc_source;
+		const UINT8 *transmap = dc_transmap;
+		const lighttable_t *colormap = dc_colormap;
+
+		if (count >= 8)
+		{
+			const int32x4_t mask = vdupq_n_s32(heightmask);
+			const int32x4_t step4 = vdupq_n_s32((INT32)((UINT32)fracstep*4));
+			int32x4_t f = vreinterpretq_s32_u32(R_Lanes_NEON((UINT32)frac, (UINT32)fracstep));
+
+			do
+			{
+				vst1q_s32(ofs, vandq_s32(vshrq_n_s32(f, FRACBITS), mask));
+				f = vaddq_s32(f, step4);
+				vst1q_s32(ofs+4, vandq_s32(vshrq_n_s32(f, FRACBITS), mask));
+				f = vaddq_s32(f, step4);
+
+				for (i = 0; i < 8; i++)
+				{
+					*dest = *(transmap + (colormap[source[ofs[i]]]<<8) + (*dest));
+					dest += vid.width;
+				}
+				count -= 8;
+			} while (count >= 8);
+
+			frac = vgetq_lane_s32(f, 0);
+		}
+
+		while (count--)
+		{
+			*dest = *(transmap + (colormap[source[(frac>>FRACBITS)&heightmask]]<<8) + (*dest));
+			dest += vid.width;
+			frac += fracstep;
+		}
+	}
+}
+
+/**	\brief The R_DrawSpan_8_NEON function
+	R_DrawSpan_8, 8 pixels at a time
+*/
+void R_DrawSpan_8_NEON(void)
+{
+	UINT32 xposition;
+	UINT32 yposition;
+	UINT32 xstep, ystep;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+	const UINT8 *deststop = screens[0] + vid.rowbytes * vid.height;
+
+	size_t count, i;
+	UINT32 ofs[8];
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	source = ds_source;
+	colormap = ds_colormap;
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (dest+8 > deststop)
+		return;
+
+	if (count >= 8)
+	{
+		const int32x4_t xshift = vdupq_n_s32(-(INT32)nflatxshift);
+		const int32x4_t yshift = vdupq_n_s32(-(INT32)nflatyshift);
+		const uint32x4_t mask = vdupq_n_u32(nflatmask);
+		const uint32x4_t xstep4 = vdupq_n_u32(xstep*4);
+		const uint32x4_t ystep4 = vdupq_n_u32(ystep*4);
+		uint32x4_t x = R_Lanes_NEON(xposition, xstep);
+		uint32x4_t y = R_Lanes_NEON(yposition, ystep);
+
+		do
+		{
+			vst1q_u32(ofs, SPANOFS_NEON(x, y));
+			x = vaddq_u32(x, xstep4);
+			y = vaddq_u32(y, ystep4);
+			vst1q_u32(ofs+4, SPANOFS_NEON(x, y));
+			x = vaddq_u32(x, xstep4);
+			y = vaddq_u32(y, ystep4);
+
+			for (i = 0; i < 8; i++)
+				dest[i] = colormap[source[ofs[i]]];
+			dest += 8;
+			count -= 8;
+		} while (count >= 8);
+
+		xposition = vgetq_lane_u32(x, 0);
+		yposition = vgetq_lane_u32(y, 0);
+	}
+
+	while (count-- && dest <= deststop)
+	{
+		*dest++ = colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]];
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+/**	\brief The R_DrawTranslucentSpan_8_NEON function
+	R_DrawTranslucentSpan_8, 8 pixels at a time
+*/
+void R_DrawTranslucentSpan_8_NEON(void)
+{
+	UINT32 xposition;
+	UINT32 yposition;
+	UINT32 xstep, ystep;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+
+	size_t count, i;
+	UINT32 ofs[8];
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	source = ds_source;
+	colormap = ds_colormap;
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (count >= 8)
+	{
+		const int32x4_t xshift = vdupq_n_s32(-(INT32)nflatxshift);
+		const int32x4_t yshift = vdupq_n_s32(-(INT32)nflatyshift);
+		const uint32x4_t mask = vdupq_n_u32(nflatmask);
+		const uint32x4_t xstep4 = vdupq_n_u32(xstep*4);
+		const uint32x4_t ystep4 = vdupq_n_u32(ystep*4);
+		uint32x4_t x = R_Lanes_NEON(xposition, xstep);
+		uint32x4_t y = R_Lanes_NEON(yposition, ystep);
+
+		do
+		{
+			vst1q_u32(ofs, SPANOFS_NEON(x, y));
+			x = vaddq_u32(x, xstep4);
+			y = vaddq_u32(y, ystep4);
+			vst1q_u32(ofs+4, SPANOFS_NEON(x, y));
+			x = vaddq_u32(x, xstep4);
+			y = vaddq_u32(y, ystep4);
+
+			for (i = 0; i < 8; i++)
+				dest[i] = *(ds_transmap + (colormap[source[ofs[i]]] << 8) + dest[i]);
+			dest += 8;
+			count -= 8;
+		} while (count >= 8);
+
+		xposition = vgetq_lane_u32(x, 0);
+		yposition = vgetq_lane_u32(y, 0);
+	}
+
+	while (count--)
+	{
+		*dest = *(ds_transmap + (colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]] << 8) + *dest);
+		dest++;
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+#ifdef ESLOPE
+static void R_TiltedSpanBlock_8_NEON(UINT8 *dest, UINT32 u, UINT32 v, UINT32 stepu, UINT32 stepv)
+{
+	const int32x4_t xshift = vdupq_n_s32(-(INT32)nflatxshift);
+	const int32x4_t yshift = vdupq_n_s32(-(INT32)nflatyshift);
+	const uint32x4_t mask = vdupq_n_u32(nflatmask);
+	const uint32x4_t ustep4 = vdupq_n_u32(stepu*4);
+	const uint32x4_t vstep4 = vdupq_n_u32(stepv*4);
+	uint32x4_t x = R_Lanes_NEON(u, stepu);
+	uint32x4_t y = R_Lanes_NEON(v, stepv);
+	const UINT8 *source = ds_source;
+	UINT8 *colormap;
+	UINT32 ofs[SPANSIZE];
+	int i;
+
+	for (i = 0; i < SPANSIZE; i += 4)
+	{
+		vst1q_u32(ofs+i, SPANOFS_NEON(x, y));
+		x = vaddq_u32(x, ustep4);
+		y = vaddq_u32(y, vstep4);
+	}
+
+	for (i = 0; i < SPANSIZE; i++)
+	{
+		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
+		if (TILTEDCLIP(ds_x1-1))
+			dest[i] = colormap[source[ofs[i]]];
+	}
+}
+
+/**	\brief The R_DrawTiltedSpan_8_NEON function
+	R_DrawTiltedSpan_8, addressing 16 texels at a time
+*/
+void R_DrawTiltedSpan_8_NEON(void)
+{
+	R_DrawTiltedSpanWith_8(R_TiltedSpanBlock_8_NEON);
+}
+#endif
+
+#undef SPANOFS_NEON
+#endif // SIMD_NEON
@@ -771,6 +771,8 @@ void R_SetupFrame(player_t *player, boolean skybox)
 	camera_t *thiscam;
 	boolean chasecam = false;
 
+	R_FlushDrawQueue(); // queued drawing still needs the old view
+
 	if (splitscreen && player == &players[secondarydisplayplayer]
 		&& player != &players[consoleplayer])
 	{
@@ -878,6 +880,8 @@ void R_SkyboxFrame(player_t *player)
 {
 	camera_t *thiscam;
 
+	R_FlushDrawQueue(); // queued drawing still needs the old view
+
 	if (splitscreen && player == &players[secondarydisplayplayer]
 	&& player != &players[consoleplayer])
 		thiscam = &camera2;
@@ -1102,6 +1106,8 @@ static void R_PortalFrame(line_t *start, line_t *dest, portal_pair *portal)
 	angle_t dangle = R_PointToAngle2(0,0,dest->dx,dest->dy) - R_PointToAngle2(start->dx,start->dy,0,0);
 #endif
 
+	R_FlushDrawQueue(); // queued drawing still needs the old view
+
 	//R_SetupFrame(player, false);
 	viewx = portal->viewx;
 	viewy = portal->viewy;
@@ -1233,6 +1239,9 @@ void R_RenderPlayerView(player_t *player)
 	portalrender = 0;
 	portal_base = portal_cap = NULL;
 
+	// Columns and spans are drawn in strips across threads if we can
+	R_StartDrawQueue();
+
 	if (skybox && skyVisible)
 	{
 		R_SkyboxFrame(player);
@@ -1326,6 +1335,8 @@ void R_RenderPlayerView(player_t *player)
 	// And now 3D floors/sides!
 	R_DrawMasked();
 
+	R_FinishDrawQueue();
+
 	// Check for new console commands.
 	NetUpdate();
 
@@ -1360,6 +1371,9 @@ void R_RegisterEngineStuff(void)
 	CV_RegisterVar(&cv_drawdist);
 	CV_RegisterVar(&cv_drawdist_nights);
 	CV_RegisterVar(&cv_drawdist_precip);
+#ifdef THREADEDDRAW
+	CV_RegisterVar(&cv_drawthreads);
+#endif
 
 	CV_RegisterVar(&cv_chasecam);
 	CV_RegisterVar(&cv_chasecam2);
@@ -17,6 +17,7 @@
 #include "screen.h" // needs MAXVIDWIDTH/MAXVIDHEIGHT
 #include "r_data.h"
 #include "p_polyobj.h"
+#include "r_draw.h" // DRAWLOCAL
 
 //
 // Now what is a visplane, anyway?
@@ -69,7 +70,7 @@ extern fixed_t cachedystep[MAXVIDHEIGHT];
 extern fixed_t basexscale, baseyscale;
 
 extern fixed_t *yslope;
-extern lighttable_t **planezlight;
+extern DRAWLOCAL lighttable_t **planezlight;
 
 void R_InitPlanes(void);
 void R_PortalStoreClipValues(INT32 start, INT32 end, INT16 *ceil, INT16 *floor, fixed_t *scale);
@@ -105,7 +105,7 @@ static void R_DrawSplatColumn(column_t *column)
 			dc_texturemid = basetexturemid - (topdelta<<FRACBITS);
 
 			// Drawn by R_DrawColumn.
-			colfunc();
+			R_DrawColumnFunc(colfunc);
 		}
 		column = (column_t *)((UINT8 *)column + column->length + 4);
 	}
@@ -270,11 +270,11 @@ static void R_Render2sidedMultiPatchColumn(column_t *column)
 		dc_source = (UINT8 *)column + 3;
 
 		if (colfunc == wallcolfunc)
-			twosmultipatchfunc();
+			R_DrawColumnFunc(twosmultipatchfunc);
 		else if (colfunc == fuzzcolfunc)
-			twosmultipatchtransfunc();
+			R_DrawColumnFunc(twosmultipatchtransfunc);
 		else
-			colfunc();
+			R_DrawColumnFunc(colfunc);
 	}
 }
 
@@ -1515,7 +1515,7 @@ static void R_RenderSegLoop (void)
 #ifdef TIMING
 				ProfZeroTimer();
 #endif
-				colfunc();
+				R_DrawColumnFunc(colfunc);
 #ifdef TIMING
 				RDMSR(0x10,&mycount);
 				mytotal += mycount;      //64bit add
@@ -1563,7 +1563,7 @@ static void R_RenderSegLoop (void)
 						dc_texturemid = rw_toptexturemid;
 						dc_source = R_GetColumn(toptexture,texturecolumn);
 						dc_texheight = textureheight[toptexture]>>FRACBITS;
-						colfunc();
+						R_DrawColumnFunc(colfunc);
 						ceilingclip[rw_x] = (INT16)mid;
 					}
 					else // entirely off top of screen
@@ -1597,7 +1597,7 @@ static void R_RenderSegLoop (void)
 						dc_source = R_GetColumn(bottomtexture,
 							texturecolumn);
 						dc_texheight = textureheight[bottomtexture]>>FRACBITS;
-						colfunc();
+						R_DrawColumnFunc(colfunc);
 						floorclip[rw_x] = (INT16)mid;
 					}
 					else  // entirely off bottom of screen
@@ -685,7 +685,7 @@ void R_DrawMaskedColumn(column_t *column)
 			// FIXTHIS: Figure out what "something more proper" is and do it.
 			// quick fix... something more proper should be done!!!
 			if (ylookup[dc_yl])
-				colfunc();
+				R_DrawColumnFunc(colfunc);
 			else if (colfunc == R_DrawColumn_8
 #ifdef USEASM
 			|| colfunc == R_DrawColumn_8_ASM || colfunc == R_DrawColumn_8_MMX
@@ -749,14 +749,14 @@ static void R_DrawFlippedMaskedColumn(column_t *column, INT32 texheight)
 
 		if (dc_yl <= dc_yh && dc_yl < vid.height && dc_yh > 0)
 		{
-			dc_source = ZZ_Alloc(column->length);
+			dc_source = R_AllocColumnSource(column->length);
 			for (s = (UINT8 *)column+2+column->length, d = dc_source; d < dc_source+column->length; --s)
 				*d++ = *s;
 			dc_texturemid = basetexturemid - (topdelta<<FRACBITS);
 
 			// Still drawn by R_DrawColumn.
 			if (ylookup[dc_yl])
-				colfunc();
+				R_DrawColumnFunc(colfunc);
 			else if (colfunc == R_DrawColumn_8
 #ifdef USEASM
 			|| colfunc == R_DrawColumn_8_ASM || colfunc == R_DrawColumn_8_MMX
@@ -770,7 +770,7 @@ static void R_DrawFlippedMaskedColumn(column_t *column, INT32 texheight)
 					first = 0;
 				}
 			}
-			Z_Free(dc_source);
+			R_FreeColumnSource(dc_source);
 		}
 		column = (column_t *)((UINT8 *)column + column->length + 4);
 	}
@@ -1763,67 +1763,59 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 //
 static vissprite_t vsprsortedhead;
 
+typedef struct
+{
+	vissprite_t *spr;
+	UINT32 num; // position in the vissprite list, so equal sprites keep their order
+} vsprsort_t;
+
+static vsprsort_t vsprsortbuf[MAXVISSPRITES];
+
+//
+// R_VisSpriteCompare
+//
+// Callback for qsort: smallest scale first, then smallest dispoffset,
+// then the order the sprites were projected in.
+//
+static int R_VisSpriteCompare(const void *p1, const void *p2)
+{
+	const vsprsort_t *s1 = p1;
+	const vsprsort_t *s2 = p2;
+
+	if (s1->spr->sortscale != s2->spr->sortscale)
+		return (s1->spr->sortscale < s2->spr->sortscale) ? -1 : 1;
+	// order visprites of same scale by dispoffset, smallest first
+	if (s1->spr->dispoffset != s2->spr->dispoffset)
+		return (s1->spr->dispoffset < s2->spr->dispoffset) ? -1 : 1;
+	return (s1->num < s2->num) ? -1 : (s1->num > s2->num);
+}
+
 void R_SortVisSprites(void)
 {
 	UINT32       i;
-	vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
-	vissprite_t *best = NULL;
-	vissprite_t  unsorted;
-	fixed_t      bestscale;
-	INT32        bestdispoffset;
+	vissprite_t *ds;
+
+	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
 
 	if (!visspritecount)
 		return;
 
-	unsorted.next = unsorted.prev = &unsorted;
-
-	dsfirst = R_GetVisSprite(0);
-
-	// The first's prev and last's next will be set to
-	// nonsense, but are fixed in a moment
-	for (i = 0, dsnext = dsfirst, ds = NULL; i < visspritecount; i++)
+	for (i = 0; i < visspritecount; i++)
 	{
-		dsprev = ds;
-		ds = dsnext;
-		if (i < visspritecount - 1) dsnext = R_GetVisSprite(i + 1);
-
-		ds->next = dsnext;
-		ds->prev = dsprev;
+		vsprsortbuf[i].spr = R_GetVisSprite(i);
+		vsprsortbuf[i].num = i;
 	}
 
-	// Fix first and last. ds still points to the last one after the loop
-	dsfirst->prev = &unsorted;
-	unsorted.next = dsfirst;
-	if (ds)
-		ds->next = &unsorted;
-	unsorted.prev = ds;
+	qsort(vsprsortbuf, visspritecount, sizeof (vsprsort_t), R_VisSpriteCompare);
 
-	// pull the vissprites out by scale
-	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
+	// link the vissprites up in sorted order
 	for (i = 0; i < visspritecount; i++)
 	{
-		bestscale = bestdispoffset = INT32_MAX;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
-		{
-			if (ds->sortscale < bestscale)
-			{
-				bestscale = ds->sortscale;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-			// order visprites of same scale by dispoffset, smallest first
-			else if (ds->sortscale == bestscale && ds->dispoffset < bestdispoffset)
-			{
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-		}
-		best->next->prev = best->prev;
-		best->prev->next = best->next;
-		best->next = &vsprsortedhead;
-		best->prev = vsprsortedhead.prev;
-		vsprsortedhead.prev->next = best;
-		vsprsortedhead.prev = best;
+		ds = vsprsortbuf[i].spr;
+		ds->next = &vsprsortedhead;
+		ds->prev = vsprsortedhead.prev;
+		vsprsortedhead.prev->next = ds;
+		vsprsortedhead.prev = ds;
 	}
 }
 
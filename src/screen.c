@@ -47,6 +47,10 @@ void (*shadecolfunc)(void); // smokie test..
 void (*spanfunc)(void); // span drawer, use a 64x64 tile
 void (*splatfunc)(void); // span drawer w/ transparency
 void (*basespanfunc)(void); // default span func for color mode
+void (*transspanfunc)(void); // translucent span drawer
+#ifdef ESLOPE
+void (*tiltedspanfunc)(void); // sloped span drawer
+#endif
 void (*transtransfunc)(void); // translucent translated column drawer
 void (*twosmultipatchfunc)(void); // for cols with transparent pixels
 void (*twosmultipatchtransfunc)(void); // for cols with transparent pixels AND translucency
@@ -95,6 +99,8 @@ boolean R_SSE = false;
 boolean R_3DNow = false;
 boolean R_MMXExt = false;
 boolean R_SSE2 = false;
+boolean R_AVX2 = false;
+boolean R_NEON = false;
 
 
 void SCR_SetMode(void)
@@ -115,6 +121,10 @@ void SCR_SetMode(void)
 	if (true)//vid.bpp == 1) //Always run in 8bpp. todo: remove all 16bpp code?
 	{
 		spanfunc = basespanfunc = R_DrawSpan_8;
+		transspanfunc = R_DrawTranslucentSpan_8;
+#ifdef ESLOPE
+		tiltedspanfunc = R_DrawTiltedSpan_8;
+#endif
 		splatfunc = R_DrawSplat_8;
 		transcolfunc = R_DrawTranslatedColumn_8;
 		transtransfunc = R_DrawTranslatedTranslucentColumn_8;
@@ -125,6 +135,40 @@ void SCR_SetMode(void)
 		walldrawerfunc = R_DrawWallColumn_8;
 		twosmultipatchfunc = R_Draw2sMultiPatchColumn_8;
 		twosmultipatchtransfunc = R_Draw2sMultiPatchTranslucentColumn_8;
+#ifdef SIMD_AVX2
+		if (R_ASM && R_AVX2)
+		{
+			spanfunc = basespanfunc = R_DrawSpan_8_AVX2;
+			transspanfunc = R_DrawTranslucentSpan_8_AVX2;
+#ifdef ESLOPE
+			tiltedspanfunc = R_DrawTiltedSpan_8_AVX2;
+#endif
+			fuzzcolfunc = R_DrawTranslucentColumn_8_AVX2;
+		}
+		else
+#endif
+#ifdef SIMD_SSE2
+		if (R_ASM && R_SSE2)
+		{
+			spanfunc = basespanfunc = R_DrawSpan_8_SSE2;
+			transspanfunc = R_DrawTranslucentSpan_8_SSE2;
+#ifdef ESLOPE
+			tiltedspanfunc = R_DrawTiltedSpan_8_SSE2;
+#endif
+			fuzzcolfunc = R_DrawTranslucentColumn_8_SSE2;
+		}
+#endif
+#ifdef SIMD_NEON
+		if (R_ASM && R_NEON)
+		{
+			spanfunc = basespanfunc = R_DrawSpan_8_NEON;
+			transspanfunc = R_DrawTranslucentSpan_8_NEON;
+#ifdef ESLOPE
+			tiltedspanfunc = R_DrawTiltedSpan_8_NEON;
+#endif
+			fuzzcolfunc = R_DrawTranslucentColumn_8_NEON;
+		}
+#endif
 #ifdef RUSEASM
 		if (R_ASM)
 		{
@@ -195,7 +239,11 @@ void SCR_Startup(void)
 			R_SSE = true;
 		if (RCpuInfo->SSE2)
 			R_SSE2 = true;
-		CONS_Printf("CPU Info: 486: %i, 586: %i, MMX: %i, 3DNow: %i, MMXExt: %i, SSE2: %i\n", R_486, R_586, R_MMX, R_3DNow, R_MMXExt, R_SSE2);
+		if (RCpuInfo->AVX2)
+			R_AVX2 = true;
+		if (RCpuInfo->NEON)
+			R_NEON = true;
+		CONS_Printf("CPU Info: 486: %i, 586: %i, MMX: %i, 3DNow: %i, MMXExt: %i, SSE2: %i, AVX2: %i, NEON: %i\n", R_486, R_586, R_MMX, R_3DNow, R_MMXExt, R_SSE2, R_AVX2, R_NEON);
 	}
 
 	if (M_CheckParm("-noASM"))
@@ -218,6 +266,17 @@ void SCR_Startup(void)
 
 	if (M_CheckParm("-SSE2"))
 		R_SSE2 = true;
+	if (M_CheckParm("-noSSE2"))
+		R_SSE2 = false;
+
+	if (M_CheckParm("-noAVX2"))
+		R_AVX2 = false;
+
+#ifdef __aarch64__
+	R_NEON = true; // always there on 64-bit ARM
+#endif
+	if (M_CheckParm("-noNEON"))
+		R_NEON = false;
 
 	M_SetupMemcpy();
 
@@ -133,6 +133,10 @@ extern void (*transcolfunc)(void);
 extern void (*shadecolfunc)(void);
 extern void (*spanfunc)(void);
 extern void (*basespanfunc)(void);
+extern void (*transspanfunc)(void);
+#ifdef ESLOPE
+extern void (*tiltedspanfunc)(void);
+#endif
 extern void (*splatfunc)(void);
 extern void (*transtransfunc)(void);
 extern void (*twosmultipatchfunc)(void);
@@ -148,6 +152,8 @@ extern boolean R_MMX;
 extern boolean R_3DNow;
 extern boolean R_MMXExt;
 extern boolean R_SSE2;
+extern boolean R_AVX2;
+extern boolean R_NEON;
 
 // ----------------
 // screen variables
@@ -2073,6 +2073,21 @@ tic_t I_GetTime (void)
 }
 #endif
 
+//
+// I_GetTimeMicros
+// returns a profiling timestamp in microseconds
+//
+UINT64 I_GetTimeMicros(void)
+{
+	static Uint64 frequency = 0;
+	Uint64 counter = SDL_GetPerformanceCounter();
+
+	if (!frequency)
+		frequency = SDL_GetPerformanceFrequency();
+
+	return (UINT64)((counter / frequency) * 1000000 + (counter % frequency) * 1000000 / frequency);
+}
+
 //
 //I_StartupTimer
 //
@@ -2945,6 +2960,12 @@ const CPUInfoFlags *I_CPUInfo(void)
 	}
 	WIN_CPUInfo.MMXExt      = SDL_FALSE; //SDL_HasMMXExt(); No longer in SDL2
 	WIN_CPUInfo.AMD3DNowExt = SDL_FALSE; //SDL_Has3DNowExt(); No longer in SDL2
+#if SDL_VERSION_ATLEAST(2,0,4)
+	WIN_CPUInfo.AVX2        = SDL_HasAVX2(); // no PF_ flag for it
+#endif
+#if SDL_VERSION_ATLEAST(2,0,6)
+	WIN_CPUInfo.NEON        = SDL_HasNEON();
+#endif
 #endif
 	GetSystemInfo(&SI);
 	WIN_CPUInfo.CPUs = SI.dwNumberOfProcessors;
@@ -2962,6 +2983,12 @@ const CPUInfoFlags *I_CPUInfo(void)
 	SDL_CPUInfo.SSE         = SDL_HasSSE();
 	SDL_CPUInfo.SSE2        = SDL_HasSSE2();
 	SDL_CPUInfo.AltiVec     = SDL_HasAltiVec();
+#if SDL_VERSION_ATLEAST(2,0,4)
+	SDL_CPUInfo.AVX2        = SDL_HasAVX2();
+#endif
+#if SDL_VERSION_ATLEAST(2,0,6)
+	SDL_CPUInfo.NEON        = SDL_HasNEON();
+#endif
 	return &SDL_CPUInfo;
 #else
 	return NULL; /// \todo CPUID asm
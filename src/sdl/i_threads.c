@@ -0,0 +1,127 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1999-2018 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file
+/// \brief SDL multithreading interface
+
+#include "../doomdef.h"
+
+#if defined (HAVE_SDL) && defined (HAVE_THREADS)
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4214 4244)
+#endif
+
+#include "SDL.h"
+
+#ifdef _MSC_VER
+#pragma warning(default : 4214 4244)
+#endif
+
+#include "../i_system.h"
+#include "../i_threads.h"
+
+typedef struct
+{
+	I_thread_fn func;
+	void *userdata;
+} thread_start_t;
+
+// guards the lazy creation of mutexes and conditions
+static SDL_SpinLock anchorlock;
+
+static int SDLCALL ThreadStart(void *data)
+{
+	thread_start_t start = *(thread_start_t *)data;
+	free(data);
+	start.func(start.userdata);
+	return 0;
+}
+
+INT32 I_GetCPUCount(void)
+{
+	INT32 count = SDL_GetCPUCount();
+	return (count > 0) ? count : 1;
+}
+
+boolean I_SpawnThread(const char *name, I_thread_fn func, void *userdata)
+{
+	SDL_Thread *thread;
+	thread_start_t *start = malloc(sizeof (*start));
+
+	if (!start)
+		return false;
+
+	start->func = func;
+	start->userdata = userdata;
+
+	thread = SDL_CreateThread(ThreadStart, name, start);
+	if (!thread)
+	{
+		free(start);
+		return false;
+	}
+
+	SDL_DetachThread(thread);
+	return true;
+}
+
+static SDL_mutex *GetMutex(I_mutex *anchor)
+{
+	SDL_AtomicLock(&anchorlock);
+	if (!*anchor && !(*anchor = SDL_CreateMutex()))
+		I_Error("I_LockMutex: %s", SDL_GetError());
+	SDL_AtomicUnlock(&anchorlock);
+	return *anchor;
+}
+
+static SDL_cond *GetCond(I_cond *anchor)
+{
+	SDL_AtomicLock(&anchorlock);
+	if (!*anchor && !(*anchor = SDL_CreateCond()))
+		I_Error("I_HoldCond: %s", SDL_GetError());
+	SDL_AtomicUnlock(&anchorlock);
+	return *anchor;
+}
+
+void I_LockMutex(I_mutex *anchor)
+{
+	if (SDL_LockMutex(GetMutex(anchor)) == -1)
+		I_Error("I_LockMutex: %s", SDL_GetError());
+}
+
+void I_UnlockMutex(I_mutex mutex)
+{
+	if (SDL_UnlockMutex(mutex) == -1)
+		I_Error("I_UnlockMutex: %s", SDL_GetError());
+}
+
+void I_HoldCond(I_cond *anchor, I_mutex mutex)
+{
+	if (SDL_CondWait(GetCond(anchor), mutex) == -1)
+		I_Error("I_HoldCond: %s", SDL_GetError());
+}
+
+void I_WakeOneCond(I_cond *anchor)
+{
+	if (SDL_CondSignal(GetCond(anchor)) == -1)
+		I_Error("I_WakeOneCond: %s", SDL_GetError());
+}
+
+void I_WakeAllCond(I_cond *anchor)
+{
+	if (SDL_CondBroadcast(GetCond(anchor)) == -1)
+		I_Error("I_WakeAllCond: %s", SDL_GetError());
+}
+
+void I_SleepThread(UINT32 ms)
+{
+	SDL_Delay(ms);
+}
+
+#endif
@@ -2189,6 +2189,15 @@ tic_t I_GetTime (void)
 }
 #endif
 
+//
+// I_GetTimeMicros
+// returns a profiling timestamp in microseconds, SDL 1.2 only has milliseconds
+//
+UINT64 I_GetTimeMicros(void)
+{
+	return (UINT64)SDL_GetTicks() * 1000;
+}
+
 //
 //I_StartupTimer
 //
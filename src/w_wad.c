@@ -26,6 +26,15 @@
 #include "lzf.h"
 #endif
 
+// Map wad files into memory instead of reading lumps through stdio
+#if defined (UNIXCOMMON) && !defined (NOMMAP)
+#define WADMMAP
+#endif
+
+#ifdef WADMMAP
+#include <sys/mman.h>
+#endif
+
 #include "doomdef.h"
 #include "doomstat.h"
 #include "doomtype.h"
@@ -44,6 +53,7 @@
 #include "i_system.h"
 #include "md5.h"
 #include "lua_script.h"
+#include "i_threads.h"
 #ifdef SCANTHINGS
 #include "p_setup.h" // P_ScanThings
 #endif
@@ -102,12 +112,54 @@ typedef struct lumpnum_cache_s
 static lumpnum_cache_t lumpnumcache[LUMPNUMCACHESIZE];
 static UINT16 lumpnumcacheindex = 0;
 
+static void W_FlushDecompressedLumps(INT32 wad);
+
 //===========================================================================
 //                                                                    GLOBALS
 //===========================================================================
 UINT16 numwadfiles; // number of active wadfiles
 wadfile_t *wadfiles[MAX_WADFILES]; // 0 to numwadfiles-1 are valid
 
+// Maps a wad file into memory, read-only.
+// Returns NULL if the file can't be mapped; lumps are read through stdio then.
+static UINT8 *W_MapWadFile(FILE *handle, UINT32 filesize)
+{
+#ifdef WADMMAP
+	void *mapping;
+
+	if (!filesize)
+		return NULL;
+
+	mapping = mmap(NULL, filesize, PROT_READ, MAP_PRIVATE, fileno(handle), 0);
+	if (mapping != MAP_FAILED)
+		return mapping;
+
+	CONS_Debug(DBG_SETUP, "W_MapWadFile: could not map file, using stdio\n");
+#else
+	(void)handle;
+	(void)filesize;
+#endif
+	return NULL;
+}
+
+static void W_UnmapWadFile(wadfile_t *wadfile)
+{
+#ifdef WADMMAP
+	if (wadfile->mapping)
+		munmap(wadfile->mapping, wadfile->filesize);
+#endif
+	wadfile->mapping = NULL;
+}
+
+// Returns where a lump's raw data starts in the mapped file,
+// or NULL if the file isn't mapped.
+static inline UINT8 *W_MappedLumpData(wadfile_t *wadfile, lumpinfo_t *l)
+{
+	if (wadfile->mapping && l->position + l->disksize <= wadfile->filesize)
+		return wadfile->mapping + l->position;
+	return NULL;
+}
+
 // W_Shutdown
 // Closes all of the WAD files before quitting
 // If not done on a Mac then open wad files
@@ -115,13 +167,16 @@ wadfile_t *wadfiles[MAX_WADFILES]; // 0 to numwadfiles-1 are valid
 // being ejected
 void W_Shutdown(void)
 {
+	W_FlushDecompressedLumps(-1);
 	while (numwadfiles--)
 	{
+		W_UnmapWadFile(wadfiles[numwadfiles]);
 		fclose(wadfiles[numwadfiles]->handle);
 		Z_Free(wadfiles[numwadfiles]->filename);
 		while (wadfiles[numwadfiles]->numlumps--)
 			Z_Free(wadfiles[numwadfiles]->lumpinfo[wadfiles[numwadfiles]->numlumps].name2);
 		Z_Free(wadfiles[numwadfiles]->lumpinfo);
+		Z_Free(wadfiles[numwadfiles]->namehash);
 		Z_Free(wadfiles[numwadfiles]);
 	}
 }
@@ -309,22 +364,9 @@ static inline INT32 W_MakeFileMD5(const char *filename, void *resblock)
 	(void)filename;
 	memset(resblock, 0x00, 16);
 #else
-	FILE *fhandle;
-
-	if ((fhandle = fopen(filename, "rb")) != NULL)
-	{
-		tic_t t = I_GetTime();
-		CONS_Debug(DBG_SETUP, "Making MD5 for %s\n",filename);
-		if (md5_stream(fhandle, resblock) == 1)
-		{
-			fclose(fhandle);
-			return 1;
-		}
-		CONS_Debug(DBG_SETUP, "MD5 calc for %s took %f seconds\n",
-			filename, (float)(I_GetTime() - t)/NEWTICRATE);
-		fclose(fhandle);
+	// Files that haven't changed since they were last hashed come from the MD5 index
+	if (D_FileMD5(filename, resblock))
 		return 0;
-	}
 #endif
 	return 1;
 }
@@ -335,6 +377,55 @@ static void W_InvalidateLumpnumCache(void)
 	memset(lumpnumcache, 0, sizeof (lumpnumcache));
 }
 
+// Hashes a lump name, ignoring case, so lookups that are case sensitive
+// and lookups that aren't can share the same chains.
+// At most len characters of the name are used.
+static UINT32 W_HashLumpName(const char *name, size_t len)
+{
+	UINT32 hash = 5381;
+
+	for (; len && *name; len--, name++)
+		hash = (hash * 33) ^ (UINT8)toupper(*name);
+
+	return hash;
+}
+
+// Builds the lump name hash chains of a wad file, for both the 8-char
+// names and the full (PK3) names. Lumps are linked last to first, so
+// every chain lists its lumps in directory order.
+static void W_MakeLumpHash(wadfile_t *wadfile)
+{
+	UINT32 size = 1, h;
+	UINT16 i;
+	lumpinfo_t *lump_p;
+
+	while (size < wadfile->numlumps)
+		size <<= 1;
+
+	// heads and links of both hashes live in a single block
+	wadfile->lumphashmask = (UINT16)(size - 1);
+	wadfile->namehash = Z_Malloc((size + wadfile->numlumps) * 2 * sizeof (UINT16), PU_STATIC, NULL);
+	wadfile->fullnamehash = wadfile->namehash + size;
+	wadfile->namenext = wadfile->fullnamehash + size;
+	wadfile->fullnamenext = wadfile->namenext + wadfile->numlumps;
+
+	for (h = 0; h < size; h++)
+		wadfile->namehash[h] = wadfile->fullnamehash[h] = INT16_MAX;
+
+	for (i = wadfile->numlumps, lump_p = wadfile->lumpinfo + i; i--;)
+	{
+		lump_p--;
+
+		h = W_HashLumpName(lump_p->name, 8) & wadfile->lumphashmask;
+		wadfile->namenext[i] = wadfile->namehash[h];
+		wadfile->namehash[h] = i;
+
+		h = W_HashLumpName(lump_p->name2, (size_t)-1) & wadfile->lumphashmask;
+		wadfile->fullnamenext[i] = wadfile->fullnamehash[h];
+		wadfile->fullnamehash[h] = i;
+	}
+}
+
 /** Detect a file type.
  * \todo Actually detect the wad/pkzip headers and whatnot, instead of just checking the extensions.
  */
@@ -781,8 +872,12 @@ UINT16 W_InitFile(const char *filename)
 	wadfile->important = important;
 	fseek(handle, 0, SEEK_END);
 	wadfile->filesize = (unsigned)ftell(handle);
+	wadfile->mapping = W_MapWadFile(handle, wadfile->filesize);
 	wadfile->type = type;
 
+	// index the lump names for the W_CheckNumFor* functions
+	W_MakeLumpHash(wadfile);
+
 	// already generated, just copy it over
 	M_Memcpy(&wadfile->md5sum, &md5sum, 16);
 
@@ -854,9 +949,13 @@ void W_UnloadWadFile(UINT16 num)
 			Z_ChangeTag(lumpcache[i], PU_PURGELEVEL);
 	}
 	Z_Free(lumpcache);
+	Z_Free(delwad->namehash);
+	W_FlushDecompressedLumps(num);
+	W_UnmapWadFile(delwad);
 	fclose(delwad->handle);
 	Z_Free(delwad->filename);
 	Z_Free(delwad);
+	W_InvalidateLumpnumCache(); // it may still point into the removed file
 	CONS_Printf(M_GetText("Done unloading WAD.\n"));
 }
 #endif
@@ -949,10 +1048,10 @@ UINT16 W_CheckNumForNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 	//
 	if (startlump < wadfiles[wad]->numlumps)
 	{
-		lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
-		for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
+		wadfile_t *wadfile = wadfiles[wad];
+		for (i = wadfile->namehash[W_HashLumpName(uname, 8) & wadfile->lumphashmask]; i != INT16_MAX; i = wadfile->namenext[i])
 		{
-			if (memcmp(lump_p->name,uname,8) == 0)
+			if (i >= startlump && memcmp(wadfile->lumpinfo[i].name,uname,8) == 0)
 				return i;
 		}
 	}
@@ -993,11 +1092,11 @@ UINT16 W_CheckNumForFolderEndPK3(const char *name, UINT16 wad, UINT16 startlump)
 // Returns lump position in PK3's lumpinfo, or INT16_MAX if not found.
 UINT16 W_CheckNumForFullNamePK3(const char *name, UINT16 wad, UINT16 startlump)
 {
-	INT32 i;
-	lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
-	for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
+	UINT16 i;
+	wadfile_t *wadfile = wadfiles[wad];
+	for (i = wadfile->fullnamehash[W_HashLumpName(name, (size_t)-1) & wadfile->lumphashmask]; i != INT16_MAX; i = wadfile->fullnamenext[i])
 	{
-		if (!strnicmp(name, lump_p->name2, strlen(name)))
+		if (i >= startlump && fasticmp(name, wadfile->lumpinfo[i].name2))
 		{
 			return i;
 		}
@@ -1048,29 +1147,31 @@ lumpnum_t W_CheckNumForName(const char *name)
 
 // Look for valid map data through all added files in descendant order.
 // Get a map marker for WADs, and a standalone WAD file lump inside PK3s.
-// TODO: Make it search through cache first, maybe...?
 lumpnum_t W_CheckNumForMap(const char *name)
 {
-	UINT16 lumpNum, end;
-	UINT32 i;
+	UINT16 lumpNum, start, end;
+	UINT32 i, hash = W_HashLumpName(name, 8);
+	wadfile_t *wadfile;
 	for (i = numwadfiles - 1; i < numwadfiles; i--)
 	{
-		if (wadfiles[i]->type == RET_WAD)
+		wadfile = wadfiles[i];
+		if (wadfile->type == RET_WAD)
 		{
-			for (lumpNum = 0; lumpNum < wadfiles[i]->numlumps; lumpNum++)
-				if (!strncmp(name, (wadfiles[i]->lumpinfo + lumpNum)->name, 8))
+			for (lumpNum = wadfile->namehash[hash & wadfile->lumphashmask]; lumpNum != INT16_MAX; lumpNum = wadfile->namenext[lumpNum])
+				if (!strncmp(name, (wadfile->lumpinfo + lumpNum)->name, 8))
 					return (i<<16) + lumpNum;
 		}
-		else if (wadfiles[i]->type == RET_PK3)
+		else if (wadfile->type == RET_PK3)
 		{
-			lumpNum = W_CheckNumForFolderStartPK3("maps/", i, 0);
-			if (lumpNum != INT16_MAX)
-				end = W_CheckNumForFolderEndPK3("maps/", i, lumpNum);
+			start = W_CheckNumForFolderStartPK3("maps/", i, 0);
+			if (start != INT16_MAX)
+				end = W_CheckNumForFolderEndPK3("maps/", i, start);
 			else
 				continue;
 			// Now look for the specified map.
-			for (++lumpNum; lumpNum < end; lumpNum++)
-				if (!strnicmp(name, (wadfiles[i]->lumpinfo + lumpNum)->name, 8))
+			for (lumpNum = wadfile->namehash[hash & wadfile->lumphashmask]; lumpNum != INT16_MAX; lumpNum = wadfile->namenext[lumpNum])
+				if (lumpNum > start && lumpNum < end
+					&& !strnicmp(name, (wadfile->lumpinfo + lumpNum)->name, 8))
 					return (i<<16) + lumpNum;
 		}
 	}
@@ -1234,8 +1335,445 @@ static void ErrorIfPNG(UINT8 *d, size_t s, char *f, char *l)
 }
 #endif
 
+// ==========================================================================
+// DECOMPRESSED LUMP CACHE
+// ==========================================================================
+//
+// Compressed lumps are decompressed in full whatever part of them is read,
+// so the decompressed bytes of the most recently used ones are kept around.
+// Reading them again, or reading another part of them, is then just a copy.
+// The zone can't be used from the prefetch threads, so this is malloc'd.
+//
+
+#define LUMPDECACHESLOTS 256
+#define LUMPDECACHESIZE (16<<20) // decompressed bytes kept at most
+#define LUMPDECACHEMAXLUMP (LUMPDECACHESIZE/4) // bigger lumps aren't kept
+#define MAXPREFETCHTHREADS 8
+
+typedef struct lumpdecache_s
+{
+	UINT8 *data; // NULL if this slot is free
+	size_t size;
+	UINT16 wad, lump;
+	struct lumpdecache_s *prev, *next; // most recently used first
+} lumpdecache_t;
+
+static lumpdecache_t lumpdecache[LUMPDECACHESLOTS];
+static lumpdecache_t *lumpdecachehead, *lumpdecachetail;
+static size_t lumpdecacheused; // decompressed bytes held
+
+static void W_UnlinkDecompressedLump(lumpdecache_t *entry)
+{
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		lumpdecachehead = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		lumpdecachetail = entry->prev;
+	entry->prev = entry->next = NULL;
+}
+
+static void W_LinkDecompressedLump(lumpdecache_t *entry)
+{
+	entry->prev = NULL;
+	entry->next = lumpdecachehead;
+	if (lumpdecachehead)
+		lumpdecachehead->prev = entry;
+	else
+		lumpdecachetail = entry;
+	lumpdecachehead = entry;
+}
+
+static void W_FreeDecompressedLump(lumpdecache_t *entry)
+{
+	W_UnlinkDecompressedLump(entry);
+	free(entry->data);
+	entry->data = NULL;
+	lumpdecacheused -= entry->size;
+}
+
+// Returns the decompressed bytes of a lump if they're kept, marking them as just used.
+static UINT8 *W_FindDecompressedLump(UINT16 wad, UINT16 lump)
+{
+	lumpdecache_t *entry;
+
+	for (entry = lumpdecachehead; entry; entry = entry->next)
+	{
+		if (entry->wad == wad && entry->lump == lump)
+		{
+			if (entry != lumpdecachehead)
+			{
+				W_UnlinkDecompressedLump(entry);
+				W_LinkDecompressedLump(entry);
+			}
+			return entry->data;
+		}
+	}
+
+	return NULL;
+}
+
+// Keeps the decompressed bytes of a lump, dropping the least recently
+// used ones to make room. Returns false if the lump is too big to keep,
+// in which case the caller still owns data.
+static boolean W_StoreDecompressedLump(UINT16 wad, UINT16 lump, UINT8 *data, size_t size)
+{
+	lumpdecache_t *entry;
+
+	if (size > LUMPDECACHEMAXLUMP)
+		return false;
+
+	while (lumpdecachetail && lumpdecacheused + size > LUMPDECACHESIZE)
+		W_FreeDecompressedLump(lumpdecachetail);
+
+	for (entry = lumpdecache; entry < lumpdecache + LUMPDECACHESLOTS; entry++)
+		if (!entry->data)
+			break;
+
+	if (entry == lumpdecache + LUMPDECACHESLOTS) // all slots used
+	{
+		entry = lumpdecachetail;
+		W_FreeDecompressedLump(entry);
+	}
+
+	entry->data = data;
+	entry->size = size;
+	entry->wad = wad;
+	entry->lump = lump;
+	lumpdecacheused += size;
+	W_LinkDecompressedLump(entry);
+	return true;
+}
+
+// Drops the decompressed lumps of one wad file, or of all of them if wad is -1.
+static void W_FlushDecompressedLumps(INT32 wad)
+{
+	lumpdecache_t *entry, *next;
+
+	for (entry = lumpdecachehead; entry; entry = next)
+	{
+		next = entry->next;
+		if (wad == -1 || entry->wad == wad)
+			W_FreeDecompressedLump(entry);
+	}
+}
+
+// Decompresses the raw data of a lump into dest, which holds l->size bytes.
+// Only touches the buffers it's given, so any thread can call it.
+// Returns 0 on success, otherwise the errno (LZF) or zlib error code.
+static INT32 W_DecompressLumpData(const lumpinfo_t *l, const UINT8 *rawData, UINT8 *dest)
+{
+	switch (l->compression)
+	{
+#ifdef ZWAD
+	case CM_LZF:
+		{
+			size_t retval = lzf_decompress(rawData, l->disksize, dest, l->size); // lzf_decompress returns 0 when an error occurs.
+			if (retval == l->size)
+				return 0;
+#ifndef AVOID_ERRNO
+			// errno is a global var set by the lzf functions when something goes wrong.
+			if (retval == 0 && (errno == E2BIG || errno == EINVAL))
+				return errno;
+#endif
+			return -1;
+		}
+#endif
+#ifdef HAVE_ZLIB
+	case CM_DEFLATE:
+		{
+			int zErr; // Helper var.
+			z_stream strm;
+
+			strm.zalloc = Z_NULL;
+			strm.zfree = Z_NULL;
+			strm.opaque = Z_NULL;
+
+			strm.total_in = strm.avail_in = l->disksize;
+			strm.total_out = strm.avail_out = l->size;
+
+			strm.next_in = (Bytef *)rawData;
+			strm.next_out = dest;
+
+			zErr = inflateInit2(&strm, -15);
+			if (zErr != Z_OK)
+				return zErr;
+
+			zErr = inflate(&strm, Z_FINISH);
+			(void)inflateEnd(&strm);
+
+			if (zErr == Z_STREAM_END)
+				return 0;
+			return (zErr == Z_OK) ? Z_BUF_ERROR : zErr;
+		}
+#endif
+	default:
+		return -1;
+	}
+}
+
+// Reads the raw (compressed) data of a lump.
+// Returns where it is in the mapped file, or a buffer to free afterwards.
+static UINT8 *W_ReadRawLump(UINT16 wad, UINT16 lump, boolean *mustfree)
+{
+	lumpinfo_t *l = wadfiles[wad]->lumpinfo + lump;
+	UINT8 *rawData = W_MappedLumpData(wadfiles[wad], l);
+
+	*mustfree = (rawData == NULL);
+	if (rawData)
+		return rawData;
+
+	rawData = malloc(l->disksize ? l->disksize : 1);
+	if (!rawData)
+		I_Error("wad %d, lump %d: out of memory reading compressed data", wad, lump);
+
+	fseek(wadfiles[wad]->handle, (long)l->position, SEEK_SET);
+	if (fread(rawData, 1, l->disksize, wadfiles[wad]->handle) < l->disksize)
+		I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+
+	return rawData;
+}
+
+// Returns the decompressed bytes of a compressed lump, from the cache if
+// they're there. If *cached is false afterwards, the caller must free them.
+// Returns NULL if the lump couldn't be decompressed.
+static UINT8 *W_DecompressLump(UINT16 wad, UINT16 lump, boolean *cached)
+{
+	lumpinfo_t *l = wadfiles[wad]->lumpinfo + lump;
+	UINT8 *rawData, *decData;
+	boolean freeraw;
+	INT32 err;
+
+	if ((decData = W_FindDecompressedLump(wad, lump)) != NULL)
+	{
+		*cached = true;
+		return decData;
+	}
+
+	rawData = W_ReadRawLump(wad, lump, &freeraw);
+	decData = malloc(l->size ? l->size : 1);
+	if (!decData)
+		I_Error("wad %d, lump %d: out of memory decompressing data", wad, lump);
+
+	err = W_DecompressLumpData(l, rawData, decData);
+	if (freeraw)
+		free(rawData);
+
+	if (err)
+	{
+		free(decData);
+		switch (l->compression)
+		{
+#ifdef ZWAD
+		case CM_LZF:
+#ifndef AVOID_ERRNO
+			if (err == E2BIG)
+				I_Error("wad %d, lump %d: compressed data too big (bigger than %s)", wad, lump, sizeu1(l->size));
+			else if (err == EINVAL)
+				I_Error("wad %d, lump %d: invalid compressed data", wad, lump);
+#endif
+			I_Error("wad %d, lump %d: decompressed to wrong number of bytes (expected %s)", wad, lump, sizeu1(l->size));
+			break;
+#endif
+#ifdef HAVE_ZLIB
+		case CM_DEFLATE:
+			zerr(err);
+			break;
+#endif
+		default:
+			break;
+		}
+		return NULL;
+	}
+
+	*cached = W_StoreDecompressedLump(wad, lump, decData, l->size);
+	return decData;
+}
+
+typedef struct
+{
+	UINT16 wad, lump;
+	UINT8 *rawData, *decData;
+	boolean freeraw;
+	INT32 err;
+} prefetchjob_t;
+
+static prefetchjob_t *prefetchjobs;
+static size_t numprefetchjobs, nextprefetchjob;
+
+#ifdef HAVE_THREADS
+static I_mutex prefetch_mutex;
+static I_cond prefetch_cond;
+static INT32 prefetchworkers; // worker threads still running
+#endif
+
+// Decompresses prefetch jobs until there are none left.
+static void W_RunPrefetchJobs(void)
+{
+	prefetchjob_t *job;
+	const lumpinfo_t *l;
+
+	for (;;)
+	{
+#ifdef HAVE_THREADS
+		I_LockMutex(&prefetch_mutex);
+#endif
+		job = (nextprefetchjob < numprefetchjobs) ? &prefetchjobs[nextprefetchjob++] : NULL;
+#ifdef HAVE_THREADS
+		I_UnlockMutex(prefetch_mutex);
+#endif
+		if (!job)
+			return;
+
+		l = wadfiles[job->wad]->lumpinfo + job->lump;
+		job->decData = malloc(l->size ? l->size : 1);
+		job->err = job->decData ? W_DecompressLumpData(l, job->rawData, job->decData) : -1;
+	}
+}
+
+#ifdef HAVE_THREADS
+static void W_PrefetchThread(void *userdata)
+{
+	(void)userdata;
+	W_RunPrefetchJobs();
+
+	I_LockMutex(&prefetch_mutex);
+	prefetchworkers--;
+	I_WakeAllCond(&prefetch_cond);
+	I_UnlockMutex(prefetch_mutex);
+}
+#endif
+
+static int W_CompareLumpnums(const void *a, const void *b)
+{
+	lumpnum_t la = *(const lumpnum_t *)a, lb = *(const lumpnum_t *)b;
+	return (la > lb) - (la < lb);
+}
+
+/** Decompresses lumps that are going to be needed soon, so reading
+  * them later just copies them out of the decompressed lump cache.
+  * The work is spread over as many threads as there are processors.
+  * Uncompressed lumps, lumps that are already kept and lumps past
+  * what the cache can hold are skipped.
+  *
+  * \param lumps The lumps to decompress. Duplicates are fine.
+  * \param count Number of lumps in the list.
+  */
+void W_PrefetchLumps(const lumpnum_t *lumps, size_t count)
+{
+	lumpnum_t *sorted;
+	size_t i, total = 0;
+	UINT16 wad, lump;
+	lumpinfo_t *l;
+	prefetchjob_t *job;
+
+	if (!count)
+		return;
+
+	// sort them so duplicates are next to each other
+	sorted = malloc(count * sizeof (*sorted));
+	prefetchjobs = malloc(count * sizeof (*prefetchjobs));
+	if (!sorted || !prefetchjobs)
+	{
+		free(sorted);
+		free(prefetchjobs);
+		prefetchjobs = NULL;
+		return;
+	}
+	M_Memcpy(sorted, lumps, count * sizeof (*sorted));
+	qsort(sorted, count, sizeof (*sorted), W_CompareLumpnums);
+
+	numprefetchjobs = nextprefetchjob = 0;
+	for (i = 0; i < count; i++)
+	{
+		if (sorted[i] == LUMPERROR || (i && sorted[i] == sorted[i-1]))
+			continue;
+
+		wad = WADFILENUM(sorted[i]);
+		lump = LUMPNUM(sorted[i]);
+		if (wad >= numwadfiles || !wadfiles[wad] || lump >= wadfiles[wad]->numlumps)
+			continue;
+
+		l = wadfiles[wad]->lumpinfo + lump;
+		switch (l->compression)
+		{
+#ifdef ZWAD
+		case CM_LZF:
+#endif
+#ifdef HAVE_ZLIB
+		case CM_DEFLATE:
+#endif
+			break;
+		default:
+			continue;
+		}
+
+		if (l->size > LUMPDECACHEMAXLUMP || total + l->size > LUMPDECACHESIZE
+			|| W_FindDecompressedLump(wad, lump))
+			continue;
+		total += l->size;
+
+		// the raw data is read here, the handles aren't shared with the threads
+		job = &prefetchjobs[numprefetchjobs++];
+		job->wad = wad;
+		job->lump = lump;
+		job->rawData = W_ReadRawLump(wad, lump, &job->freeraw);
+		job->decData = NULL;
+		job->err = 0;
+	}
+	free(sorted);
+
+#ifdef HAVE_THREADS
+	{
+		INT32 threads = I_GetCPUCount() - 1; // this thread works too
+		if (threads > MAXPREFETCHTHREADS - 1)
+			threads = MAXPREFETCHTHREADS - 1;
+		if ((size_t)threads >= numprefetchjobs)
+			threads = (INT32)numprefetchjobs - 1;
+
+		prefetchworkers = 0;
+		for (; threads > 0; threads--)
+		{
+			I_LockMutex(&prefetch_mutex);
+			if (I_SpawnThread("lump-prefetch", W_PrefetchThread, NULL))
+				prefetchworkers++;
+			I_UnlockMutex(prefetch_mutex);
+		}
+	}
+#endif
+
+	W_RunPrefetchJobs();
+
+#ifdef HAVE_THREADS
+	I_LockMutex(&prefetch_mutex);
+	while (prefetchworkers)
+		I_HoldCond(&prefetch_cond, prefetch_mutex);
+	I_UnlockMutex(prefetch_mutex);
+#endif
+
+	// keep what was decompressed; anything that failed is left to the
+	// normal read path, which reports the error
+	for (i = 0, job = prefetchjobs; i < numprefetchjobs; i++, job++)
+	{
+		if (job->freeraw)
+			free(job->rawData);
+		if (job->err || !job->decData
+			|| !W_StoreDecompressedLump(job->wad, job->lump, job->decData, wadfiles[job->wad]->lumpinfo[job->lump].size))
+			free(job->decData);
+	}
+
+	CONS_Debug(DBG_SETUP, "W_PrefetchLumps: decompressed %s lumps (%s bytes)\n", sizeu1(numprefetchjobs), sizeu2(total));
+
+	free(prefetchjobs);
+	prefetchjobs = NULL;
+	numprefetchjobs = nextprefetchjob = 0;
+}
+
 /** Reads bytes from the head of a lump.
-  * Note: If the lump is compressed, the whole thing has to be read anyway.
+  * Note: If the lump is compressed, the whole thing has to be decompressed anyway,
+  * but it's kept in the decompressed lump cache for the next read.
   *
   * \param wad Wad number to read from.
   * \param lump Lump number to read from.
@@ -1249,7 +1787,7 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 {
 	size_t lumpsize;
 	lumpinfo_t *l;
-	FILE *handle;
+	UINT8 *mapped;
 
 	if (!TestValidLump(wad,lump))
 		return 0;
@@ -1264,126 +1802,53 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 		size = lumpsize - offset;
 
 	// Let's get the raw lump data.
-	// We setup the desired file handle to read the lump data.
 	l = wadfiles[wad]->lumpinfo + lump;
-	handle = wadfiles[wad]->handle;
-	fseek(handle, (long)(l->position + offset), SEEK_SET);
 
 	// But let's not copy it yet. We support different compression formats on lumps, so we need to take that into account.
 	switch(wadfiles[wad]->lumpinfo[lump].compression)
 	{
 	case CM_NOCOMPRESSION:		// If it's uncompressed, we directly write the data into our destination, and return the bytes read.
-#ifdef NO_PNG_LUMPS
 		{
-			size_t bytesread = fread(dest, 1, size, handle);
-			ErrorIfPNG(dest, bytesread, wadfiles[wad]->filename, l->name2);
-			return bytesread;
-		}
-#else
-		return fread(dest, 1, size, handle);
-#endif
-	case CM_LZF:		// Is it LZF compressed? Used by ZWADs.
-		{
-#ifdef ZWAD
-			char *rawData; // The lump's raw data.
-			char *decData; // Lump's decompressed real data.
-			size_t retval; // Helper var, lzf_decompress returns 0 when an error occurs.
-
-			rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
-			decData = Z_Malloc(l->size, PU_STATIC, NULL);
-
-			if (fread(rawData, 1, l->disksize, handle) < l->disksize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
-			retval = lzf_decompress(rawData, l->disksize, decData, l->size);
-#ifndef AVOID_ERRNO
-			if (retval == 0) // If this was returned, check if errno was set
+			size_t bytesread;
+			if ((mapped = W_MappedLumpData(wadfiles[wad], l)) != NULL)
 			{
-				// errno is a global var set by the lzf functions when something goes wrong.
-				if (errno == E2BIG)
-					I_Error("wad %d, lump %d: compressed data too big (bigger than %s)", wad, lump, sizeu1(l->size));
-				else if (errno == EINVAL)
-					I_Error("wad %d, lump %d: invalid compressed data", wad, lump);
+				M_Memcpy(dest, mapped + offset, size);
+				bytesread = size;
 			}
-			// Otherwise, fall back on below error (if zero was actually the correct size then ???)
-#endif
-			if (retval != l->size)
+			else
 			{
-				I_Error("wad %d, lump %d: decompressed to wrong number of bytes (expected %s, got %s)", wad, lump, sizeu1(l->size), sizeu2(retval));
+				fseek(wadfiles[wad]->handle, (long)(l->position + offset), SEEK_SET);
+				bytesread = fread(dest, 1, size, wadfiles[wad]->handle);
 			}
-
-			if (!decData) // Did we get no data at all?
-				return 0;
-			M_Memcpy(dest, decData + offset, size);
-			Z_Free(rawData);
-			Z_Free(decData);
 #ifdef NO_PNG_LUMPS
-			ErrorIfPNG(dest, size, wadfiles[wad]->filename, l->name2);
-#endif
-			return size;
-#else
-			//I_Error("ZWAD files not supported on this platform.");
-			return 0;
+			ErrorIfPNG(dest, bytesread, wadfiles[wad]->filename, l->name2);
 #endif
-
+			return bytesread;
 		}
+#ifdef ZWAD
+	case CM_LZF:		// Is it LZF compressed? Used by ZWADs.
+#endif
 #ifdef HAVE_ZLIB
 	case CM_DEFLATE: // Is it compressed via DEFLATE? Very common in ZIPs/PK3s, also what most doom-related editors support.
+#endif
 		{
-			UINT8 *rawData; // The lump's raw data.
-			UINT8 *decData; // Lump's decompressed real data.
-
-			int zErr; // Helper var.
-			z_stream strm;
-			unsigned long rawSize = l->disksize;
-			unsigned long decSize = l->size;
-
-			rawData = Z_Malloc(rawSize, PU_STATIC, NULL);
-			decData = Z_Malloc(decSize, PU_STATIC, NULL);
-
-			if (fread(rawData, 1, rawSize, handle) < rawSize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
-
-			strm.zalloc = Z_NULL;
-			strm.zfree = Z_NULL;
-			strm.opaque = Z_NULL;
-
-			strm.total_in = strm.avail_in = rawSize;
-			strm.total_out = strm.avail_out = decSize;
-
-			strm.next_in = rawData;
-			strm.next_out = decData;
-
-			zErr = inflateInit2(&strm, -15);
-			if (zErr == Z_OK)
-			{
-				zErr = inflate(&strm, Z_FINISH);
-				if (zErr == Z_STREAM_END)
-				{
-					M_Memcpy(dest, decData, size);
-				}
-				else
-				{
-					size = 0;
-					zerr(zErr);
-				}
-
-				(void)inflateEnd(&strm);
-			}
-			else
-			{
-				CONS_Printf("whopet\n");
-				size = 0;
-				zerr(zErr);
-			}
-
-			Z_Free(rawData);
-			Z_Free(decData);
+			boolean cached;
+			UINT8 *decData = W_DecompressLump(wad, lump, &cached); // Lump's decompressed real data.
 
+			if (!decData) // Did we get no data at all?
+				return 0;
+			M_Memcpy(dest, decData + offset, size);
+			if (!cached)
+				free(decData);
 #ifdef NO_PNG_LUMPS
 			ErrorIfPNG(dest, size, wadfiles[wad]->filename, l->name2);
 #endif
 			return size;
 		}
+#ifndef ZWAD
+	case CM_LZF:
+		//I_Error("ZWAD files not supported on this platform.");
+		return 0;
 #endif
 	default:
 		I_Error("wad %d, lump %d: unsupported compression type!", wad, lump);
@@ -1463,6 +1928,56 @@ void *W_CacheLumpNumForce(lumpnum_t lumpnum, INT32 tag)
 	return ptr;
 }
 
+//
+// W_ViewLumpNum
+//
+// Returns the lump's data right from the mapped file when it's
+// stored uncompressed, so it doesn't have to be read and copied.
+// Anything else is loaded into the cache like W_CacheLumpNum does.
+// The data must not be written to.
+//
+void *W_ViewLumpNum(lumpnum_t lumpnum)
+{
+	UINT16 wad = WADFILENUM(lumpnum), lump = LUMPNUM(lumpnum);
+	lumpinfo_t *l;
+	UINT8 *mapped;
+
+	if (!TestValidLump(wad,lump))
+		return NULL;
+
+	l = wadfiles[wad]->lumpinfo + lump;
+	if (l->compression == CM_NOCOMPRESSION
+		&& (mapped = W_MappedLumpData(wadfiles[wad], l)) != NULL)
+	{
+#ifdef NO_PNG_LUMPS
+		ErrorIfPNG(mapped, l->size, wadfiles[wad]->filename, l->name2);
+#endif
+		return mapped;
+	}
+
+	return W_CacheLumpNum(lumpnum, PU_STATIC);
+}
+
+//
+// W_ReleaseLumpView
+//
+// Done with data from W_ViewLumpNum.
+//
+void W_ReleaseLumpView(lumpnum_t lumpnum, void *ptr)
+{
+	wadfile_t *wadfile;
+
+	if (!ptr)
+		return;
+
+	wadfile = wadfiles[WADFILENUM(lumpnum)];
+	if (wadfile && wadfile->mapping
+		&& (UINT8 *)ptr >= wadfile->mapping && (UINT8 *)ptr < wadfile->mapping + wadfile->filesize)
+		return; // points into the mapped file, nothing to free
+
+	Z_Free(ptr);
+}
+
 //
 // W_IsLumpCached
 //
@@ -107,7 +107,13 @@ typedef struct wadfile_s
 	aatree_t *hwrcache; // patches are cached in renderer's native format
 #endif
 	UINT16 numlumps; // this wad's number of resources
+	UINT16 lumphashmask; // number of lump hash chains, minus one
+	UINT16 *namehash; // first lump of each 8-char name hash chain
+	UINT16 *namenext; // next lump in the same 8-char name hash chain
+	UINT16 *fullnamehash; // first lump of each full name hash chain
+	UINT16 *fullnamenext; // next lump in the same full name hash chain
 	FILE *handle;
+	UINT8 *mapping; // the whole file mapped read-only into memory, or NULL
 	UINT32 filesize; // for network
 	UINT8 md5sum[16];
 	boolean important;
@@ -160,6 +166,8 @@ boolean W_IsLumpFolder(UINT16 wad, UINT16 lump); // for detecting folder "lumps"
 void zerr(int ret); // zlib error checking
 #endif
 
+void W_PrefetchLumps(const lumpnum_t *lumps, size_t count); // decompress lumps ahead of time
+
 size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset);
 size_t W_ReadLumpHeader(lumpnum_t lump, void *dest, size_t size, size_t offest); // read all or a part of a lump
 void W_ReadLumpPwad(UINT16 wad, UINT16 lump, void *dest);
@@ -169,6 +177,11 @@ void *W_CacheLumpNumPwad(UINT16 wad, UINT16 lump, INT32 tag);
 void *W_CacheLumpNum(lumpnum_t lump, INT32 tag);
 void *W_CacheLumpNumForce(lumpnum_t lumpnum, INT32 tag);
 
+// Read-only access to a whole lump, without a copy when the file is mapped
+// into memory. Hand the pointer back to W_ReleaseLumpView when done with it.
+void *W_ViewLumpNum(lumpnum_t lumpnum);
+void W_ReleaseLumpView(lumpnum_t lumpnum, void *ptr);
+
 boolean W_IsLumpCached(lumpnum_t lump, void *ptr);
 
 void *W_CacheLumpName(const char *name, INT32 tag);
@@ -259,6 +259,22 @@ tic_t I_GetTime(void)
 	return newtics;
 }
 
+// returns a profiling timestamp in microseconds
+UINT64 I_GetTimeMicros(void)
+{
+	static LARGE_INTEGER frequency = {{0, 0}};
+	LARGE_INTEGER currtime;
+
+	if (!frequency.QuadPart && !QueryPerformanceFrequency(&frequency))
+		frequency.QuadPart = -1;
+
+	if (frequency.QuadPart > 0 && QueryPerformanceCounter(&currtime))
+		return (UINT64)(currtime.QuadPart / frequency.QuadPart) * 1000000
+			+ (UINT64)(currtime.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+
+	return (UINT64)timeGetTime() * 1000;
+}
+
 void I_Sleep(void)
 {
 	if (cv_sleep.value != -1)
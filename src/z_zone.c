@@ -24,6 +24,13 @@
 ///        caught with this direct-malloc version. We also suspected that SRB2's
 ///        allocator was fragmenting badly. Finally, this version is a bit
 ///        simpler (about half the lines of code).
+///
+///        Small blocks, which is most of what the game allocates and frees
+///        while running (mobjs, sector nodes, thinkers), come out of slabs:
+///        pages holding chunks of one size class each, with the memblock_t
+///        living in the chunk too. That makes them one cheap allocation
+///        instead of two malloc() calls, and keeps them from fragmenting
+///        the heap.
 
 #include "doomdef.h"
 #include "doomstat.h"
@@ -45,11 +52,16 @@ static boolean Z_calloc = false;
 
 #define ZONEID 0xa441d13d
 
+#ifndef HAVE_VALGRIND
+#define ZSLABS // valgrind tracks each block as its own malloc()
+#endif
+
 #ifdef ZDEBUG
 //#define ZDEBUG2
 #endif
 
 struct memblock_s;
+struct slabpage_s;
 
 typedef struct
 {
@@ -73,6 +85,7 @@ typedef struct memblock_s
 
 	size_t size; // including the header and blocks
 	size_t realsize; // size of real data only
+	struct slabpage_s *slab; // slab page it's in, NULL if it was malloc'd
 
 #ifdef ZDEBUG
 	const char *ownerfile;
@@ -131,7 +144,172 @@ static memblock_t *Ptr2Memblock(void *ptr, const char* func)
 
 }
 
-static memblock_t head;
+// Blocks are kept in one list per tag, so freeing or measuring a range
+// of tags only looks at the blocks that have them. Tags past the last
+// list share it, as do tags below 1.
+#define NUMTAGLISTS 128
+#define TAGLIST(tag) ((tag) <= 0 ? 0 : (tag) >= NUMTAGLISTS-1 ? NUMTAGLISTS-1 : (tag))
+
+static memblock_t taglists[NUMTAGLISTS]; // heads of the lists
+static size_t tagbytes[NUMTAGLISTS]; // memory used by the blocks in each list
+
+static void Z_LinkBlock(memblock_t *block)
+{
+	memblock_t *head = &taglists[TAGLIST(block->tag)];
+
+	block->next = head->next;
+	block->prev = head;
+	head->next = block;
+	block->next->prev = block;
+	tagbytes[TAGLIST(block->tag)] += block->size + sizeof *block;
+}
+
+static void Z_UnlinkBlock(memblock_t *block)
+{
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
+	tagbytes[TAGLIST(block->tag)] -= block->size + sizeof *block;
+}
+
+static UINT32 zoneallocs = 0; // number of Z_Malloc calls so far, for profiling
+
+#ifdef ZSLABS
+#define SLABGRANULARITY 32 // size classes are this many bytes apart
+#define SLABMAXSIZE 1024 // bigger blocks are malloc'd on their own
+#define NUMSLABCLASSES (SLABMAXSIZE/SLABGRANULARITY)
+#define SLABPAGESIZE (32<<10)
+
+// A chunk is the memblock_t, then the memhdr_t, then the block's memory,
+// which starts 16-byte aligned at this offset.
+#define SLABDATAOFS ((sizeof (memblock_t) + sizeof (memhdr_t) + 15) & ~(size_t)15)
+
+typedef struct slabpage_s
+{
+	struct slabclass_s *sc;
+	struct slabpage_s *prev, *next; // pages of the class with free chunks
+	UINT8 *freechunk; // free chunks, each starting with a pointer to the next
+	UINT8 *unused; // chunks from here to the end were never handed out
+	UINT16 used; // chunks in use
+} slabpage_t;
+
+#define SLABPAGEHDR ((sizeof (slabpage_t) + 15) & ~(size_t)15)
+
+typedef struct slabclass_s
+{
+	size_t chunksize;
+	UINT16 perpage; // chunks in one page
+	slabpage_t *partial; // pages with free chunks
+	size_t pages; // pages allocated
+	size_t used, peak; // chunks in use now and at most
+} slabclass_t;
+
+static slabclass_t slabclasses[NUMSLABCLASSES];
+
+static void Z_InitSlabs(void)
+{
+	size_t i;
+
+	memset(slabclasses, 0x00, sizeof (slabclasses));
+	for (i = 0; i < NUMSLABCLASSES; i++)
+	{
+		slabclasses[i].chunksize = SLABDATAOFS + (i+1)*SLABGRANULARITY;
+		slabclasses[i].perpage = (UINT16)((SLABPAGESIZE - SLABPAGEHDR) / slabclasses[i].chunksize);
+	}
+}
+
+static void *xm(size_t size);
+
+// Takes a chunk big enough for size bytes out of its class's slabs.
+static memblock_t *Z_SlabAlloc(size_t size)
+{
+	slabclass_t *sc = &slabclasses[size ? (size-1)/SLABGRANULARITY : 0];
+	slabpage_t *page = sc->partial;
+	UINT8 *chunk;
+
+	if (!page) // every page is full, start a new one
+	{
+		page = xm(SLABPAGESIZE);
+
+		// xm may have purged blocks of this class to find the memory,
+		// which puts their pages back on the list, so use those instead
+		if (sc->partial)
+		{
+			free(page);
+			page = sc->partial;
+		}
+		else
+		{
+			page->sc = sc;
+			page->prev = page->next = NULL;
+			page->freechunk = NULL;
+			page->unused = (UINT8 *)page + SLABPAGEHDR;
+			page->used = 0;
+			sc->partial = page;
+			sc->pages++;
+		}
+	}
+
+	if (page->freechunk)
+	{
+		chunk = page->freechunk;
+		page->freechunk = *(UINT8 **)chunk;
+	}
+	else
+	{
+		chunk = page->unused;
+		page->unused += sc->chunksize;
+	}
+
+	if (++page->used == sc->perpage) // full now, take it off the list
+	{
+		sc->partial = page->next;
+		if (page->next)
+			page->next->prev = NULL;
+		page->next = NULL;
+	}
+
+	if (++sc->used > sc->peak)
+		sc->peak = sc->used;
+
+	((memblock_t *)chunk)->slab = page;
+	return (memblock_t *)chunk;
+}
+
+// Gives a chunk back to its page. Pages left empty are freed,
+// except for the last one of the class with free chunks.
+static void Z_SlabFree(memblock_t *block)
+{
+	slabpage_t *page = block->slab;
+	slabclass_t *sc = page->sc;
+	UINT8 *chunk = (UINT8 *)block;
+
+	if (page->used == sc->perpage) // was full, it has room again
+	{
+		page->prev = NULL;
+		page->next = sc->partial;
+		if (sc->partial)
+			sc->partial->prev = page;
+		sc->partial = page;
+	}
+
+	*(UINT8 **)chunk = page->freechunk;
+	page->freechunk = chunk;
+	page->used--;
+	sc->used--;
+
+	if (!page->used && (page->prev || page->next))
+	{
+		if (page->prev)
+			page->prev->next = page->next;
+		else
+			sc->partial = page->next;
+		if (page->next)
+			page->next->prev = page->prev;
+		free(page);
+		sc->pages--;
+	}
+}
+#endif
 
 static void Command_Memfree_f(void);
 #ifdef ZDEBUG
@@ -141,10 +319,17 @@ static void Command_Memdump_f(void);
 void Z_Init(void)
 {
 	UINT32 total, memfree;
+	INT32 i;
+
+	memset(taglists, 0x00, sizeof(taglists));
+	memset(tagbytes, 0x00, sizeof(tagbytes));
 
-	memset(&head, 0x00, sizeof(head));
+	for (i = 0; i < NUMTAGLISTS; i++)
+		taglists[i].next = taglists[i].prev = &taglists[i];
 
-	head.next = head.prev = &head;
+#ifdef ZSLABS
+	Z_InitSlabs();
+#endif
 
 	memfree = I_GetFreeMem(&total)>>20;
 	CONS_Printf("System memory: %uMB - Free: %uMB\n", total>>20, memfree);
@@ -197,9 +382,15 @@ void Z_Free(void *ptr)
 		*block->user = NULL;
 
 	// Free the memory and get rid of the block.
+	Z_UnlinkBlock(block);
+#ifdef ZSLABS
+	if (block->slab)
+	{
+		Z_SlabFree(block);
+		return;
+	}
+#endif
 	free(block->real);
-	block->prev->next = block->next;
-	block->next->prev = block->prev;
 	free(block);
 #ifdef VALGRIND_DESTROY_MEMPOOL
 	VALGRIND_DESTROY_MEMPOOL(block);
@@ -254,16 +445,31 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	CONS_Debug(DBG_MEMORY, "Z_Malloc %s:%d\n", file, line);
 #endif
 
-	block = xm(sizeof *block);
+	zoneallocs++;
+#ifdef ZSLABS
+	// slab memory is 16-byte aligned already
+	if (size <= SLABMAXSIZE && alignbits <= 4)
+	{
+		block = Z_SlabAlloc(size);
+		ptr = NULL;
+		given = (UINT8 *)block + SLABDATAOFS;
+		blocksize = block->slab->sc->chunksize - sizeof *block;
+	}
+	else
+#endif
+	{
+		block = xm(sizeof *block);
+		block->slab = NULL;
 #ifdef HAVE_VALGRIND
-	padsize += (1<<sizeof(size_t))*2;
+		padsize += (1<<sizeof(size_t))*2;
 #endif
-	ptr = xm(blocksize + padsize*2);
+		ptr = xm(blocksize + padsize*2);
 
-	// This horrible calculation makes sure that "given" is aligned
-	// properly.
-	given = (void *)((size_t)((UINT8 *)ptr + extrabytes + sizeof *hdr + padsize/2)
-		& ~extrabytes);
+		// This horrible calculation makes sure that "given" is aligned
+		// properly.
+		given = (void *)((size_t)((UINT8 *)ptr + extrabytes + sizeof *hdr + padsize/2)
+			& ~extrabytes);
+	}
 
 	// The mem header lives 'sizeof (memhdr_t)' bytes before given.
 	hdr = (memhdr_t *)((UINT8 *)given - sizeof *hdr);
@@ -276,11 +482,6 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	VALGRIND_MEMPOOL_ALLOC(block, hdr, size + sizeof *hdr);
 #endif
 
-	block->next = head.next;
-	block->prev = &head;
-	head.next = block;
-	block->next->prev = block;
-
 	block->real = ptr;
 	block->hdr = hdr;
 	block->tag = tag;
@@ -291,6 +492,7 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 #endif
 	block->size = blocksize;
 	block->realsize = size;
+	Z_LinkBlock(block);
 
 	hdr->id = ZONEID;
 	hdr->block = block;
@@ -400,14 +602,20 @@ void *Z_ReallocAlign(void *ptr, size_t size,INT32 tag, void *user,  INT32 alignb
 void Z_FreeTags(INT32 lowtag, INT32 hightag)
 {
 	memblock_t *block, *next;
+	INT32 i;
 
+#ifdef PARANOIA
 	Z_CheckHeap(420);
-	for (block = head.next; block != &head; block = next)
+#endif
+	for (i = TAGLIST(lowtag); i <= TAGLIST(hightag); i++)
 	{
-		next = block->next; // get link before freeing
+		for (block = taglists[i].next; block != &taglists[i]; block = next)
+		{
+			next = block->next; // get link before freeing
 
-		if (block->tag >= lowtag && block->tag <= hightag)
-			Z_Free((UINT8 *)block->hdr + sizeof *block->hdr);
+			if (block->tag >= lowtag && block->tag <= hightag)
+				Z_Free((UINT8 *)block->hdr + sizeof *block->hdr);
+		}
 	}
 }
 
@@ -448,8 +656,10 @@ void Z_CheckHeap(INT32 i)
 	memhdr_t *hdr;
 	UINT32 blocknumon = 0;
 	void *given;
+	INT32 list;
 
-	for (block = head.next; block != &head; block = block->next)
+	for (list = 0; list < NUMTAGLISTS; list++)
+	for (block = taglists[list].next; block != &taglists[list]; block = block->next)
 	{
 		blocknumon++;
 		hdr = block->hdr;
@@ -481,6 +691,18 @@ void Z_CheckHeap(INT32 i)
 				" doesn't have a proper user", i, blocknumon
 #ifdef ZDEBUG
 				, block->ownerfile, block->ownerline
+#endif
+			       );
+		}
+		if (TAGLIST(block->tag) != list)
+		{
+			I_Error("Z_CheckHeap %d: block %u"
+#ifdef ZDEBUG
+				"(owned by %s:%d)"
+#endif
+				" is in the wrong tag list", i, blocknumon
+#ifdef ZDEBUG
+				, block->ownerfile, block->ownerline
 #endif
 			       );
 		}
@@ -584,7 +806,14 @@ void Z_ChangeTag2(void *ptr, INT32 tag)
 		I_Error("Internal memory management error: "
 			"tried to make block purgable but it has no owner");
 
-	block->tag = tag;
+	if (TAGLIST(tag) != TAGLIST(block->tag))
+	{
+		Z_UnlinkBlock(block);
+		block->tag = tag;
+		Z_LinkBlock(block);
+	}
+	else
+		block->tag = tag;
 }
 
 /** Calculates memory usage for a given set of tags.
@@ -598,12 +827,24 @@ size_t Z_TagsUsage(INT32 lowtag, INT32 hightag)
 {
 	size_t cnt = 0;
 	memblock_t *rover;
+	INT32 i;
 
-	for (rover = head.next; rover != &head; rover = rover->next)
+	for (i = TAGLIST(lowtag); i <= TAGLIST(hightag); i++)
 	{
-		if (rover->tag < lowtag || rover->tag > hightag)
+		// lists of a single tag keep a running total,
+		// the shared ones at either end need a look
+		if (i > 0 && i < NUMTAGLISTS-1)
+		{
+			cnt += tagbytes[i];
 			continue;
-		cnt += rover->size + sizeof *rover;
+		}
+
+		for (rover = taglists[i].next; rover != &taglists[i]; rover = rover->next)
+		{
+			if (rover->tag < lowtag || rover->tag > hightag)
+				continue;
+			cnt += rover->size + sizeof *rover;
+		}
 	}
 
 	return cnt;
@@ -614,11 +855,22 @@ size_t Z_TagUsage(INT32 tagnum)
 	return Z_TagsUsage(tagnum, tagnum);
 }
 
+/** Returns how many blocks have been allocated since startup.
+  * Only the difference between two calls is meaningful; used by the
+  * simulation benchmark to count allocations per tic.
+  */
+UINT32 Z_GetAllocCount(void)
+{
+	return zoneallocs;
+}
+
 void Command_Memfree_f(void)
 {
 	UINT32 freebytes, totalbytes;
 
+#ifdef PARANOIA
 	Z_CheckHeap(-1);
+#endif
 	CONS_Printf("\x82%s", M_GetText("Memory Info\n"));
 	CONS_Printf(M_GetText("Total heap used   : %7s KB\n"), sizeu1(Z_TagsUsage(0, INT32_MAX)>>10));
 	CONS_Printf(M_GetText("Static            : %7s KB\n"), sizeu1(Z_TagUsage(PU_STATIC)>>10));
@@ -641,6 +893,22 @@ void Command_Memfree_f(void)
 	}
 #endif
 
+#ifdef ZSLABS
+	CONS_Printf("\x82%s", M_GetText("Slab Memory Info\n"));
+	{
+		size_t i;
+		slabclass_t *sc;
+		for (i = 0, sc = slabclasses; i < NUMSLABCLASSES; i++, sc++)
+		{
+			if (!sc->pages && !sc->peak)
+				continue;
+			CONS_Printf(M_GetText("%4s bytes: %6s used, %6s peak, %7s KB\n"),
+				sizeu1((i+1)*SLABGRANULARITY), sizeu2(sc->used), sizeu3(sc->peak),
+				sizeu4((sc->pages*SLABPAGESIZE)>>10));
+		}
+	}
+#endif
+
 	CONS_Printf("\x82%s", M_GetText("System Memory Info\n"));
 	freebytes = I_GetFreeMem(&totalbytes);
 	CONS_Printf(M_GetText("    Total physical memory: %7u KB\n"), totalbytes>>10);
@@ -660,7 +928,8 @@ static void Command_Memdump_f(void)
 	if ((i = COM_CheckParm("-max")))
 		maxtag = atoi(COM_Argv(i + 1));
 
-	for (block = head.next; block != &head; block = block->next)
+	for (i = TAGLIST(mintag); i <= TAGLIST(maxtag); i++)
+	for (block = taglists[i].next; block != &taglists[i]; block = block->next)
 		if (block->tag >= mintag && block->tag <= maxtag)
 		{
 			char *filename = strrchr(block->ownerfile, PATHSEP[0]);
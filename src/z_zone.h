@@ -98,6 +98,7 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 
 size_t Z_TagUsage(INT32 tagnum);
 size_t Z_TagsUsage(INT32 lowtag, INT32 hightag);
+UINT32 Z_GetAllocCount(void);
 
 char *Z_StrDup(const char *in);
 